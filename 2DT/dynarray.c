@@ -4,6 +4,7 @@
 /*--------------------------------------------------------------------*/
 
 #include "dynarray.h"
+#include "dynarraydef.h"
 #include <assert.h>
 #include <stdlib.h>
 
@@ -13,6 +14,20 @@
 
 static const size_t MIN_PHYS_LENGTH = 2;
 
+/* The factor by which the physical length of a DynArray object grows
+   when it is full. */
+
+static const size_t GROWTH_FACTOR = 2;
+
+/*--------------------------------------------------------------------*/
+
+/* The total logical and physical lengths of all DynArray objects that
+   have not been freed, kept up to date as they change so that
+   DynArray_getTotals need not visit them. */
+
+static size_t uTotalLength;
+static size_t uTotalPhysLength;
+
 /*--------------------------------------------------------------------*/
 
 /* A DynArray consists of an array, along with its logical and
@@ -30,6 +45,21 @@ struct DynArray
 
    /* The array that underlies the DynArray. */
    const void **ppvArray;
+
+   /* A copy of the elements laid out by DynArray_freeze in Eytzinger
+      order, from index 1, or NULL. */
+   const void **ppvFrozen;
+
+   /* The index in ppvArray of each element of ppvFrozen, at the same
+      index as it, or NULL. */
+   size_t *puRanks;
+
+   /* The number of elements that ppvFrozen and puRanks have room
+      for. */
+   size_t uFrozenPhysLength;
+
+   /* 1 (TRUE) iff ppvFrozen holds the elements as they now are. */
+   int iIsFrozen;
 };
 
 /*--------------------------------------------------------------------*/
@@ -44,6 +74,8 @@ static int DynArray_isValid(DynArray_T oDynArray)
    if (oDynArray->uPhysLength < MIN_PHYS_LENGTH) return 0;
    if (oDynArray->uLength > oDynArray->uPhysLength) return 0;
    if (oDynArray->ppvArray == NULL) return 0;
+   if (oDynArray->iIsFrozen &&
+       oDynArray->uFrozenPhysLength <= oDynArray->uLength) return 0;
    return 1;
 }
 
@@ -51,25 +83,26 @@ static int DynArray_isValid(DynArray_T oDynArray)
 
 /*--------------------------------------------------------------------*/
 
-/* Increase the physical length of oDynArray.  Return 1 (TRUE) if
-   successful and 0 (FALSE) if insufficient memory is available. */
+/* Change the physical length of oDynArray to uNewLength, which must
+   be at least its length and MIN_PHYS_LENGTH.  Return 1 (TRUE) if
+   successful and 0 (FALSE), leaving oDynArray unchanged, if
+   insufficient memory is available. */
 
-static int DynArray_grow(DynArray_T oDynArray)
+static int DynArray_resize(DynArray_T oDynArray, size_t uNewLength)
 {
-   const size_t GROWTH_FACTOR = 2;
-
-   size_t uNewLength;
    const void **ppvNewArray;
 
    assert(oDynArray != NULL);
-
-   uNewLength = GROWTH_FACTOR * oDynArray->uPhysLength;
+   assert(uNewLength >= oDynArray->uLength);
+   assert(uNewLength >= MIN_PHYS_LENGTH);
 
    ppvNewArray = (const void**)
       realloc(oDynArray->ppvArray, sizeof(void*) * uNewLength);
    if (ppvNewArray == NULL)
       return 0;
 
+   uTotalPhysLength -= oDynArray->uPhysLength;
+   uTotalPhysLength += uNewLength;
    oDynArray->uPhysLength = uNewLength;
    oDynArray->ppvArray = ppvNewArray;
    return 1;
@@ -77,6 +110,92 @@ static int DynArray_grow(DynArray_T oDynArray)
 
 /*--------------------------------------------------------------------*/
 
+/* Increase the physical length of oDynArray.  Return 1 (TRUE) if
+   successful and 0 (FALSE) if insufficient memory is available. */
+
+static int DynArray_grow(DynArray_T oDynArray)
+{
+   assert(oDynArray != NULL);
+
+   return DynArray_resize(oDynArray,
+                          GROWTH_FACTOR * oDynArray->uPhysLength);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Decrease the physical length of oDynArray if its length has fallen
+   to a quarter of it.  Halving the physical length then leaves the
+   array half full, so that it must be added to until full, or removed
+   from until a quarter full again, before it is next resized, and
+   alternating additions and removals never resize it each time. */
+
+static void DynArray_shrink(DynArray_T oDynArray)
+{
+   const size_t SHRINK_FACTOR = 2;
+   const size_t SHRINK_LOAD = 4;
+
+   size_t uNewLength;
+
+   assert(oDynArray != NULL);
+
+   if (oDynArray->uLength * SHRINK_LOAD > oDynArray->uPhysLength)
+      return;
+   uNewLength = oDynArray->uPhysLength / SHRINK_FACTOR;
+   if (uNewLength < MIN_PHYS_LENGTH)
+      uNewLength = MIN_PHYS_LENGTH;
+   if (uNewLength == oDynArray->uPhysLength)
+      return;
+
+   /* Should realloc fail to provide the smaller array, the array
+      simply stays as it is. */
+   (void)DynArray_resize(oDynArray, uNewLength);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the room taken by a frozen layout with room for
+   uFrozenPhysLength elements, as the number of elements that would
+   take as much room in the underlying array, so that uTotalPhysLength
+   can count it. */
+
+static size_t DynArray_frozenRoom(size_t uFrozenPhysLength)
+{
+   return uFrozenPhysLength +
+      (uFrozenPhysLength * sizeof(size_t) + sizeof(void*) - 1) /
+      sizeof(void*);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Mark the frozen layout of oDynArray, if any, as out of date, about
+   to be changed.  Its memory is kept for the next DynArray_freeze. */
+
+static void DynArray_thaw(DynArray_T oDynArray)
+{
+   assert(oDynArray != NULL);
+
+   oDynArray->iIsFrozen = 0;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Free the frozen layout of oDynArray, if any. */
+
+static void DynArray_freeFrozen(DynArray_T oDynArray)
+{
+   assert(oDynArray != NULL);
+
+   uTotalPhysLength -= DynArray_frozenRoom(oDynArray->uFrozenPhysLength);
+   free(oDynArray->ppvFrozen);
+   free(oDynArray->puRanks);
+   oDynArray->ppvFrozen = NULL;
+   oDynArray->puRanks = NULL;
+   oDynArray->uFrozenPhysLength = 0;
+   oDynArray->iIsFrozen = 0;
+}
+
+/*--------------------------------------------------------------------*/
+
 DynArray_T DynArray_new(size_t uLength)
 {
    DynArray_T oDynArray;
@@ -91,6 +210,11 @@ DynArray_T DynArray_new(size_t uLength)
    else
       oDynArray->uPhysLength = MIN_PHYS_LENGTH;
 
+   oDynArray->ppvFrozen = NULL;
+   oDynArray->puRanks = NULL;
+   oDynArray->uFrozenPhysLength = 0;
+   oDynArray->iIsFrozen = 0;
+
    oDynArray->ppvArray =
       (const void**)calloc(oDynArray->uPhysLength, sizeof(void*));
    if (oDynArray->ppvArray == NULL)
@@ -99,6 +223,8 @@ DynArray_T DynArray_new(size_t uLength)
       return NULL;
    }
 
+   uTotalLength += oDynArray->uLength;
+   uTotalPhysLength += oDynArray->uPhysLength;
    return oDynArray;
 }
 
@@ -109,6 +235,9 @@ void DynArray_free(DynArray_T oDynArray)
    assert(oDynArray != NULL);
    assert(DynArray_isValid(oDynArray));
 
+   DynArray_freeFrozen(oDynArray);
+   uTotalLength -= oDynArray->uLength;
+   uTotalPhysLength -= oDynArray->uPhysLength;
    free(oDynArray->ppvArray);
    free(oDynArray);
 }
@@ -145,6 +274,7 @@ void *DynArray_set(DynArray_T oDynArray, size_t uIndex,
    assert(uIndex < oDynArray->uLength);
    assert(DynArray_isValid(oDynArray));
 
+   DynArray_thaw(oDynArray);
    pvOldElement = oDynArray->ppvArray[uIndex];
    oDynArray->ppvArray[uIndex] = pvElement;
 
@@ -164,8 +294,10 @@ int DynArray_add(DynArray_T oDynArray, const void *pvElement)
       if (! DynArray_grow(oDynArray))
          return 0;
 
+   DynArray_thaw(oDynArray);
    oDynArray->ppvArray[oDynArray->uLength] = pvElement;
    oDynArray->uLength++;
+   uTotalLength++;
 
    assert(DynArray_isValid(oDynArray));
 
@@ -187,11 +319,48 @@ int DynArray_addAt(DynArray_T oDynArray, size_t uIndex,
       if (! DynArray_grow(oDynArray))
          return 0;
 
+   DynArray_thaw(oDynArray);
    for (u = oDynArray->uLength; u > uIndex; u--)
       oDynArray->ppvArray[u] = oDynArray->ppvArray[u-1];
 
    oDynArray->ppvArray[uIndex] = pvElement;
    oDynArray->uLength++;
+   uTotalLength++;
+
+   assert(DynArray_isValid(oDynArray));
+
+   return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+int DynArray_addMany(DynArray_T oDynArray, const void **ppvElements,
+                     size_t uCount)
+{
+   size_t uNewLength;
+   size_t u;
+
+   assert(oDynArray != NULL);
+   assert(ppvElements != NULL || uCount == 0);
+   assert(DynArray_isValid(oDynArray));
+
+   /* Growing by as many factors as needed at once, so that the array
+      is reallocated at most once, and adding one element at a time
+      would have left it as large. */
+   if (uCount > oDynArray->uPhysLength - oDynArray->uLength)
+   {
+      uNewLength = oDynArray->uPhysLength;
+      while (uNewLength - oDynArray->uLength < uCount)
+         uNewLength *= GROWTH_FACTOR;
+      if (! DynArray_resize(oDynArray, uNewLength))
+         return 0;
+   }
+
+   DynArray_thaw(oDynArray);
+   for (u = 0; u < uCount; u++)
+      oDynArray->ppvArray[oDynArray->uLength + u] = ppvElements[u];
+   oDynArray->uLength += uCount;
+   uTotalLength += uCount;
 
    assert(DynArray_isValid(oDynArray));
 
@@ -209,13 +378,17 @@ void *DynArray_removeAt(DynArray_T oDynArray, size_t uIndex)
    assert(uIndex < oDynArray->uLength);
    assert(DynArray_isValid(oDynArray));
 
+   DynArray_thaw(oDynArray);
    pvOldElement = oDynArray->ppvArray[uIndex];
 
    oDynArray->uLength--;
+   uTotalLength--;
 
    for (u = uIndex; u < oDynArray->uLength; u++)
       oDynArray->ppvArray[u] = oDynArray->ppvArray[u+1];
 
+   DynArray_shrink(oDynArray);
+
    assert(DynArray_isValid(oDynArray));
 
    return (void*)pvOldElement;
@@ -223,6 +396,39 @@ void *DynArray_removeAt(DynArray_T oDynArray, size_t uIndex)
 
 /*--------------------------------------------------------------------*/
 
+int DynArray_reserve(DynArray_T oDynArray, size_t uPhysLength)
+{
+   assert(oDynArray != NULL);
+   assert(DynArray_isValid(oDynArray));
+
+   if (uPhysLength <= oDynArray->uPhysLength)
+      return 1;
+   return DynArray_resize(oDynArray, uPhysLength);
+}
+
+/*--------------------------------------------------------------------*/
+
+void DynArray_shrinkToFit(DynArray_T oDynArray)
+{
+   size_t uNewLength;
+
+   assert(oDynArray != NULL);
+   assert(DynArray_isValid(oDynArray));
+
+   if (! oDynArray->iIsFrozen)
+      DynArray_freeFrozen(oDynArray);
+
+   uNewLength = oDynArray->uLength;
+   if (uNewLength < MIN_PHYS_LENGTH)
+      uNewLength = MIN_PHYS_LENGTH;
+   if (uNewLength < oDynArray->uPhysLength)
+      (void)DynArray_resize(oDynArray, uNewLength);
+
+   assert(DynArray_isValid(oDynArray));
+}
+
+/*--------------------------------------------------------------------*/
+
 void DynArray_toArray(DynArray_T oDynArray, void **ppvArray)
 {
    size_t u;
@@ -237,6 +443,93 @@ void DynArray_toArray(DynArray_T oDynArray, void **ppvArray)
 
 /*--------------------------------------------------------------------*/
 
+const void **DynArray_getArray(DynArray_T oDynArray)
+{
+   assert(oDynArray != NULL);
+   assert(DynArray_isValid(oDynArray));
+
+   /* The caller may rearrange the elements. */
+   DynArray_thaw(oDynArray);
+   return oDynArray->ppvArray;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Copy the elements of oDynArray from index uNext onward into its
+   frozen layout, in sorted order, at the subtree of the Eytzinger
+   layout whose root is at index k.  Return the index of the first
+   element not copied. */
+
+static size_t DynArray_layOut(DynArray_T oDynArray, size_t uNext,
+                              size_t k)
+{
+   assert(oDynArray != NULL);
+
+   if (k > oDynArray->uLength)
+      return uNext;
+   uNext = DynArray_layOut(oDynArray, uNext, 2 * k);
+   oDynArray->ppvFrozen[k] = oDynArray->ppvArray[uNext];
+   oDynArray->puRanks[k] = uNext;
+   return DynArray_layOut(oDynArray, uNext + 1, 2 * k + 1);
+}
+
+/*--------------------------------------------------------------------*/
+
+int DynArray_freeze(DynArray_T oDynArray)
+{
+   const void **ppvNewFrozen;
+   size_t *puNewRanks;
+   size_t uNewLength;
+
+   assert(oDynArray != NULL);
+   assert(DynArray_isValid(oDynArray));
+
+   if (oDynArray->iIsFrozen)
+      return 1;
+
+   /* The layout starts at index 1, leaving index 0 unused. */
+   uNewLength = oDynArray->uLength + 1;
+   if (oDynArray->uFrozenPhysLength < uNewLength)
+   {
+      ppvNewFrozen = (const void**)malloc(sizeof(void*) * uNewLength);
+      puNewRanks = (size_t*)malloc(sizeof(size_t) * uNewLength);
+      if (ppvNewFrozen == NULL || puNewRanks == NULL)
+      {
+         free(ppvNewFrozen);
+         free(puNewRanks);
+         return 0;
+      }
+      DynArray_freeFrozen(oDynArray);
+      oDynArray->ppvFrozen = ppvNewFrozen;
+      oDynArray->puRanks = puNewRanks;
+      oDynArray->uFrozenPhysLength = uNewLength;
+      uTotalPhysLength += DynArray_frozenRoom(uNewLength);
+   }
+
+   (void)DynArray_layOut(oDynArray, 0, 1);
+   oDynArray->iIsFrozen = 1;
+
+   assert(DynArray_isValid(oDynArray));
+   return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+const void **DynArray_getFrozen(DynArray_T oDynArray,
+                                const size_t **ppuRanks)
+{
+   assert(oDynArray != NULL);
+   assert(ppuRanks != NULL);
+   assert(DynArray_isValid(oDynArray));
+
+   if (! oDynArray->iIsFrozen)
+      return NULL;
+   *ppuRanks = oDynArray->puRanks;
+   return oDynArray->ppvFrozen;
+}
+
+/*--------------------------------------------------------------------*/
+
 void DynArray_map(DynArray_T oDynArray,
                   void (*pfApply)(void *pvElement, void *pvExtra),
                   const void *pvExtra)
@@ -253,61 +546,32 @@ void DynArray_map(DynArray_T oDynArray,
 
 /*--------------------------------------------------------------------*/
 
-/* Sort the array of elements that resides in memory at
-   addresses ppvLo...ppvHi in ascending order, as determined
-   by *pfCompare.
-   *pfCompare must return <0, 0, or >0 depending upon whether
-   *pvElement1 is less than, equal to, or greater than *pvElement2,
-   respectively. */
-
-static void DynArray_qsort(
-   const void **ppvLo,
-   const void **ppvHi,
-   int (*pfCompare) (const void *pvElement1, const void *pvElement2))
-{
-   /* This function implements a variation of the quicksort algorithm
-      shown in the book "Algorithms + Data Structures = Programs" by
-      Niklaus Wirth. */
+/* A function that compares elements, as taken by DynArray_sort and
+   DynArray_bsearch. */
 
-   /* This function uses pointers instead of indices to avoid
-      complications with using unsigned integers as array indices. */
+typedef int (*DynArray_Compare)(const void *pvElement1,
+                                const void *pvElement2);
 
-   const void **ppvRight;
-   const void **ppvLeft;
-   const void *pvPivot;
-   const void *pvTemp;
+/* Return (*pfCompare)(pvElement1, pvElement2), the comparison through
+   which the algorithms of dynarraydef.h call pfCompare. */
 
-   assert(ppvLo != NULL);
-   assert(ppvHi != NULL);
+static int DynArray_callCompare(DynArray_Compare pfCompare,
+                                const void *pvElement1,
+                                const void *pvElement2)
+{
    assert(pfCompare != NULL);
 
-   ppvRight = ppvLo;
-   ppvLeft = ppvHi;
-   pvPivot = *(ppvLo + ((ppvHi - ppvLo) / 2));
+   return (*pfCompare)(pvElement1, pvElement2);
+}
 
-   while (ppvRight <= ppvLeft)
-   {
-      while ((*pfCompare)(*ppvRight, pvPivot) < 0)
-         ppvRight++;
-      while ((*pfCompare)(pvPivot, *ppvLeft) < 0)
-         ppvLeft--;
-      if (ppvRight <= ppvLeft)
-      {
-         /* Swap *ppvRight and *ppvLeft. */
-         pvTemp = *ppvRight;
-         *ppvRight = *ppvLeft;
-         *ppvLeft = pvTemp;
+/*--------------------------------------------------------------------*/
 
-         ppvRight++;
-         ppvLeft--;
-      }
-   }
+/* DynArray_sortHelp(ppvArray, uLength, pfCompare) sorts the uLength
+   elements at ppvArray in ascending order, as determined by
+   *pfCompare. */
 
-   if (ppvLo < ppvLeft)
-      DynArray_qsort(ppvLo, ppvLeft, pfCompare);
-   if (ppvRight < ppvHi)
-      DynArray_qsort(ppvRight, ppvHi, pfCompare);
-}
+DYNARRAY_DEFINE_SORT(DynArray_sortHelp, DynArray_Compare,
+                     DynArray_callCompare)
 
 /*--------------------------------------------------------------------*/
 
@@ -319,15 +583,46 @@ void DynArray_sort(DynArray_T oDynArray,
    assert(pfCompare != NULL);
    assert(DynArray_isValid(oDynArray));
 
-   if (oDynArray->uLength < 2)
-      return;
+   DynArray_thaw(oDynArray);
+   DynArray_sortHelp(oDynArray->ppvArray, oDynArray->uLength,
+                     pfCompare);
+
+   assert(DynArray_isValid(oDynArray));
+}
+
+/*--------------------------------------------------------------------*/
+
+/* DynArray_mergeHelp(ppvArray, uLength, ppvBatch, uCount, pfCompare)
+   merges the uCount elements at ppvBatch into the uLength elements at
+   ppvArray, both sorted as determined by *pfCompare. */
+
+DYNARRAY_DEFINE_MERGE(DynArray_mergeHelp, DynArray_Compare,
+                      DynArray_callCompare)
 
-   DynArray_qsort(
-      &oDynArray->ppvArray[0],
-      &oDynArray->ppvArray[oDynArray->uLength-1],
-      pfCompare);
+/*--------------------------------------------------------------------*/
+
+int DynArray_addManySorted(DynArray_T oDynArray,
+                           const void **ppvElements,
+                           size_t uCount,
+                           int (*pfCompare)(const void *pvElement1,
+                                            const void *pvElement2))
+{
+   size_t uLength;
 
+   assert(oDynArray != NULL);
+   assert(ppvElements != NULL || uCount == 0);
+   assert(pfCompare != NULL);
    assert(DynArray_isValid(oDynArray));
+
+   uLength = oDynArray->uLength;
+   if (! DynArray_addMany(oDynArray, ppvElements, uCount))
+      return 0;
+   DynArray_mergeHelp(oDynArray->ppvArray, uLength, ppvElements,
+                      uCount, pfCompare);
+
+   assert(DynArray_isValid(oDynArray));
+
+   return 1;
 }
 
 /*--------------------------------------------------------------------*/
@@ -358,43 +653,14 @@ int DynArray_search(DynArray_T oDynArray,
 
 /*--------------------------------------------------------------------*/
 
-/* Binary search the array of elements that resides in memory at
-   addresses ppvLo...ppvHi for pvSoughtElement.
-   *pfCompare must return <0, 0, or >0 depending upon whether
-   *pvElement1 is less than, equal to, or greater than *pvElement2,
-   respectively. */
+/* DynArray_bsearchHelp(ppvArray, uLength, pvKey, puIndex, pfCompare)
+   binary searches the uLength elements at ppvArray for one matching
+   pvKey, as determined by *pfCompare, and
+   DynArray_bsearchHelp_frozen(ppvFrozen, puRanks, uLength, pvKey,
+   puIndex, pfCompare) does so in a layout made by DynArray_freeze. */
 
-static const void **DynArray_bsearchHelp(
-   void *pvSoughtElement,
-   const void **ppvLo,
-   const void **ppvHi,
-   int (*pfCompare)(const void *pvElement1, const void *pvElement2),
-   const void*** pppvInsert)
-{
-   /* This function uses pointers instead of indices to avoid
-      complications with using unsigned integers as array indices. */
-
-   const void **ppvMid;
-   int iCompare;
-
-   assert(ppvLo != NULL);
-   assert(ppvHi != NULL);
-   assert(pfCompare != NULL);
-
-   while (ppvLo <= ppvHi)
-   {
-      ppvMid = ppvLo + ((ppvHi - ppvLo) / 2);
-      iCompare = (*pfCompare)(pvSoughtElement, *ppvMid);
-      if (iCompare < 0)
-         ppvHi = ppvMid - 1;
-      else if (iCompare > 0)
-         ppvLo = ppvMid + 1;
-      else
-         return ppvMid;
-   }
-   *pppvInsert = ppvLo;
-   return NULL;
-}
+DYNARRAY_DEFINE_BSEARCH(DynArray_bsearchHelp, const void *,
+                        DynArray_Compare, DynArray_callCompare)
 
 /*--------------------------------------------------------------------*/
 
@@ -404,31 +670,47 @@ int DynArray_bsearch(DynArray_T oDynArray,
                      int (*pfCompare)(const void *pvElement1,
                                       const void *pvElement2))
 {
-   const void **ppvElement;
-   const void **ppvInsert;
-
    assert(oDynArray != NULL);
    assert(puIndex != NULL);
    assert(pfCompare != NULL);
    assert(DynArray_isValid(oDynArray));
 
-   if (oDynArray->uLength == 0) {
-      *puIndex = 0;
-      return 0;
-   }
+   if (oDynArray->iIsFrozen)
+      return DynArray_bsearchHelp_frozen(oDynArray->ppvFrozen,
+         oDynArray->puRanks, oDynArray->uLength, pvSoughtElement,
+         puIndex, pfCompare);
+   return DynArray_bsearchHelp(oDynArray->ppvArray,
+      oDynArray->uLength, pvSoughtElement, puIndex, pfCompare);
+}
 
-   ppvElement = DynArray_bsearchHelp(
-      pvSoughtElement,
-      &oDynArray->ppvArray[0],
-      &oDynArray->ppvArray[oDynArray->uLength-1],
-      pfCompare,
-      &ppvInsert);
+/*--------------------------------------------------------------------*/
 
-   if (ppvElement == NULL) {
-      *puIndex = (size_t)(ppvInsert - &oDynArray->ppvArray[0]);
-      return 0;
-   }
+int DynArray_bsearchKey(DynArray_T oDynArray,
+                        const void *pvKey,
+                        size_t *puIndex,
+                        int (*pfCompareKey)(const void *pvKey,
+                                            const void *pvElement))
+{
+   assert(oDynArray != NULL);
+   assert(puIndex != NULL);
+   assert(pfCompareKey != NULL);
+   assert(DynArray_isValid(oDynArray));
 
-   *puIndex = (size_t)(ppvElement - &oDynArray->ppvArray[0]);
-   return 1;
+   if (oDynArray->iIsFrozen)
+      return DynArray_bsearchHelp_frozen(oDynArray->ppvFrozen,
+         oDynArray->puRanks, oDynArray->uLength, pvKey, puIndex,
+         pfCompareKey);
+   return DynArray_bsearchHelp(oDynArray->ppvArray,
+      oDynArray->uLength, pvKey, puIndex, pfCompareKey);
+}
+
+/*--------------------------------------------------------------------*/
+
+void DynArray_getTotals(size_t *puLength, size_t *puPhysLength)
+{
+   assert(puLength != NULL);
+   assert(puPhysLength != NULL);
+
+   *puLength = uTotalLength;
+   *puPhysLength = uTotalPhysLength;
 }
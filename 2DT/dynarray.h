@@ -65,12 +65,41 @@ int DynArray_addAt(DynArray_T oDynArray, size_t uIndex,
 
 /*--------------------------------------------------------------------*/
 
-/* Remove and return the uIndex'th element of oDynArray. */
+/* Add the uCount elements at ppvElements, in order, to the end of
+   oDynArray, reallocating its underlying array at most once.
+   ppvElements must not point into that array.  Return 1 (TRUE) if
+   successful, or 0 (FALSE), leaving oDynArray unchanged, if
+   insufficient memory is available. */
+
+int DynArray_addMany(DynArray_T oDynArray, const void **ppvElements,
+                     size_t uCount);
+
+/*--------------------------------------------------------------------*/
+
+/* Remove and return the uIndex'th element of oDynArray.  Once its
+   length has fallen to a quarter of the elements that its underlying
+   array has room for, the array is halved. */
 
 void *DynArray_removeAt(DynArray_T oDynArray, size_t uIndex);
 
 /*--------------------------------------------------------------------*/
 
+/* Make room in oDynArray for a total of uPhysLength elements, so that
+   adding elements until its length reaches uPhysLength needs no
+   further allocation.  Return 1 (TRUE) if successful, or 0 (FALSE),
+   leaving oDynArray unchanged, if insufficient memory is
+   available. */
+
+int DynArray_reserve(DynArray_T oDynArray, size_t uPhysLength);
+
+/*--------------------------------------------------------------------*/
+
+/* Free the room in oDynArray beyond its length, as far as possible. */
+
+void DynArray_shrinkToFit(DynArray_T oDynArray);
+
+/*--------------------------------------------------------------------*/
+
 /* Fill ppvArray with the elements of oDynArray.  ppvArray must point
    to an area of memory that is large enough to hold all elements of
    oDynArray. */
@@ -79,6 +108,45 @@ void DynArray_toArray(DynArray_T oDynArray, void **ppvArray);
 
 /*--------------------------------------------------------------------*/
 
+/* Return the array that underlies oDynArray, whose first
+   DynArray_getLength(oDynArray) elements are those of oDynArray, in
+   order.  They may be rearranged in place, but the array is valid only
+   until the next call of a function other than DynArray_get,
+   DynArray_set, or DynArray_getLength on oDynArray. */
+
+const void **DynArray_getArray(DynArray_T oDynArray);
+
+/*--------------------------------------------------------------------*/
+
+/* Lay out a copy of the elements of oDynArray, which must be sorted,
+   in Eytzinger order: that of a breadth-first walk of a balanced
+   binary search tree over them, which keeps the few elements that
+   every search probes first together at the front.
+   DynArray_bsearch and DynArray_bsearchKey search the copy until
+   oDynArray is next changed or DynArray_getArray is called, which
+   keeps the copy's memory for the next DynArray_freeze;
+   DynArray_shrinkToFit frees it once it is out of date, and
+   DynArray_free frees it.  Suits arrays that are searched far more
+   often than changed.
+   Return 1 (TRUE) if successful, or 0 (FALSE), leaving oDynArray to
+   be searched as before, if insufficient memory is available. */
+
+int DynArray_freeze(DynArray_T oDynArray);
+
+/*--------------------------------------------------------------------*/
+
+/* If oDynArray has an up to date layout made by DynArray_freeze,
+   return the array holding it, whose elements are at indices 1
+   through DynArray_getLength(oDynArray), and assign to *ppuRanks an
+   array holding at each of those indices the index in oDynArray of
+   the element there.  Otherwise return NULL.  Both arrays are valid
+   until oDynArray is next changed. */
+
+const void **DynArray_getFrozen(DynArray_T oDynArray,
+                                const size_t **ppuRanks);
+
+/*--------------------------------------------------------------------*/
+
 /* Apply function *pfApply to each element of oDynArray, passing
    pvExtra as an extra argument.  That is, for each element pvElement of
    oDynArray, call (*pfApply)(pvElement, pvExtra). */
@@ -92,7 +160,9 @@ void DynArray_map(DynArray_T oDynArray,
 /* Sort oDynArray in the order determined by *pfCompare.
    *pfCompare must return <0, 0, or >0 depending upon whether
    *pvElement1 is less than, equal to, or greater than *pvElement2,
-   respectively. */
+   respectively.  The sort is not stable; it takes O(n log n) time
+   and O(log n) stack for a length of n, whatever the order of the
+   elements. */
 
 void DynArray_sort(DynArray_T oDynArray,
                    int (*pfCompare)(const void *pvElement1,
@@ -100,6 +170,25 @@ void DynArray_sort(DynArray_T oDynArray,
 
 /*--------------------------------------------------------------------*/
 
+/* Merge the uCount elements at ppvElements into oDynArray, both of
+   which must be sorted in the order determined by *pfCompare, as for
+   DynArray_sort, so that oDynArray stays sorted.  Each added element
+   follows those already in oDynArray that are equal to it.  The merge
+   takes O(n + k) time for a length of n and k elements, where adding
+   them one at a time with DynArray_addAt would take O(n k), and
+   reallocates the underlying array at most once.  ppvElements must
+   not point into that array.  Return 1 (TRUE) if successful, or
+   0 (FALSE), leaving oDynArray unchanged, if insufficient memory is
+   available. */
+
+int DynArray_addManySorted(DynArray_T oDynArray,
+                           const void **ppvElements,
+                           size_t uCount,
+                           int (*pfCompare)(const void *pvElement1,
+                                            const void *pvElement2));
+
+/*--------------------------------------------------------------------*/
+
 /* Linear search oDynArray for *pvSoughtElement using *pfCompare to
    determine equality.  If the element is found, then assign its
    index to *puIndex and return 1.  If the element is not found, then
@@ -121,7 +210,10 @@ int DynArray_search(DynArray_T oDynArray,
    assign the index where it would belong to *puIndex and return 0.
    *pfCompare must return <0, 0, or >0 if *pvElement1 is less than,
    equal to, or greater than *pvElement2.
-   oDynArray must be sorted as determined by *pfCompare. */
+   oDynArray must be sorted as determined by *pfCompare.  The search
+   uses the layout made by DynArray_freeze while it is up to date.  Of
+   several matching elements, it finds the first in that layout or in
+   an array of up to 65536 elements, and any one otherwise. */
 
 int DynArray_bsearch(DynArray_T oDynArray, 
                      void *pvSoughtElement,
@@ -129,4 +221,35 @@ int DynArray_bsearch(DynArray_T oDynArray,
                      int (*pfCompare)(const void *pvElement1,
                                       const void *pvElement2));
 
+/*--------------------------------------------------------------------*/
+
+/* Binary search oDynArray for an element matching *pvKey using
+   *pfCompareKey to determine equality.  If the element is found, then
+   assign its index to *puIndex and return 1.  If the element is not
+   found, then assign the index where it would belong to *puIndex and
+   return 0.
+   *pfCompareKey must return <0, 0, or >0 if *pvKey is less than,
+   equal to, or greater than *pvElement.  Unlike DynArray_bsearch,
+   pvKey need not be an element of the same type as those in
+   oDynArray.  oDynArray must be sorted consistently with
+   *pfCompareKey.  The search is otherwise as for
+   DynArray_bsearch. */
+
+int DynArray_bsearchKey(DynArray_T oDynArray,
+                        const void *pvKey,
+                        size_t *puIndex,
+                        int (*pfCompareKey)(const void *pvKey,
+                                            const void *pvElement));
+
+/*--------------------------------------------------------------------*/
+
+/* Assign to *puLength the total length of all DynArray_T objects that
+   have not been freed, and to *puPhysLength the total number of
+   elements that their underlying arrays have room for, which exceeds
+   *puLength by the room left by growing them and by that of the
+   layouts made by DynArray_freeze, counted as the number of elements
+   that would take as much room. */
+
+void DynArray_getTotals(size_t *puLength, size_t *puPhysLength);
+
 #endif
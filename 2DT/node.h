@@ -59,8 +59,7 @@ size_t Node_getNumChildren(Node n);
 
 /*
    Returns 1 if n has a child directory with path,
-   0 if it does not have such a child, and -1 if
-   there is an allocation error during search.
+   or 0 if it does not have such a child.
 
    If n does have such a child, and childID is not NULL, store the
    child's identifier in *childID. If n does not have such a child,
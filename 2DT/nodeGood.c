@@ -8,9 +8,15 @@
 #include <assert.h>
 #include <stdio.h>
 
-#include "dynarray.h"
+#include "dynarraydef.h"
 #include "node.h"
 
+/*
+   A NodeArray_T is a DynArray of Nodes whose sort and search compare
+   them by path without a call through a function pointer
+*/
+DYNARRAY_DECLARE(NodeArray, Node, const char*)
+
 /*
    A node structure represents a directory in the directory tree
 */
@@ -24,7 +30,7 @@ struct node {
 
    /* the subdirectories of this directory
       stored in sorted order by pathname */
-   DynArray_T children;
+   NodeArray_T children;
 };
 
 
@@ -78,7 +84,7 @@ Node Node_create(const char* dir, Node parent){
    }
 
    new->parent = parent;
-   new->children = DynArray_new(0);
+   new->children = NodeArray_new(0);
    if(new->children == NULL) {
       free(new->path);
       free(new);
@@ -96,12 +102,12 @@ size_t Node_destroy(Node n) {
 
    assert(n != NULL);
 
-   for(i = 0; i < DynArray_getLength(n->children); i++)
+   for(i = 0; i < NodeArray_getLength(n->children); i++)
    {
-      c = DynArray_get(n->children, i);
+      c = NodeArray_get(n->children, i);
       count += Node_destroy(c);
    }
-   DynArray_free(n->children);
+   NodeArray_free(n->children);
 
    free(n->path);
    free(n);
@@ -143,24 +149,37 @@ int Node_compare(Node node1, Node node2) {
 size_t Node_getNumChildren(Node n) {
    assert(n != NULL);
 
-   return DynArray_getLength(n->children);
+   return NodeArray_getLength(n->children);
+}
+
+/*
+  Compares the string key to the path of n, returning <0, 0, or >0
+  as for Node_compare, so that children can be searched by path
+  without creating a Node to compare against.
+*/
+static int Node_compareKey(const char* key, Node n) {
+   assert(key != NULL);
+   assert(n != NULL);
+
+   return strcmp(key, n->path);
 }
 
+/*
+  Defines the NodeArray functions where the comparisons that they
+  inline are visible.
+*/
+DYNARRAY_DEFINE(NodeArray, Node, Node_compare, const char*,
+                Node_compareKey)
+
 /* see node.h for specification */
 int Node_hasChild(Node n, const char* path, size_t* childID) {
    size_t index;
    int result;
-   Node checker;
 
    assert(n != NULL);
    assert(path != NULL);
 
-   checker = Node_create(path, NULL);
-   if(checker == NULL)
-      return -1;
-   result = DynArray_bsearch(n->children, checker, &index,
-                    (int (*)(const void*, const void*)) Node_compare);
-   (void) Node_destroy(checker);
+   result = NodeArray_bsearchKey(n->children, path, &index);
 
    if(childID != NULL)
       *childID = index;
@@ -171,8 +190,8 @@ int Node_hasChild(Node n, const char* path, size_t* childID) {
 Node Node_getChild(Node n, size_t childID) {
    assert(n != NULL);
 
-   if(DynArray_getLength(n->children) > childID)
-      return DynArray_get(n->children, childID);
+   if(NodeArray_getLength(n->children) > childID)
+      return NodeArray_get(n->children, childID);
    else
       return NULL;
 }
@@ -206,11 +225,10 @@ int Node_linkChild(Node parent, Node child) {
 
    child->parent = parent;
 
-   if(DynArray_bsearch(parent->children, child, &i,
-         (int (*)(const void*, const void*)) Node_compare) == 1)
+   if(NodeArray_bsearch(parent->children, child, &i) == 1)
       return ALREADY_IN_TREE;
 
-   if(DynArray_addAt(parent->children, i, child) == TRUE)
+   if(NodeArray_addAt(parent->children, i, child) == TRUE)
       return SUCCESS;
    else
       return PARENT_CHILD_ERROR;
@@ -223,11 +241,10 @@ int  Node_unlinkChild(Node parent, Node child) {
    assert(parent != NULL);
    assert(child != NULL);
 
-   if(DynArray_bsearch(parent->children, child, &i,
-         (int (*)(const void*, const void*)) Node_compare) == 0)
+   if(NodeArray_bsearch(parent->children, child, &i) == 0)
       return PARENT_CHILD_ERROR;
 
-   (void) DynArray_removeAt(parent->children, i);
+   (void) NodeArray_removeAt(parent->children, i);
    return SUCCESS;
 }
 
@@ -9,189 +9,1903 @@
 #include <stdio.h>
 
 #include "dynarray.h"
+#include "dynarraydef.h"
+#include "btree.h"
+#include "slab.h"
+#include "intern.h"
+#include "arena.h"
+#include "hash.h"
 #include "DTNode.h"
 #include "FileNode.h"
 
+/* A key used to search a directory's children by final path component
+   without building a probe node. */
+struct DTNode_key {
+   /* the sought component, not necessarily NUL-terminated */
+   const char* name;
+
+   /* the number of characters in the sought component */
+   size_t len;
+};
+
+/* ChildArray_T is a DynArray of a directory's tagged children, whose
+   sort and search compare them by name without a call through a
+   function pointer. */
+DYNARRAY_DECLARE(ChildArray, void*, const struct DTNode_key*)
+
+/* The number of children that a directory holds in its own struct
+   before moving them all to a DynArray. */
+enum { INLINE_CHILDREN = 4 };
+
+/* The children of a directory, files and subdirectories together, as
+   tagged pointers: held inline while there are few, so that small
+   directories need no further allocation, in a DynArray once there
+   have been more, and in a BTree while there are very many to keep
+   sorted on every insertion. */
+struct DTNode_children {
+   /* the number of children held inline, or, once they have been
+      spilled from a directory in an arena or while slabs are in use,
+      the index of the directory among the arena's spilled directories
+      or those freed with the slab */
+   size_t length;
+
+   /* the children held inline, in order */
+   void* inlined[INLINE_CHILDREN];
+
+   /* all of the children, in order, once there have been more than
+      INLINE_CHILDREN, otherwise NULL: a ChildArray_T, or, while there
+      are very many and the directory has no map, a BTree_T, tagged
+      with its lowest bit set as a file is among the children */
+   void* spilled;
+
+   /* the number of times that the DynArray, if any, has been searched
+      since it was last frozen */
+   size_t searches;
+};
+
+/* The ways in which a DTNode may have been allocated: by malloc, from
+   the slab, from the pool of nodes too large for the slab, or from its
+   arena, together with its own copy of its name unless it is
+   interned. */
+enum DTNode_source { FROM_MALLOC, FROM_SLAB, FROM_OVERFLOW, FROM_ARENA };
+
 /* A directory node structure represents a directory in the directory tree. */
 struct DTNode {
-   /* the full path of this directory */
-   char* path;
+   /* the final component of the path of this directory */
+   const char* name;
+
+   /* the length of the full path of this directory */
+   size_t pathLen;
+
+   /* the parent directory of this directory
+      NULL for the root of the directory tree */
+   DTNode parent;
+
+   /* the files and subdirectories of this directory, stored in
+      sorted order by name, unless map is in use */
+   struct DTNode_children children;
+
+   /* a hash map locating the children by name once there are too many
+      to keep sorted on every insertion, otherwise NULL */
+   struct DTNode_childMap* map;
+
+   /* a Bloom filter over the names of all the children, if filters
+      are in use and there are enough children, otherwise NULL */
+   struct DTNode_filter* filter;
+
+   /* the arena from which this directory, its name, map and filter
+      were allocated, or NULL if it is not in an arena */
+   struct DTNode_arena* arena;
+
+   /* how this directory was allocated */
+   enum DTNode_source source;
+};
+
+/* An arena holds every node of the subtree of a directory created by
+   DTNode_createArena, so that destroying that directory frees them all
+   at once rather than one by one. Names in an arena are never
+   interned, as releasing them would need a visit to every node. */
+struct DTNode_arena {
+   /* the memory of the nodes, their names, maps and filters, and of
+      this structure itself */
+   Arena_T memory;
+
+   /* the number of nodes allocated from the arena and not destroyed */
+   size_t numNodes;
+
+   /* the directories whose children have spilled into a DynArray or
+      BTree, which is allocated by malloc and must be freed
+      separately */
+   DynArray_T spilled;
+
+   /* the bytes of each kind of memory charged to the nodes in the
+      arena, which leave the tallies together with it */
+   size_t charged[NUM_MEMORY_KINDS];
+
+   /* the index of this arena among those freed with the slab, if it
+      was created while slabs are in use */
+   size_t slot;
+};
+
+/* The number of children above which a directory locates them
+   through a hash map, if maps are in use, and appends new ones
+   without sorting. */
+static const size_t MAP_THRESHOLD = 256;
+
+/* The number of children below which a directory drops its hash
+   map and keeps them sorted on every insertion again. */
+static const size_t UNMAP_THRESHOLD = 64;
+
+/* The number of children from which a directory's DynArray is frozen
+   into the Eytzinger layout of DynArray_freeze once it has been
+   searched as many times as it has children since it was last
+   frozen. A directory that is read far more often than changed is
+   then searched in that layout, while one that changes between
+   searches pays O(1) per search, amortized, for laying it out. */
+static const size_t FREEZE_THRESHOLD = 64;
+
+/* The number of children above which a directory without a map, which
+   keeps them sorted on every insertion, moves them from a DynArray to
+   a BTree, in which inserting or removing one never shifts the
+   rest. */
+static const size_t TREE_THRESHOLD = 4096;
+
+/* The number of children below which a directory moves them from a
+   BTree back to a DynArray, in which getting one by index is quicker,
+   as it also does once it has a map, which only ever appends them or
+   moves the last. */
+static const size_t UNTREE_THRESHOLD = 1024;
+
+/* An entry in a child map. An empty slot has a NULL node. */
+struct DTNode_mapEntry {
+   /* the hash of the child's final path component */
+   size_t hash;
+
+   /* the tagged child */
+   void* node;
+
+   /* the child's index in its DynArray */
+   size_t index;
+};
+
+/* A child map is an open-addressing hash table, using linear probing,
+   from the names of a directory's children to their indices in its
+   DynArray. */
+struct DTNode_childMap {
+   /* the slots of the table */
+   struct DTNode_mapEntry* entries;
+
+   /* the number of slots, a power of two */
+   size_t capacity;
+
+   /* the number of children in the table */
+   size_t size;
+
+   /* TRUE if the DynArray is currently in sorted order */
+   boolean isSorted;
+};
+
+/* The number of children from which a directory keeps a Bloom filter
+   over their names when filters are in use. Smaller directories are
+   searched about as fast without one. */
+static const size_t FILTER_THRESHOLD = 16;
+
+/* The number of filter bits per name, and the number of bits set for
+   each name, giving a false-positive rate of about 3% when full. */
+static const size_t FILTER_BITS_PER_NAME = 8;
+static const size_t FILTER_HASHES = 3;
+
+/* A Bloom filter over the names of a directory's children. Bits are
+   never cleared, so the names of unlinked children linger until the
+   filter is rebuilt. */
+struct DTNode_filter {
+   /* the bits of the filter */
+   unsigned char* bits;
+
+   /* the number of bits, a power of two */
+   size_t numBits;
+
+   /* the number of names added since the filter was last built,
+      including those of children since unlinked */
+   size_t numNames;
+};
+
+/* TRUE if directories keep Bloom filters over their children. */
+static boolean useFilters = FALSE;
+
+/* TRUE if directories with many children locate them through a hash
+   map, or FALSE if they keep them sorted, in a BTree once there are
+   very many. */
+static boolean useMaps = TRUE;
+
+/* Counts of the searches that consulted a filter, those the filter
+   rejected, and those it passed that found no child. */
+static size_t filterProbes;
+static size_t filterRejects;
+static size_t filterFalsePositives;
+
+/* The number of characters, including the terminating nul, of the
+   longest name stored in a DTNode allocated from the slab. Unless
+   names are interned, a node and its name are always allocated
+   together, the name following the struct, and longer names make for
+   nodes of other sizes. */
+static const size_t SLAB_NAME_SIZE = 24;
+
+/* TRUE if DTNodes are allocated from slab, and the slab, which is
+   created when it is first needed. */
+static boolean useSlabs = FALSE;
+static Slab_T slab;
+
+/* While slabs are in use, the pool from which DTNodes with names too
+   long for the slab are allocated, which is created when it is first
+   needed, and the directories outside arenas whose children have
+   spilled and the arenas, so that DTNode_destroyAll can free them all
+   without visiting the nodes. */
+static Arena_T overflow;
+static DynArray_T spilledDirs;
+static DynArray_T arenas;
+
+/* The pool in which DTNodes' names are interned, or NULL if each
+   DTNode holds its own copy of its name. */
+static Intern_T names;
+
+/* The bytes of each kind of memory charged to nodes, in or out of
+   arenas, by DTNode_charge. */
+static size_t charged[NUM_MEMORY_KINDS];
+
+/* Returns child, a FileNode if type is TRUE and a DTNode otherwise,
+   tagged for storage among a directory's children: a file's address
+   has its lowest bit, which the alignment of nodes leaves clear, set. */
+static void* DTNode_tag(void* child, boolean type) {
+   assert(child != NULL);
+   assert(((size_t) child & 1) == 0);
+
+   if(type)
+      return (char*) child + 1;
+   return child;
+}
+
+/* Returns TRUE if entry, a tagged child, is a file, and FALSE if it
+   is a directory. */
+static boolean DTNode_isFile(const void* entry) {
+   return ((size_t) entry & 1) != 0;
+}
+
+/* Returns the child tagged as entry. */
+static void* DTNode_untag(const void* entry) {
+   return (char*) entry - ((size_t) entry & 1);
+}
+
+/* Allocates size bytes for n's map or filter, from n's arena if it is
+   in one and by malloc otherwise, charging them to n. Returns NULL if
+   insufficient memory is available. */
+static void* DTNode_alloc(DTNode n, size_t size) {
+   void* p;
+
+   assert(n != NULL);
+
+   if(n->arena != NULL)
+      p = Arena_alloc(n->arena->memory, size);
+   else
+      p = malloc(size);
+   if(p != NULL)
+      DTNode_charge(n, MEMORY_LOOKUP, size);
+   return p;
+}
+
+/* Allocates size bytes for n's use, as DTNode_alloc does, and sets
+   them all to zero. */
+static void* DTNode_allocZeroed(DTNode n, size_t size) {
+   void* p;
+
+   p = DTNode_alloc(n, size);
+   if(p != NULL)
+      memset(p, 0, size);
+   return p;
+}
+
+/* Frees p, which was allocated by DTNode_alloc(n, size). */
+static void DTNode_release(DTNode n, void* p, size_t size) {
+   assert(n != NULL);
+   assert(p != NULL);
+
+   DTNode_discharge(n, MEMORY_LOOKUP, size);
+   if(n->arena != NULL)
+      Arena_release(n->arena->memory, p, size);
+   else
+      free(p);
+}
+
+/* Returns the DynArray into which c's children have spilled, or NULL
+   if they are held inline or in a BTree. */
+static ChildArray_T DTNode_childrenArray(const struct DTNode_children* c) {
+   assert(c != NULL);
+
+   if(((size_t) c->spilled & 1) != 0)
+      return NULL;
+   return c->spilled;
+}
+
+/* Returns the BTree into which c's children have spilled, or NULL if
+   they are held inline or in a DynArray. */
+static BTree_T DTNode_childrenTree(const struct DTNode_children* c) {
+   assert(c != NULL);
+
+   if(((size_t) c->spilled & 1) == 0)
+      return NULL;
+   return (BTree_T) ((char*) c->spilled - 1);
+}
+
+/* Returns the number of children in c. */
+static size_t DTNode_childrenLength(const struct DTNode_children* c) {
+   assert(c != NULL);
+
+   if(DTNode_childrenArray(c) != NULL)
+      return ChildArray_getLength(c->spilled);
+   if(c->spilled != NULL)
+      return BTree_getLength(DTNode_childrenTree(c));
+   return c->length;
+}
+
+/* Returns the child at index i of c. */
+static void* DTNode_childrenGet(const struct DTNode_children* c,
+                                size_t i) {
+   assert(c != NULL);
+
+   if(DTNode_childrenArray(c) != NULL)
+      return ChildArray_get(c->spilled, i);
+   if(c->spilled != NULL)
+      return BTree_get(DTNode_childrenTree(c), i);
+   assert(i < c->length);
+   return c->inlined[i];
+}
+
+/* Replaces the child at index i of c, which must have spilled, with
+   child. */
+static void DTNode_childrenSet(struct DTNode_children* c, size_t i,
+                               void* child) {
+   assert(c != NULL);
+
+   assert(c->spilled != NULL);
+
+   if(DTNode_childrenArray(c) != NULL)
+      (void) ChildArray_set(c->spilled, i, child);
+   else
+      (void) BTree_set(DTNode_childrenTree(c), i, child);
+}
+
+/* Adds n, whose children are about to spill, to the directories whose
+   spilled children are freed in bulk: its arena's, if it is in one,
+   or, while slabs are in use, those freed with the slab. Stores n's
+   index among them, or 0 if it is added to neither, in *pSlot.
+   Returns TRUE if successful, or FALSE if insufficient memory is
+   available. */
+static boolean DTNode_childrenRegister(DTNode n, size_t* pSlot) {
+   DynArray_T registry;
+
+   assert(n != NULL);
+   assert(pSlot != NULL);
+
+   *pSlot = 0;
+   if(n->arena != NULL)
+      registry = n->arena->spilled;
+   else if(useSlabs) {
+      if(spilledDirs == NULL)
+         spilledDirs = DynArray_new(0);
+      if(spilledDirs == NULL)
+         return FALSE;
+      registry = spilledDirs;
+   }
+   else
+      return TRUE;
+
+   *pSlot = DynArray_getLength(registry);
+   return DynArray_add(registry, n);
+}
+
+/* Moves n's children, which must be held inline, to a DynArray with
+   room for at least room of them, first registering n so that its
+   arena or DTNode_destroyAll can free the DynArray along with
+   everything else. Returns TRUE if successful, or FALSE, leaving the
+   children inline, if insufficient memory is available. */
+static boolean DTNode_childrenSpill(DTNode n, size_t room) {
+   struct DTNode_children* c;
+   ChildArray_T spilled;
+   size_t slot;
+
+   assert(n != NULL);
+   assert(n->children.spilled == NULL);
+
+   c = &n->children;
+   spilled = ChildArray_new(0);
+   if(spilled == NULL)
+      return FALSE;
+   if(ChildArray_reserve(spilled, room) == FALSE ||
+      ChildArray_addMany(spilled, c->inlined, c->length) == FALSE) {
+      ChildArray_free(spilled);
+      return FALSE;
+   }
+
+   if(DTNode_childrenRegister(n, &slot) == FALSE) {
+      ChildArray_free(spilled);
+      return FALSE;
+   }
+   c->spilled = spilled;
+   c->length = slot;
+   return TRUE;
+}
+
+/* Inserts child into n's children at index i, moving them to a
+   DynArray if they no longer fit inline. Returns TRUE if successful,
+   or FALSE if insufficient memory is available. */
+static boolean DTNode_childrenInsert(DTNode n, size_t i, void* child) {
+   struct DTNode_children* c;
+   size_t j;
+
+   assert(n != NULL);
+
+   c = &n->children;
+   if(DTNode_childrenTree(c) != NULL)
+      return BTree_addAt(DTNode_childrenTree(c), i, child);
+   if(c->spilled == NULL && c->length < INLINE_CHILDREN) {
+      assert(i <= c->length);
+      for(j = c->length; j > i; j--)
+         c->inlined[j] = c->inlined[j - 1];
+      c->inlined[i] = child;
+      c->length++;
+      return TRUE;
+   }
+
+   /* Making room for the children moved and as many again at once,
+      rather than growing the DynArray as each is added. */
+   if(c->spilled == NULL &&
+      DTNode_childrenSpill(n, 2 * INLINE_CHILDREN) == FALSE)
+      return FALSE;
+   return ChildArray_addAt(c->spilled, i, child);
+}
+
+/* Appends the count tagged children at entries to n's children, which
+   must have spilled. Returns TRUE if successful, or FALSE, leaving
+   the children unchanged, if insufficient memory is available. */
+static boolean DTNode_childrenAppend(DTNode n, void** entries,
+                                     size_t count) {
+   struct DTNode_children* c;
+   BTree_T tree;
+   size_t length;
+   size_t i;
+
+   assert(n != NULL);
+   assert(entries != NULL);
+
+   c = &n->children;
+   assert(c->spilled != NULL);
+
+   if(DTNode_childrenArray(c) != NULL)
+      return ChildArray_addMany(c->spilled, entries, count);
+
+   tree = DTNode_childrenTree(c);
+   length = BTree_getLength(tree);
+   for(i = 0; i < count; i++) {
+      if(BTree_addAt(tree, length + i, entries[i]) == 0) {
+         while(i-- > 0)
+            (void) BTree_removeAt(tree, length + i);
+         return FALSE;
+      }
+   }
+   return TRUE;
+}
+
+/* Moves n's children, if they have spilled, to a BTree once there are
+   more than TREE_THRESHOLD of them and n has no map, and back to a
+   DynArray once there are fewer than UNTREE_THRESHOLD or n has a map.
+   If insufficient memory is available, they stay where they are. */
+static void DTNode_childrenRetier(DTNode n) {
+   struct DTNode_children* c;
+   ChildArray_T spilled;
+   BTree_T tree;
+   void** entries;
+   size_t length;
+   size_t i;
+
+   assert(n != NULL);
+
+   c = &n->children;
+   spilled = DTNode_childrenArray(c);
+   tree = DTNode_childrenTree(c);
+   length = DTNode_childrenLength(c);
+   if(spilled != NULL && n->map == NULL && length > TREE_THRESHOLD) {
+      entries = malloc(length * sizeof(void*));
+      if(entries == NULL)
+         return;
+      for(i = 0; i < length; i++)
+         entries[i] = ChildArray_get(spilled, i);
+      tree = BTree_fromArray((const void**) entries, length);
+      free(entries);
+      if(tree == NULL)
+         return;
+      ChildArray_free(spilled);
+      assert(((size_t) tree & 1) == 0);
+      c->spilled = (char*) tree + 1;
+   }
+   else if(tree != NULL && (n->map != NULL || length < UNTREE_THRESHOLD)) {
+      spilled = ChildArray_new(0);
+      if(spilled == NULL)
+         return;
+      if(ChildArray_reserve(spilled, length) == FALSE) {
+         ChildArray_free(spilled);
+         return;
+      }
+      /* Getting each in turn takes O(1) time. */
+      for(i = 0; i < length; i++)
+         (void) ChildArray_add(spilled, BTree_get(tree, i));
+      BTree_free(tree);
+      c->spilled = spilled;
+   }
+}
+
+/* Frees the DynArray or BTree into which c's children have
+   spilled. */
+static void DTNode_childrenFree(struct DTNode_children* c) {
+   assert(c != NULL);
+
+   if(DTNode_childrenArray(c) != NULL)
+      ChildArray_free(c->spilled);
+   else
+      BTree_free(DTNode_childrenTree(c));
+}
+
+/* Removes n, a directory whose children have spilled, from the
+   directories to which DTNode_childrenRegister added it, if any. */
+static void DTNode_childrenUnregister(DTNode n) {
+   DynArray_T spilled;
+   DTNode moved;
+   size_t last;
+
+   assert(n != NULL);
+   assert(n->children.spilled != NULL);
+
+   if(n->arena != NULL)
+      spilled = n->arena->spilled;
+   else if(useSlabs)
+      spilled = spilledDirs;
+   else
+      return;
+   last = DynArray_getLength(spilled) - 1;
+   moved = DynArray_get(spilled, last);
+   (void) DynArray_set(spilled, n->children.length, moved);
+   moved->children.length = n->children.length;
+   (void) DynArray_removeAt(spilled, last);
+}
+
+/* Removes the child at index i of c. */
+static void DTNode_childrenRemoveAt(struct DTNode_children* c,
+                                    size_t i) {
+   assert(c != NULL);
+
+   if(DTNode_childrenArray(c) != NULL) {
+      (void) ChildArray_removeAt(c->spilled, i);
+      return;
+   }
+   if(c->spilled != NULL) {
+      (void) BTree_removeAt(DTNode_childrenTree(c), i);
+      return;
+   }
+   assert(i < c->length);
+   c->length--;
+   for(; i < c->length; i++)
+      c->inlined[i] = c->inlined[i + 1];
+}
+
+/* Compares the component sought by key with childName, the final
+   component of a child's path. Returns <0, 0, or >0 if the key is
+   less than, equal to, or greater than the child, respectively. */
+static int DTNode_compareName(const struct DTNode_key* key,
+                              const char* childName) {
+   int result;
+
+   assert(key != NULL);
+   assert(childName != NULL);
+
+   /* Interned names are equal exactly when they are the same. */
+   if(key->name == childName && childName[key->len] == '\0')
+      return 0;
+
+   result = strncmp(key->name, childName, key->len);
+   if(result != 0)
+      return result;
+
+   /* The key is a proper prefix of the child's component. */
+   if(childName[key->len] != '\0')
+      return -1;
+   return 0;
+}
+
+
+/* Returns the name of entry, a tagged child. */
+static const char* DTNode_nameOf(const void* entry) {
+   assert(entry != NULL);
+
+   if(DTNode_isFile(entry))
+      return FileNode_getName((FileNode) DTNode_untag(entry));
+   return ((DTNode) entry)->name;
+}
+
+/* Sets *key to seek the name of entry, a tagged child. */
+static void DTNode_childKey(const void* entry, struct DTNode_key* key) {
+   assert(key != NULL);
+
+   key->name = DTNode_nameOf(entry);
+   key->len = strlen(key->name);
+}
+
+/* Compares the component sought by key with entry, a tagged child. */
+static int DTNode_compareKey(const struct DTNode_key* key,
+                             const void* entry) {
+   return DTNode_compareName(key, DTNode_nameOf(entry));
+}
+
+/* Compares entry1 and entry2, tagged children of one directory, by
+   name. */
+static int DTNode_compareEntries(const void* entry1, const void* entry2) {
+   return strcmp(DTNode_nameOf(entry1), DTNode_nameOf(entry2));
+}
+
+/* Defining the ChildArray functions where the comparisons that they
+   inline are visible. */
+DYNARRAY_DEFINE(ChildArray, void*, DTNode_compareEntries,
+                const struct DTNode_key*, DTNode_compareKey)
+
+/* Compares key, a struct DTNode_key, with entry, a tagged child, as
+   DTNode_compareKey does, for BTree_bsearchKey. */
+static int DTNode_compareTreeKey(const void* key, const void* entry) {
+   return DTNode_compareKey(key, entry);
+}
+
+/* Searches c, which must be sorted by name, for a child whose final
+   path component is sought by key, as DynArray_bsearchKey does,
+   freezing c's DynArray first if it is due. */
+static int DTNode_childrenSearch(struct DTNode_children* c,
+                                 const struct DTNode_key* key,
+                                 size_t* puIndex) {
+   const size_t* ranks;
+   size_t length;
+   int result;
+   size_t i;
+
+   assert(c != NULL);
+   assert(puIndex != NULL);
+
+   if(DTNode_childrenArray(c) != NULL) {
+      length = ChildArray_getLength(c->spilled);
+      if(length >= FREEZE_THRESHOLD &&
+         DynArray_getFrozen(c->spilled, &ranks) == NULL &&
+         ++c->searches >= length) {
+         /* If it cannot be frozen, it is searched where it is. */
+         c->searches = 0;
+         (void) ChildArray_freeze(c->spilled);
+      }
+      return ChildArray_bsearchKey(c->spilled, key, puIndex);
+   }
+   if(c->spilled != NULL)
+      return BTree_bsearchKey(DTNode_childrenTree(c), key, puIndex,
+                              DTNode_compareTreeKey);
+
+   /* So few children are quickest to scan in order. */
+   for(i = 0; i < c->length; i++) {
+      result = DTNode_compareKey(key, c->inlined[i]);
+      if(result <= 0) {
+         *puIndex = i;
+         return result == 0;
+      }
+   }
+   *puIndex = c->length;
+   return 0;
+}
+
+/* Merges the count tagged children at entries, which must be sorted
+   by name and distinct from each other and from c's children, into
+   c's children, which must have spilled and be sorted. Returns TRUE
+   if successful, or FALSE, leaving the children unchanged, if
+   insufficient memory is available. */
+static boolean DTNode_childrenAddSorted(struct DTNode_children* c,
+                                        void** entries, size_t count) {
+   struct DTNode_key key;
+   BTree_T tree;
+   size_t index;
+   size_t i;
+
+   assert(c != NULL);
+   assert(c->spilled != NULL);
+   assert(entries != NULL);
+
+   if(DTNode_childrenArray(c) != NULL)
+      return ChildArray_addManySorted(c->spilled, entries, count);
+
+   tree = DTNode_childrenTree(c);
+   for(i = 0; i < count; i++) {
+      DTNode_childKey(entries[i], &key);
+      (void) DTNode_childrenSearch(c, &key, &index);
+      if(BTree_addAt(tree, index, entries[i]) == 0) {
+         while(i-- > 0) {
+            DTNode_childKey(entries[i], &key);
+            (void) DTNode_childrenSearch(c, &key, &index);
+            (void) BTree_removeAt(tree, index);
+         }
+         return FALSE;
+      }
+   }
+   return TRUE;
+}
+
+/* Restores the heap of the children of c at indices below end, which
+   is one apart from the child at root, by sifting that child down. */
+static void DTNode_childrenSiftDown(struct DTNode_children* c,
+                                    size_t root, size_t end) {
+   void* top;
+   size_t i;
+
+   assert(c != NULL);
+
+   top = DTNode_childrenGet(c, root);
+   for(i = 2 * root + 1; i < end; i = 2 * root + 1) {
+      if(i + 1 < end &&
+         DTNode_compareEntries(DTNode_childrenGet(c, i),
+                               DTNode_childrenGet(c, i + 1)) < 0)
+         i++;
+      if(DTNode_compareEntries(top, DTNode_childrenGet(c, i)) >= 0)
+         break;
+      DTNode_childrenSet(c, root, DTNode_childrenGet(c, i));
+      root = i;
+   }
+   DTNode_childrenSet(c, root, top);
+}
+
+/* Sorts c's children, which must have spilled, by name. Children in
+   a BTree are sorted in a copy, or, if insufficient memory is
+   available for one, by heapsort where they are. */
+static void DTNode_childrenSort(struct DTNode_children* c) {
+   BTree_T tree;
+   void** entries;
+   void* top;
+   size_t length;
+   size_t i;
+
+   assert(c != NULL);
+   assert(c->spilled != NULL);
+
+   if(DTNode_childrenArray(c) != NULL) {
+      ChildArray_sort(c->spilled);
+      return;
+   }
+
+   tree = DTNode_childrenTree(c);
+   length = BTree_getLength(tree);
+   entries = malloc(length * sizeof(void*));
+   if(entries != NULL) {
+      BTree_toArray(tree, entries);
+      ChildArray_sortHelp((const void**) entries, length, 0);
+      for(i = 0; i < length; i++)
+         (void) BTree_set(tree, i, entries[i]);
+      free(entries);
+      return;
+   }
+
+   for(i = length / 2; i > 0; i--)
+      DTNode_childrenSiftDown(c, i - 1, length);
+   for(i = length; i > 1; i--) {
+      top = DTNode_childrenGet(c, 0);
+      DTNode_childrenSet(c, 0, DTNode_childrenGet(c, i - 1));
+      DTNode_childrenSet(c, i - 1, top);
+      DTNode_childrenSiftDown(c, 0, i - 1);
+   }
+}
+
+/* Returns the entry of map for the child whose final component is
+   sought by key, which hashes to hash, or NULL if there is none. */
+static struct DTNode_mapEntry* DTNode_mapFind(
+   struct DTNode_childMap* map, const struct DTNode_key* key,
+   size_t hash) {
+   size_t mask;
+   size_t i;
+
+   assert(map != NULL);
+   assert(key != NULL);
+
+   mask = map->capacity - 1;
+   for(i = hash & mask; map->entries[i].node != NULL; i = (i + 1) & mask) {
+      if(map->entries[i].hash == hash &&
+         DTNode_compareKey(key, map->entries[i].node) == 0)
+         return &map->entries[i];
+   }
+   return NULL;
+}
+
+/* Returns the entry of map for entry, a tagged child in the map. */
+static struct DTNode_mapEntry* DTNode_mapFindChild(
+   struct DTNode_childMap* map, const void* entry) {
+   struct DTNode_key key;
+
+   DTNode_childKey(entry, &key);
+   return DTNode_mapFind(map, &key, Hash_bytes(key.name, key.len));
+}
+
+/* Stores *e in the first free slot of its probe sequence in the
+   entries of a map with capacity slots. */
+static void DTNode_mapPlace(struct DTNode_mapEntry* entries,
+                            size_t capacity,
+                            const struct DTNode_mapEntry* e) {
+   size_t mask = capacity - 1;
+   size_t i;
+
+   assert(entries != NULL);
+   assert(e != NULL);
+
+   for(i = e->hash & mask; entries[i].node != NULL; i = (i + 1) & mask)
+      ;
+   entries[i] = *e;
+}
+
+/* Grows n's map until it has room for size children while at most
+   half full. Returns TRUE if successful, or FALSE, leaving the map
+   unchanged, if insufficient memory is available. */
+static boolean DTNode_mapReserve(DTNode n, size_t size) {
+   struct DTNode_childMap* map;
+   struct DTNode_mapEntry* newEntries;
+   size_t capacity;
+   size_t i;
+
+   assert(n != NULL);
+   assert(n->map != NULL);
+
+   map = n->map;
+   capacity = map->capacity;
+   while(size * 2 > capacity)
+      capacity *= 2;
+   if(capacity == map->capacity)
+      return TRUE;
+
+   newEntries = DTNode_allocZeroed(n, capacity *
+                                   sizeof(struct DTNode_mapEntry));
+   if(newEntries == NULL)
+      return FALSE;
+   for(i = 0; i < map->capacity; i++) {
+      if(map->entries[i].node != NULL)
+         DTNode_mapPlace(newEntries, capacity, &map->entries[i]);
+   }
+   DTNode_release(n, map->entries,
+                  map->capacity * sizeof(struct DTNode_mapEntry));
+   map->entries = newEntries;
+   map->capacity = capacity;
+   return TRUE;
+}
+
+/* Adds child, whose name hashes to hash, at index to n's map, growing
+   the map to keep it at most half full. Returns TRUE if successful, or
+   FALSE if insufficient memory is available. */
+static boolean DTNode_mapAdd(DTNode n, void* child, size_t hash,
+                             size_t index) {
+   struct DTNode_childMap* map;
+   struct DTNode_mapEntry e;
+
+   assert(n != NULL);
+   assert(n->map != NULL);
+   assert(child != NULL);
+
+   map = n->map;
+   if(DTNode_mapReserve(n, map->size + 1) == FALSE)
+      return FALSE;
+
+   e.hash = hash;
+   e.node = child;
+   e.index = index;
+   DTNode_mapPlace(map->entries, map->capacity, &e);
+   map->size++;
+   return TRUE;
+}
+
+/* If the map slot at slot holds an entry, stores its hash in *hash
+   and returns 1; otherwise returns 0. */
+static int DTNode_mapGetHash(const void* slot, size_t* hash) {
+   const struct DTNode_mapEntry* e;
+
+   assert(slot != NULL);
+   assert(hash != NULL);
+
+   e = (const struct DTNode_mapEntry*) slot;
+
+   if(e->node == NULL)
+      return 0;
+   *hash = e->hash;
+   return 1;
+}
+
+/* Removes entry e from map, shifting back the later entries of its
+   probe sequence so that no tombstones are needed. */
+static void DTNode_mapRemove(struct DTNode_childMap* map,
+                             struct DTNode_mapEntry* e) {
+   static const struct DTNode_mapEntry empty;
+
+   assert(map != NULL);
+   assert(e != NULL);
+
+   Hash_remove(map->entries, sizeof(struct DTNode_mapEntry),
+               map->capacity, (size_t)(e - map->entries), &empty,
+               DTNode_mapGetHash);
+   map->size--;
+}
+
+/* Returns a new map over n's children, which must have spilled into
+   a DynArray or BTree, or NULL if insufficient memory is available. */
+static struct DTNode_childMap* DTNode_mapNew(DTNode n) {
+   struct DTNode_childMap* map;
+   struct DTNode_mapEntry e;
+   struct DTNode_key key;
+   struct DTNode_children* children;
+   size_t i;
+
+   assert(n != NULL);
+   assert(n->children.spilled != NULL);
+
+   children = &n->children;
+   map = DTNode_alloc(n, sizeof(struct DTNode_childMap));
+   if(map == NULL)
+      return NULL;
+
+   map->capacity = 2 * MAP_THRESHOLD;
+   while(map->capacity < 2 * DTNode_childrenLength(children))
+      map->capacity *= 2;
+   map->entries = DTNode_allocZeroed(n, map->capacity *
+                                     sizeof(struct DTNode_mapEntry));
+   if(map->entries == NULL) {
+      DTNode_release(n, map, sizeof(struct DTNode_childMap));
+      return NULL;
+   }
+
+   for(i = 0; i < DTNode_childrenLength(children); i++) {
+      e.node = DTNode_childrenGet(children, i);
+      e.index = i;
+      DTNode_childKey(e.node, &key);
+      e.hash = Hash_bytes(key.name, key.len);
+      DTNode_mapPlace(map->entries, map->capacity, &e);
+   }
+   map->size = DTNode_childrenLength(children);
+   map->isSorted = TRUE;
+   return map;
+}
+
+/* Frees map, n's map, if it is not NULL. */
+static void DTNode_mapFree(DTNode n, struct DTNode_childMap* map) {
+   if(map != NULL) {
+      DTNode_release(n, map->entries,
+                     map->capacity * sizeof(struct DTNode_mapEntry));
+      DTNode_release(n, map, sizeof(struct DTNode_childMap));
+   }
+}
+
+/* Restores sorted order to children, a directory's tagged children,
+   if map has let them fall out of order, and updates the indices
+   recorded in map. children must have spilled unless map is
+   NULL. */
+static void DTNode_mapSort(struct DTNode_children* children,
+                           struct DTNode_childMap* map) {
+   void* child;
+   size_t i;
+
+   assert(children != NULL);
+
+   if(map == NULL || map->isSorted)
+      return;
+
+   DTNode_childrenSort(children);
+
+   for(i = 0; i < DTNode_childrenLength(children); i++) {
+      child = DTNode_childrenGet(children, i);
+      DTNode_mapFindChild(map, child)->index = i;
+   }
+   map->isSorted = TRUE;
+}
+
+/* Returns the index in filter of the i-th bit for a name with hash,
+   deriving the bits by double hashing. */
+static size_t DTNode_filterBit(const struct DTNode_filter* filter,
+                               size_t hash, size_t i) {
+   size_t step;
+
+   assert(filter != NULL);
+
+   step = ((hash >> 16) ^ hash) * (size_t) 0x45d9f3bU;
+   return (hash + i * (step | 1)) & (filter->numBits - 1);
+}
+
+/* Sets the bits of a name with hash in filter. */
+static void DTNode_filterAdd(struct DTNode_filter* filter, size_t hash) {
+   size_t bit;
+   size_t i;
+
+   assert(filter != NULL);
+
+   for(i = 0; i < FILTER_HASHES; i++) {
+      bit = DTNode_filterBit(filter, hash, i);
+      filter->bits[bit / 8] |= (unsigned char)(1U << (bit % 8));
+   }
+   filter->numNames++;
+}
+
+/* Returns TRUE if a name with hash may have been added to filter, or
+   FALSE if it certainly has not been. */
+static boolean DTNode_filterMayContain(
+   const struct DTNode_filter* filter, size_t hash) {
+   size_t bit;
+   size_t i;
+
+   assert(filter != NULL);
+
+   for(i = 0; i < FILTER_HASHES; i++) {
+      bit = DTNode_filterBit(filter, hash, i);
+      if((filter->bits[bit / 8] & (1U << (bit % 8))) == 0)
+         return FALSE;
+   }
+   return TRUE;
+}
+
+/* Frees filter, n's filter, if it is not NULL. */
+static void DTNode_filterFree(DTNode n, struct DTNode_filter* filter) {
+   if(filter != NULL) {
+      DTNode_release(n, filter->bits, filter->numBits / 8);
+      DTNode_release(n, filter, sizeof(struct DTNode_filter));
+   }
+}
+
+/* Adds the names of children, a directory's tagged children, to
+   filter. */
+static void DTNode_filterAddAll(struct DTNode_filter* filter,
+                                const struct DTNode_children* children) {
+   const char* name;
+   size_t i;
+
+   assert(filter != NULL);
+   assert(children != NULL);
+
+   for(i = 0; i < DTNode_childrenLength(children); i++) {
+      name = DTNode_nameOf(DTNode_childrenGet(children, i));
+      DTNode_filterAdd(filter, Hash_bytes(name, strlen(name)));
+   }
+}
+
+/* Replaces n's filter with one over its current children, with room
+   for as many more, or with none if n has fewer than FILTER_THRESHOLD
+   children or insufficient memory is available. Lookups are correct
+   without a filter, only slower. */
+static void DTNode_filterRebuild(DTNode n) {
+   struct DTNode_filter* filter;
+   size_t length;
+
+   assert(n != NULL);
+
+   DTNode_filterFree(n, n->filter);
+   n->filter = NULL;
+
+   /* Only a directory whose children have spilled has a filter, so
+      that DTNode_destroyAll finds every filter among them. */
+   length = DTNode_childrenLength(&n->children);
+   if(!useFilters || length < FILTER_THRESHOLD ||
+      n->children.spilled == NULL)
+      return;
+
+   filter = DTNode_alloc(n, sizeof(struct DTNode_filter));
+   if(filter == NULL)
+      return;
+   filter->numBits = 8;
+   while(filter->numBits < 2 * length * FILTER_BITS_PER_NAME)
+      filter->numBits *= 2;
+   filter->bits = DTNode_allocZeroed(n, filter->numBits / 8);
+   if(filter->bits == NULL) {
+      DTNode_release(n, filter, sizeof(struct DTNode_filter));
+      return;
+   }
+   filter->numNames = 0;
+
+   DTNode_filterAddAll(filter, &n->children);
+   n->filter = filter;
+}
+
+/* Updates n's filter after the count tagged children at entries have
+   been linked to n. */
+static void DTNode_filterLinked(DTNode n, void* const* entries,
+                                size_t count) {
+   const char* name;
+   size_t i;
+
+   assert(n != NULL);
+   assert(entries != NULL);
+
+   if(!useFilters)
+      return;
+
+   if(n->filter == NULL ||
+      (n->filter->numNames + count) * FILTER_BITS_PER_NAME >
+      n->filter->numBits) {
+      DTNode_filterRebuild(n);
+      return;
+   }
+   for(i = 0; i < count; i++) {
+      name = DTNode_nameOf(entries[i]);
+      DTNode_filterAdd(n->filter, Hash_bytes(name, strlen(name)));
+   }
+}
+
+/* Updates n's filter after a child has been unlinked from n,
+   rebuilding it once the names of unlinked children outnumber those
+   of the remaining ones. */
+static void DTNode_filterUnlinked(DTNode n) {
+   size_t length;
+
+   assert(n != NULL);
+
+   if(n->filter == NULL)
+      return;
+
+   length = DTNode_childrenLength(&n->children);
+   if(n->filter->numNames > 2 * length || length < FILTER_THRESHOLD)
+      DTNode_filterRebuild(n);
+}
+
+/* Adds entry, a tagged child, to n's children. Without a map, entry
+   is inserted in sorted order at index, as found by
+   DTNode_searchChildren, and a map is built once there are more than
+   MAP_THRESHOLD children if maps are in use. With a map, entry is
+   appended.
+   Returns TRUE if successful, or FALSE if insufficient memory is
+   available. */
+static boolean DTNode_addToChildren(DTNode n, void* entry,
+                                    size_t index) {
+   struct DTNode_children* children;
+   struct DTNode_childMap* map;
+   struct DTNode_key key;
+   size_t length;
+
+   assert(n != NULL);
+   assert(entry != NULL);
+
+   children = &n->children;
+   map = n->map;
+   if(map == NULL) {
+      if(DTNode_childrenInsert(n, index, entry) == FALSE)
+         return FALSE;
+      /* If the map cannot be built, the children simply stay sorted. */
+      if(useMaps && DTNode_childrenLength(children) > MAP_THRESHOLD)
+         n->map = DTNode_mapNew(n);
+      DTNode_childrenRetier(n);
+      return TRUE;
+   }
 
-   /* the parent directory of this directory
-      NULL for the root of the directory tree */
-   DTNode parent;
+   /* With so many children, they have all spilled. */
+   length = DTNode_childrenLength(children);
+   if(DTNode_childrenInsert(n, length, entry) == FALSE)
+      return FALSE;
+   length++;
+
+   DTNode_childKey(entry, &key);
+   if(DTNode_mapAdd(n, entry, Hash_bytes(key.name, key.len),
+                    length - 1) == FALSE) {
+      DTNode_childrenRemoveAt(children, length - 1);
+      return FALSE;
+   }
 
-   /* the subdirectories of this directory
-      stored in sorted order by pathname */
-   DynArray_T DTChildren;
+   /* Appending keeps the children sorted only if entry sorts last. */
+   if(map->isSorted && length > 1 &&
+      DTNode_compareEntries(DTNode_childrenGet(children, length - 2),
+                            entry) > 0)
+      map->isSorted = FALSE;
+   DTNode_childrenRetier(n);
+   return TRUE;
+}
 
-   /* the files in this directory stored in
-      sorted order by pathname. */
-   DynArray_T fileChildren;
-};
+/* Adds the count tagged children at entries, which must be sorted by
+   name and distinct from each other and from n's children, to n's
+   children. Without a map, they are merged in sorted order, and a map
+   is built once there are more than MAP_THRESHOLD children if maps are
+   in use. With a map, they are appended.
+   Returns TRUE if successful, or FALSE, leaving n's children
+   unchanged, if insufficient memory is available. */
+static boolean DTNode_addManyToChildren(DTNode n, void** entries,
+                                        size_t count) {
+   struct DTNode_children* c;
+   struct DTNode_childMap* map;
+   struct DTNode_key key;
+   size_t length;
+   size_t i;
+
+   assert(n != NULL);
+   assert(entries != NULL);
+   assert(count > 0);
+
+   c = &n->children;
+   map = n->map;
+   length = DTNode_childrenLength(c);
+   if(map == NULL) {
+      if(c->spilled == NULL &&
+         length + count <= INLINE_CHILDREN) {
+         ChildArray_mergeHelp((const void**) c->inlined, length,
+                              (const void**) entries, count, 0);
+         c->length += count;
+         return TRUE;
+      }
+      if(c->spilled == NULL &&
+         DTNode_childrenSpill(n, length + count < 2 * INLINE_CHILDREN ?
+                              2 * INLINE_CHILDREN : length + count) == FALSE)
+         return FALSE;
+      if(DTNode_childrenAddSorted(c, entries, count) == FALSE)
+         return FALSE;
+      /* If the map cannot be built, the children simply stay sorted. */
+      if(useMaps && length + count > MAP_THRESHOLD)
+         n->map = DTNode_mapNew(n);
+      DTNode_childrenRetier(n);
+      return TRUE;
+   }
 
-/* Returns a path with contents n->path/dir
-   or NULL if there is an allocation error.
+   /* Growing the map first, so that adding to it cannot fail. */
+   if(DTNode_mapReserve(n, map->size + count) == FALSE ||
+      DTNode_childrenAppend(n, entries, count) == FALSE)
+      return FALSE;
+   for(i = 0; i < count; i++) {
+      DTNode_childKey(entries[i], &key);
+      (void) DTNode_mapAdd(n, entries[i],
+                           Hash_bytes(key.name, key.len), length + i);
+   }
 
-   Allocates memory for the returned string,
-   which is then owened by the caller. */
-static char* DTNode_buildPath(DTNode n, const char* dir) {
-   char* path;
+   /* Appending keeps the children sorted only if entries sort last. */
+   if(map->isSorted &&
+      DTNode_compareEntries(DTNode_childrenGet(c, length - 1),
+                            entries[0]) > 0)
+      map->isSorted = FALSE;
+   DTNode_childrenRetier(n);
+   return TRUE;
+}
 
-   assert(dir != NULL);
+/* Removes entry, a tagged child, from n's children. With a map, the
+   last child takes entry's place, and the map is dropped once there
+   are fewer than UNMAP_THRESHOLD children.
+   Returns TRUE if successful, or FALSE if entry is not found. */
+static boolean DTNode_removeFromChildren(DTNode n, void* entry) {
+   struct DTNode_children* c;
+   struct DTNode_childMap* map;
+   struct DTNode_mapEntry* e;
+   struct DTNode_key key;
+   void* moved;
+   size_t last;
+   size_t i;
+
+   assert(n != NULL);
+   assert(entry != NULL);
+
+   c = &n->children;
+   map = n->map;
+   if(map == NULL) {
+      DTNode_childKey(entry, &key);
+      if(DTNode_childrenSearch(c, &key, &i) == 0 ||
+         DTNode_childrenGet(c, i) != entry)
+         return FALSE;
+      DTNode_childrenRemoveAt(c, i);
+      DTNode_childrenRetier(n);
+      return TRUE;
+   }
+
+   /* With so many children, they have all spilled. */
+   e = DTNode_mapFindChild(map, entry);
+   if(e == NULL || e->node != entry)
+      return FALSE;
+   i = e->index;
+   DTNode_mapRemove(map, e);
+
+   last = DTNode_childrenLength(c) - 1;
+   if(i != last) {
+      moved = DTNode_childrenGet(c, last);
+      DTNode_childrenSet(c, i, moved);
+      DTNode_mapFindChild(map, moved)->index = i;
+      map->isSorted = FALSE;
+   }
+   DTNode_childrenRemoveAt(c, last);
+   DTNode_childrenRetier(n);
+
+   /* Once a large directory has been mostly emptied, its map and the
+      room left in its DynArray from when it was full go too. */
+   if(DTNode_childrenLength(c) < UNMAP_THRESHOLD) {
+      DTNode_mapSort(c, map);
+      DTNode_mapFree(n, map);
+      n->map = NULL;
+      if(DTNode_childrenArray(c) != NULL)
+         ChildArray_shrinkToFit(c->spilled);
+   }
+   return TRUE;
+}
+
+/* Searches n's children for one whose final path component is sought
+   by key, using n's map if it has one. Returns 1 if there is such a
+   child, storing its index in *pIndex, and 0 otherwise, storing the
+   index at which such a child would be added in *pIndex. */
+static int DTNode_searchChildren(DTNode n, const struct DTNode_key* key,
+                                 size_t* pIndex) {
+   struct DTNode_mapEntry* e;
+
+   assert(n != NULL);
+   assert(key != NULL);
+   assert(pIndex != NULL);
+
+   if(n->map == NULL)
+      return DTNode_childrenSearch(&n->children, key, pIndex);
+
+   e = DTNode_mapFind(n->map, key, Hash_bytes(key->name, key->len));
+   if(e == NULL) {
+      /* A new child is appended when a map is in use. */
+      *pIndex = DTNode_childrenLength(&n->children);
+      return 0;
+   }
+   *pIndex = e->index;
+   return 1;
+}
+
+/* Frees the memory of n itself, returning it to the slab, the pool of
+   larger nodes or the arena if it was allocated from there. */
+static void DTNode_free(DTNode n) {
+   assert(n != NULL);
+
+   DTNode_discharge(n, MEMORY_NODES, sizeof(struct DTNode));
+   if(n->arena != NULL || names == NULL)
+      DTNode_discharge(n, MEMORY_NAMES, strlen(n->name) + 1);
+
+   if(n->source == FROM_ARENA) {
+      n->arena->numNodes--;
+      Arena_release(n->arena->memory, n,
+                    sizeof(struct DTNode) + strlen(n->name) + 1);
+      return;
+   }
 
-   if(n == NULL)
-      path = malloc(strlen(dir)+1);
+   if(names != NULL)
+      Intern_release(names, n->name);
+
+   if(n->source == FROM_SLAB)
+      Slab_release(slab, n);
+   else if(n->source == FROM_OVERFLOW)
+      Arena_release(overflow, n, sizeof(struct DTNode) +
+                    (names == NULL ? strlen(n->name) + 1 : 0));
    else
-      path = malloc(strlen(n->path) + 1 + strlen(dir) + 1);
+      free(n);
+}
 
-   if(path == NULL)
-      return NULL;
-   *path = '\0';
+/* DTNode.h contains specification. */
+void DTNode_useSlabs(boolean enable) {
+   if(slab != NULL) {
+      Slab_free(slab);
+      slab = NULL;
+   }
+   if(overflow != NULL) {
+      Arena_free(overflow);
+      overflow = NULL;
+   }
+   if(spilledDirs != NULL) {
+      DynArray_free(spilledDirs);
+      spilledDirs = NULL;
+   }
+   if(arenas != NULL) {
+      DynArray_free(arenas);
+      arenas = NULL;
+   }
+   useSlabs = enable;
+}
+
+/* DTNode.h contains specification. */
+void DTNode_useNames(Intern_T pool) {
+   /* The size of the nodes in the slab depends on whether they hold
+      their names. */
+   DTNode_useSlabs(useSlabs);
+   names = pool;
+}
 
-   if(n != NULL) {
-      strcpy(path, n->path);
-      strcat(path, "/");
+/* Sets the fields of new, a node whose name of len characters is
+   set, for a directory without children beneath parent. */
+static void DTNode_initFields(DTNode new, size_t len, DTNode parent) {
+   assert(new != NULL);
+
+   new->pathLen = len;
+   if(parent != NULL) {
+      new->pathLen += parent->pathLen + 1;
+   }
+
+   new->parent = parent;
+   new->map = NULL;
+   new->filter = NULL;
+
+   /* The children are held inline until there are more of them. */
+   new->children.length = 0;
+   new->children.spilled = NULL;
+   new->children.searches = 0;
+}
+
+/* Returns a new DTNode, as DTNode_create does, allocated from arena
+   together with its own copy of its name, unless name, the pooled
+   copy of its name, is not NULL. */
+static DTNode DTNode_createIn(struct DTNode_arena* arena,
+                              const char* dir, size_t len,
+                              DTNode parent, const char* name) {
+   DTNode new;
+   char* copy;
+
+   assert(arena != NULL);
+   assert(dir != NULL);
+
+   new = Arena_alloc(arena->memory, sizeof(struct DTNode) +
+                     (name == NULL ? len + 1 : 0));
+   if(new == NULL)
+      return NULL;
+   arena->numNodes++;
+
+   /* A pooled name is charged to the pool, not to the arena. */
+   new->arena = arena;
+   if(name == NULL) {
+      copy = (char*)(new + 1);
+      memcpy(copy, dir, len);
+      copy[len] = '\0';
+      name = copy;
+      DTNode_charge(new, MEMORY_NAMES, len + 1);
    }
-   strcat(path, dir);
+   new->name = name;
+   new->source = FROM_ARENA;
+   DTNode_charge(new, MEMORY_NODES, sizeof(struct DTNode));
 
-   return path;
+   DTNode_initFields(new, len, parent);
+   return new;
 }
 
 /* DTNode.h contains specification. */
-DTNode DTNode_create(const char* dir, DTNode parent){
+DTNode DTNode_create(const char* dir, size_t len, DTNode parent){
 
    DTNode new;
+   const char* name = NULL;
+   char* copy;
 
    assert(dir != NULL);
 
-   new = malloc(sizeof(struct DTNode));
+   if(parent != NULL && parent->arena != NULL)
+      return DTNode_createIn(parent->arena, dir, len, parent, NULL);
+
+   if(names != NULL) {
+      name = Intern_add(names, dir, len);
+      if(name == NULL)
+         return NULL;
+   }
+
+   new = NULL;
+   if(useSlabs && (name != NULL || len < SLAB_NAME_SIZE)) {
+      if(slab == NULL)
+         slab = Slab_new(sizeof(struct DTNode) +
+                         (names == NULL ? SLAB_NAME_SIZE : 0));
+      if(slab != NULL)
+         new = Slab_alloc(slab);
+   }
+   if(new != NULL) {
+      new->source = FROM_SLAB;
+   }
+   else if(useSlabs) {
+      /* Nodes too large for the slab are freed in bulk with it all
+         the same. */
+      if(overflow == NULL)
+         overflow = Arena_new();
+      if(overflow != NULL)
+         new = Arena_alloc(overflow, sizeof(struct DTNode) +
+                           (name == NULL ? len + 1 : 0));
+      if(new != NULL)
+         new->source = FROM_OVERFLOW;
+   }
+   else {
+      new = malloc(sizeof(struct DTNode) +
+                   (name == NULL ? len + 1 : 0));
+      if(new != NULL)
+         new->source = FROM_MALLOC;
+   }
 
    /* In case there is insufficient memory for the new DTNode. */
    if(new == NULL) {
+      if(name != NULL)
+         Intern_release(names, name);
       return NULL;
    }
 
-   new->path = DTNode_buildPath(parent, dir);
+   if(name == NULL) {
+      copy = (char*)(new + 1);
+      memcpy(copy, dir, len);
+      copy[len] = '\0';
+      name = copy;
+   }
+   new->name = name;
+   new->arena = NULL;
+   DTNode_charge(new, MEMORY_NODES, sizeof(struct DTNode));
+   if(names == NULL)
+      DTNode_charge(new, MEMORY_NAMES, len + 1);
 
-   /* In case there is insufficient memory for the new DTNode's path. */
-   if(new->path == NULL) {
-      free(new);
-      return NULL;
+   DTNode_initFields(new, len, parent);
+   return new;
+}
+
+/* Adds arena, while slabs are in use, to the arenas that
+   DTNode_destroyAll frees. Returns TRUE if successful, or FALSE if
+   insufficient memory is available. */
+static boolean DTNode_arenaRegister(struct DTNode_arena* arena) {
+   assert(arena != NULL);
+
+   if(!useSlabs)
+      return TRUE;
+   if(arenas == NULL)
+      arenas = DynArray_new(0);
+   if(arenas == NULL)
+      return FALSE;
+   arena->slot = DynArray_getLength(arenas);
+   return DynArray_add(arenas, arena);
+}
+
+/* Removes arena from the arenas to which DTNode_arenaRegister added
+   it, if any. */
+static void DTNode_arenaUnregister(struct DTNode_arena* arena) {
+   struct DTNode_arena* moved;
+   size_t last;
+
+   assert(arena != NULL);
+
+   if(!useSlabs)
+      return;
+   last = DynArray_getLength(arenas) - 1;
+   moved = DynArray_get(arenas, last);
+   (void) DynArray_set(arenas, arena->slot, moved);
+   moved->slot = arena->slot;
+   (void) DynArray_removeAt(arenas, last);
+}
+
+/* DTNode.h contains specification. */
+DTNode DTNode_createArena(const char* dir, size_t len, DTNode parent) {
+   struct DTNode_arena* arena;
+   Arena_T memory;
+   DTNode new;
+   const char* name = NULL;
+   size_t k;
+
+   assert(dir != NULL);
+
+   /* A subtree in an arena is freed with it, arenas and all. */
+   if(parent != NULL && parent->arena != NULL)
+      return DTNode_create(dir, len, parent);
+
+   /* The new node's own name is pooled all the same, as its parent
+      finds its children by their pooled names. */
+   if(names != NULL) {
+      name = Intern_add(names, dir, len);
+      if(name == NULL)
+         return NULL;
    }
 
-   new->parent = parent;
+   new = NULL;
+   memory = Arena_new();
+   if(memory != NULL) {
+      arena = Arena_alloc(memory, sizeof(struct DTNode_arena));
+      if(arena != NULL) {
+         arena->memory = memory;
+         arena->numNodes = 0;
+         for(k = 0; k < NUM_MEMORY_KINDS; k++)
+            arena->charged[k] = 0;
+         arena->spilled = DynArray_new(0);
+         if(arena->spilled != NULL) {
+            if(DTNode_arenaRegister(arena)) {
+               new = DTNode_createIn(arena, dir, len, parent, name);
+               if(new == NULL)
+                  DTNode_arenaUnregister(arena);
+            }
+            if(new == NULL)
+               DynArray_free(arena->spilled);
+         }
+      }
+      if(new == NULL)
+         Arena_free(memory);
+   }
 
-   /* Allocating memory to hold the directories which are children
-      to a given DTNode. */
-   new->DTChildren = DynArray_new(0);
-   if(new->DTChildren == NULL) {
-      free(new->path);
-      free(new);
+   /* In case there is insufficient memory for the new DTNode. */
+   if(new == NULL) {
+      if(name != NULL)
+         Intern_release(names, name);
       return NULL;
    }
+   return new;
+}
 
-   /* Allocating memory to hold the files which are children
-      to a given DTNode. */
-   new->fileChildren = DynArray_new(0);
-   if(new->fileChildren == NULL) {
-      free(new->path);
-      free(new->DTChildren);
-      free(new);
-      return NULL;
+/* Frees arena, the spilled children of its directories, and every
+   node allocated from it, without visiting the nodes. */
+static void DTNode_arenaFree(struct DTNode_arena* arena) {
+   DTNode dir;
+   size_t i;
+
+   assert(arena != NULL);
+
+   for(i = 0; i < DynArray_getLength(arena->spilled); i++) {
+      dir = DynArray_get(arena->spilled, i);
+      DTNode_childrenFree(&dir->children);
    }
+   DynArray_free(arena->spilled);
+   Arena_free(arena->memory);
+}
 
-   return new;
+/* Frees the arena of n, the root of its subtree, and with it every
+   node allocated from it, without visiting the nodes. Returns the
+   number of nodes freed. */
+static size_t DTNode_freeArena(DTNode n) {
+   struct DTNode_arena* arena;
+   size_t count;
+   size_t k;
+
+   assert(n != NULL);
+   assert(n->arena != NULL);
+
+   arena = n->arena;
+   if(names != NULL)
+      Intern_release(names, n->name);
+
+   DTNode_arenaUnregister(arena);
+   for(k = 0; k < NUM_MEMORY_KINDS; k++)
+      charged[k] -= arena->charged[k];
+   count = arena->numNodes;
+   DTNode_arenaFree(arena);
+   return count;
 }
 
 /* DTNode.h contains specification. */
 size_t DTNode_destroy(DTNode n) {
    size_t i;
    size_t count = 0;
-   DTNode dChild;
-   FileNode fChild;
+   void* entry;
 
    assert(n != NULL);
 
-   /* Recursively removing directory children. */
-   for(i = 0; i < DynArray_getLength(n->DTChildren); i++)
-   {
-      dChild = DynArray_get(n->DTChildren, i);
-      count += DTNode_destroy(dChild);
-   }
+   /* The root of an arena's subtree takes the whole arena with it. */
+   if(n->arena != NULL &&
+      (n->parent == NULL || n->parent->arena != n->arena))
+      return DTNode_freeArena(n);
 
-   /* Removing all file children. */
-   for(i = 0; i < DynArray_getLength(n->fileChildren); i++)
+   /* Removing all file children, and directory children recursively. */
+   for(i = 0; i < DTNode_childrenLength(&n->children); i++)
    {
-      fChild = DynArray_get(n->fileChildren, i);
-      FileNode_destroy(fChild);
-      count++;
+      entry = DTNode_childrenGet(&n->children, i);
+      if(DTNode_isFile(entry)) {
+         FileNode_destroy(DTNode_untag(entry));
+         count++;
+      }
+      else
+         count += DTNode_destroy(entry);
    }
 
-   DynArray_free(n->DTChildren);
-   DynArray_free(n->fileChildren);
+   if(n->children.spilled != NULL) {
+      DTNode_childrenUnregister(n);
+      DTNode_childrenFree(&n->children);
+   }
+   DTNode_mapFree(n, n->map);
+   DTNode_filterFree(n, n->filter);
 
-   free(n->path);
-   free(n);
+   DTNode_free(n);
    count++;
 
    return count;
 }
 
+/* DTNode.h contains specification. */
+void DTNode_destroyAll(void) {
+   DTNode dir;
+   size_t i;
+   size_t k;
+
+   assert(useSlabs);
+
+   if(spilledDirs != NULL) {
+      for(i = 0; i < DynArray_getLength(spilledDirs); i++) {
+         dir = DynArray_get(spilledDirs, i);
+         DTNode_childrenFree(&dir->children);
+         DTNode_mapFree(dir, dir->map);
+         DTNode_filterFree(dir, dir->filter);
+      }
+   }
+   if(arenas != NULL) {
+      for(i = 0; i < DynArray_getLength(arenas); i++)
+         DTNode_arenaFree(DynArray_get(arenas, i));
+   }
+
+   /* Every node and everything charged to them goes at once. */
+   for(k = 0; k < NUM_MEMORY_KINDS; k++)
+      charged[k] = 0;
+   DTNode_useSlabs(useSlabs);
+}
+
+/* DTNode.h contains specification. */
+boolean DTNode_isInArena(DTNode n) {
+   assert(n != NULL);
+   return n->arena != NULL;
+}
+
+/* DTNode.h contains specification. */
+void* DTNode_allocInArena(DTNode n, size_t size) {
+   void* node;
+
+   assert(n != NULL);
+   assert(n->arena != NULL);
+
+   node = Arena_alloc(n->arena->memory, size);
+   if(node != NULL)
+      n->arena->numNodes++;
+   return node;
+}
+
+/* DTNode.h contains specification. */
+void DTNode_releaseInArena(DTNode n, void* node, size_t size) {
+   assert(n != NULL);
+   assert(n->arena != NULL);
+   assert(node != NULL);
+
+   n->arena->numNodes--;
+   Arena_release(n->arena->memory, node, size);
+}
+
+/* DTNode.h contains specification. */
+Arena_T DTNode_getArena(DTNode n) {
+   assert(n != NULL);
+
+   if(n->arena == NULL)
+      return NULL;
+   return n->arena->memory;
+}
+
+/* DTNode.h contains specification. */
+void DTNode_charge(DTNode n, enum DTNode_memory kind, size_t size) {
+   charged[kind] += size;
+   if(n != NULL && n->arena != NULL)
+      n->arena->charged[kind] += size;
+}
+
+/* DTNode.h contains specification. */
+void DTNode_discharge(DTNode n, enum DTNode_memory kind, size_t size) {
+   assert(charged[kind] >= size);
+
+   charged[kind] -= size;
+   if(n != NULL && n->arena != NULL)
+      n->arena->charged[kind] -= size;
+}
+
+/* DTNode.h contains specification. */
+void DTNode_getMemory(size_t tally[NUM_MEMORY_KINDS]) {
+   size_t k;
+
+   assert(tally != NULL);
+
+   for(k = 0; k < NUM_MEMORY_KINDS; k++)
+      tally[k] = charged[k];
+}
+
 /* DTNode.h contains specification. */
 int DTNode_compare(DTNode node1, DTNode node2) {
    assert(node1 != NULL);
    assert(node2 != NULL);
-   return strcmp(node1->path, node2->path);
+   return strcmp(node1->name, node2->name);
+}
+
+/* DTNode.h contains specification. */
+const char* DTNode_getName(DTNode n) {
+   assert(n != NULL);
+   return n->name;
+}
+
+/* DTNode.h contains specification. */
+size_t DTNode_getPathLength(DTNode n) {
+   assert(n != NULL);
+   return n->pathLen;
+}
+
+/* DTNode.h contains specification. */
+char* DTNode_writePath(DTNode n, char* buf) {
+   size_t end;
+   size_t len;
+
+   assert(n != NULL);
+   assert(buf != NULL);
+
+   /* Filling buf from the end, one ancestor's name at a time. */
+   end = n->pathLen;
+   buf[end] = '\0';
+   while(n != NULL) {
+      len = strlen(n->name);
+      end -= len;
+      memcpy(buf + end, n->name, len);
+      if(n->parent != NULL)
+         buf[--end] = '/';
+      n = n->parent;
+   }
+   return buf;
+}
+
+/* DTNode.h contains specification. */
+boolean DTNode_isPathPrefix(DTNode n, const char* path) {
+   size_t end;
+   size_t len;
+   size_t i;
+
+   assert(n != NULL);
+   assert(path != NULL);
+
+   /* Checking that path is long enough without reading past it. */
+   for(i = 0; i < n->pathLen; i++) {
+      if(path[i] == '\0')
+         return FALSE;
+   }
+   if(path[n->pathLen] != '\0' && path[n->pathLen] != '/')
+      return FALSE;
+
+   /* Matching names from the end, one ancestor at a time. */
+   end = n->pathLen;
+   while(n != NULL) {
+      len = strlen(n->name);
+      end -= len;
+      if(strncmp(path + end, n->name, len))
+         return FALSE;
+      if(n->parent != NULL && path[--end] != '/')
+         return FALSE;
+      n = n->parent;
+   }
+   return TRUE;
 }
 
 /* DTNode.h contains specification. */
-const char* DTNode_getPath(DTNode n) {
+boolean DTNode_hasPath(DTNode n, const char* path) {
    assert(n != NULL);
-   return n->path;
+   assert(path != NULL);
+
+   return DTNode_isPathPrefix(n, path) && path[n->pathLen] == '\0';
 }
 
 /* DTNode.h contains specification. */
-size_t DTNode_getNumDTChildren(DTNode n) {
+size_t DTNode_getNumChildren(DTNode n) {
    assert(n != NULL);
-   return DynArray_getLength(n->DTChildren);
+   return DTNode_childrenLength(&n->children);
 }
 
-size_t DTNode_getNumFileChildren(DTNode n) {
+/* Returns the final component of path if path is n's path + / +
+   component, or NULL otherwise. */
+static const char* DTNode_childComponent(DTNode n, const char* path) {
+   const char* rest;
+
    assert(n != NULL);
-   return DynArray_getLength(n->fileChildren);
+   assert(path != NULL);
+
+   if(!DTNode_isPathPrefix(n, path) || path[n->pathLen] != '/')
+      return NULL;
+   rest = path + n->pathLen + 1;
+   if(strstr(rest, "/") != NULL)
+      return NULL;
+   return rest;
 }
 
 /* DTNode.h contains specification. */
 int DTNode_hasChild(DTNode n, const char* path, size_t* childID) {
+   struct DTNode_key key;
    size_t index;
    int result;
-   DTNode checker;
-   FileNode fileChecker;
 
    assert(n != NULL);
    assert(path != NULL);
 
-   /* Checking if there is a directory node child with childID. */
-   checker = DTNode_create(path, NULL);
-   if(checker == NULL) {
-      return -1;
+   /* In case path is not n's path + / + component. */
+   key.name = DTNode_childComponent(n, path);
+   if(key.name == NULL) {
+      if(childID != NULL)
+         *childID = 0;
+      return 0;
    }
-   result = DynArray_bsearch(n->DTChildren, checker, &index,
-                             (int (*)(const void*, const void*)) DTNode_compare);
-   (void) DTNode_destroy(checker);
+   key.len = strlen(key.name);
 
-   /* Checking if there is a file node child with childID. */
-   if (result != 1) {
-      fileChecker = FileNode_create(path, NULL, NULL, 0);
-      if(fileChecker == NULL) {
-         return -1;
-      }
-
-      result = DynArray_bsearch(n->fileChildren, fileChecker, &index,
-                                (int (*)(const void*, const void*)) FileNode_compare);
-      (void) FileNode_destroy(fileChecker);
-   }
+   /* Identifiers are only meaningful here in sorted order. */
+   DTNode_sortChildren(n);
+   result = DTNode_childrenSearch(&n->children, &key, &index);
 
    if(childID != NULL)
       *childID = index;
@@ -199,26 +1913,92 @@ int DTNode_hasChild(DTNode n, const char* path, size_t* childID) {
 }
 
 /* DTNode.h contains specification. */
-DTNode DTNode_getChild(DTNode n, size_t childID, boolean type) {
+int DTNode_findChild(DTNode n, const char* name, size_t len,
+                     boolean* pType, size_t* childID) {
+   struct DTNode_key key;
+   size_t index;
+
    assert(n != NULL);
+   assert(name != NULL);
+   assert(pType != NULL);
+
+   /* No child can have a name that no node has, and the pooled copy
+      of any other compares equal to the child's by address. Names in
+      an arena are not pooled. */
+   if(names != NULL && n->arena == NULL) {
+      name = Intern_find(names, name, len);
+      if(name == NULL)
+         return 0;
+   }
 
-   /* If child to be retrieved is a directory. */
-   if (!type) {
-      if (DynArray_getLength(n->DTChildren) > childID) {
-         /* Returning DTNode child if found. */
-         return DynArray_get(n->DTChildren, childID);
-      } else {
-         return NULL;
+   if(n->filter != NULL) {
+      filterProbes++;
+      if(!DTNode_filterMayContain(n->filter,
+                                  Hash_bytes(name, len))) {
+         filterRejects++;
+         return 0;
       }
    }
 
-   /* If child to be retrieved is a file. */
-   if (DynArray_getLength(n->fileChildren) > childID){
-      /* Returning FileNode child if found. */
-      return (DTNode) DynArray_get(n->fileChildren, childID);
-   } else {
-      return NULL;
+   key.name = name;
+   key.len = len;
+   if(!DTNode_searchChildren(n, &key, &index)) {
+      if(n->filter != NULL)
+         filterFalsePositives++;
+      return 0;
    }
+
+   *pType = DTNode_isFile(DTNode_childrenGet(&n->children, index));
+   if(childID != NULL)
+      *childID = index;
+   return 1;
+}
+
+/* DTNode.h contains specification. */
+void DTNode_useFilters(boolean enable) {
+   useFilters = enable;
+   filterProbes = 0;
+   filterRejects = 0;
+   filterFalsePositives = 0;
+}
+
+/* DTNode.h contains specification. */
+void DTNode_useMaps(boolean enable) {
+   useMaps = enable;
+}
+
+/* DTNode.h contains specification. */
+void DTNode_getFilterStats(size_t* pProbes, size_t* pRejects,
+                           size_t* pFalsePositives) {
+   assert(pProbes != NULL);
+   assert(pRejects != NULL);
+   assert(pFalsePositives != NULL);
+
+   *pProbes = filterProbes;
+   *pRejects = filterRejects;
+   *pFalsePositives = filterFalsePositives;
+}
+
+/* DTNode.h contains specification. */
+void DTNode_sortChildren(DTNode n) {
+   assert(n != NULL);
+
+   DTNode_mapSort(&n->children, n->map);
+}
+
+/* DTNode.h contains specification. */
+DTNode DTNode_getChild(DTNode n, size_t childID, boolean* pType) {
+   void* entry;
+
+   assert(n != NULL);
+
+   if(DTNode_childrenLength(&n->children) <= childID)
+      return NULL;
+
+   entry = DTNode_childrenGet(&n->children, childID);
+   if(pType != NULL)
+      *pType = DTNode_isFile(entry);
+   return DTNode_untag(entry);
 }
 
 /* DTNode.h contains specification. */
@@ -229,103 +2009,139 @@ DTNode DTNode_getParent(DTNode n) {
 
 /* DTNode.h contains specification. */
 int DTNode_linkChildDirectory(DTNode parent, DTNode child) {
+   struct DTNode_key key;
+   void* entry;
    size_t i;
-   char* rest;
 
    assert(parent != NULL);
    assert(child != NULL);
 
-   /* If child is already in the tree. */
-   if(DTNode_hasChild(parent, child->path, NULL))
-      return ALREADY_IN_TREE;
-   i = strlen(parent->path);
-
    /* In case child's path is not parent's path + / + directory. */
-   if(strncmp(child->path, parent->path, i))
-      return PARENT_CHILD_ERROR;
-   rest = child->path + i;
-   if(strlen(child->path) >= i && rest[0] != '/')
-      return PARENT_CHILD_ERROR;
-   rest++;
-   if(strstr(rest, "/") != NULL)
+   if(child->parent != parent || strchr(child->name, '/') != NULL)
       return PARENT_CHILD_ERROR;
 
-   child->parent = parent;
-
-   /* In case DTNode child is already present in DTNode parent's children. */
-   if(DynArray_bsearch(parent->DTChildren, child, &i,
-                       (int (*)(const void*, const void*)) DTNode_compare) == 1)
+   /* If child is already in the tree, as a file or directory. */
+   DTNode_childKey(child, &key);
+   if(DTNode_searchChildren(parent, &key, &i))
       return ALREADY_IN_TREE;
 
-   if(DynArray_addAt(parent->DTChildren, i, child) == TRUE)
-      return SUCCESS;
-   else
+   entry = child;
+   if(DTNode_addToChildren(parent, entry, i) == FALSE)
       return PARENT_CHILD_ERROR;
+   DTNode_filterLinked(parent, &entry, 1);
+   return SUCCESS;
 }
 
 /* DTNode.h contains specification. */
 int DTNode_linkChildFile(DTNode parent, FileNode child) {
+   struct DTNode_key key;
+   const char* name;
+   void* entry;
    size_t i;
-   char* rest;
 
    assert(parent != NULL);
    assert(child != NULL);
 
-   /* If child is already in the tree. */
-   if(DTNode_hasChild(parent, FileNode_getPath(child), NULL))
+   /* In case child's path is not parent's path + / + file. */
+   name = FileNode_getName(child);
+   if(FileNode_getParent(child) != parent || strchr(name, '/') != NULL)
+      return PARENT_CHILD_ERROR;
+
+   /* If child is already in the tree, as a directory or file. */
+   entry = DTNode_tag(child, TRUE);
+   DTNode_childKey(entry, &key);
+   if(DTNode_searchChildren(parent, &key, &i))
       return ALREADY_IN_TREE;
-   i = strlen(parent->path);
 
-   /* In case child's path is not parent's path + / + directory. */
-   if(strncmp(FileNode_getPath(child), parent->path, i))
-      return PARENT_CHILD_ERROR;
-   rest = FileNode_getPath(child)+ i;
-   if(strlen(FileNode_getPath(child)) >= i && rest[0] != '/')
-      return PARENT_CHILD_ERROR;
-   rest++;
-   if(strstr(rest, "/") != NULL)
+   if(DTNode_addToChildren(parent, entry, i) == FALSE)
       return PARENT_CHILD_ERROR;
+   DTNode_filterLinked(parent, &entry, 1);
+   return SUCCESS;
+}
 
-   (void) FileNode_setParent(child, parent);
+/* DTNode.h contains specification. */
+int DTNode_linkChildren(DTNode parent, void* children[],
+                        const boolean types[], size_t count) {
+   struct DTNode_key key;
+   void** entries;
+   const char* name;
+   DTNode childParent;
+   boolean isSorted;
+   size_t index;
+   int result;
+   size_t i;
 
-   /* In case FileNode child is already present in DTNode parent's children. */
-   if(DynArray_bsearch(parent->fileChildren, child, &i,
-                       (int (*)(const void*, const void*)) FileNode_compare) == 1)
-      return ALREADY_IN_TREE;
+   assert(parent != NULL);
+   assert(children != NULL || count == 0);
+   assert(types != NULL || count == 0);
 
-   if(DynArray_addAt(parent->fileChildren, i, child) == TRUE)
+   if(count == 0)
       return SUCCESS;
-   else
-      return PARENT_CHILD_ERROR;
+
+   entries = malloc(count * sizeof(void*));
+   if(entries == NULL)
+      return MEMORY_ERROR;
+
+   /* In case a child's path is not parent's path + / + name. */
+   isSorted = TRUE;
+   for(i = 0; i < count; i++) {
+      assert(children[i] != NULL);
+      entries[i] = DTNode_tag(children[i], types[i]);
+      if(types[i])
+         childParent = FileNode_getParent((FileNode) children[i]);
+      else
+         childParent = ((DTNode) children[i])->parent;
+      name = DTNode_nameOf(entries[i]);
+      if(childParent != parent || strchr(name, '/') != NULL) {
+         free(entries);
+         return PARENT_CHILD_ERROR;
+      }
+      if(i > 0 && DTNode_compareEntries(entries[i - 1], entries[i]) > 0)
+         isSorted = FALSE;
+   }
+
+   /* Entries restored from a listing usually arrive sorted already. */
+   if(!isSorted)
+      ChildArray_sortHelp((const void**) entries, count, 0);
+
+   /* If a child is already in the tree, or given twice. */
+   result = SUCCESS;
+   for(i = 0; i < count && result == SUCCESS; i++) {
+      DTNode_childKey(entries[i], &key);
+      if((i > 0 && DTNode_compareEntries(entries[i - 1], entries[i]) == 0)
+         || DTNode_searchChildren(parent, &key, &index))
+         result = ALREADY_IN_TREE;
+   }
+
+   if(result == SUCCESS) {
+      if(DTNode_addManyToChildren(parent, entries, count) == FALSE)
+         result = MEMORY_ERROR;
+      else
+         DTNode_filterLinked(parent, entries, count);
+   }
+   free(entries);
+   return result;
 }
 
 /* DTNode.h contains specification. */
 int  DTNode_unlinkChildDirectory(DTNode parent, DTNode child) {
-   size_t i;
-
    assert(parent != NULL);
    assert(child != NULL);
 
-   if(DynArray_bsearch(parent->DTChildren, child, &i,
-                       (int (*)(const void*, const void*)) DTNode_compare) == 0)
+   if(DTNode_removeFromChildren(parent, child) == FALSE)
       return PARENT_CHILD_ERROR;
-
-   (void) DynArray_removeAt(parent->DTChildren, i);
+   DTNode_filterUnlinked(parent);
    return SUCCESS;
 }
 
 /* DTNode.h contains specification. */
 int  DTNode_unlinkChildFile(DTNode parent, FileNode child) {
-   size_t i;
-
    assert(parent != NULL);
    assert(child != NULL);
 
-   if(DynArray_bsearch(parent->fileChildren, child, &i,
-                       (int (*)(const void*, const void*)) FileNode_compare) == 0)
+   if(DTNode_removeFromChildren(parent, DTNode_tag(child, TRUE)) == FALSE)
       return PARENT_CHILD_ERROR;
-
-   (void) DynArray_removeAt(parent->fileChildren, i);
+   DTNode_filterUnlinked(parent);
    return SUCCESS;
 }
 
@@ -337,7 +2153,7 @@ int DTNode_addChildDir(DTNode parent, const char* dir) {
    assert(parent != NULL);
    assert(dir != NULL);
 
-   new = DTNode_create(dir, parent);
+   new = DTNode_create(dir, strlen(dir), parent);
    if(new == NULL)
       return PARENT_CHILD_ERROR;
 
@@ -356,7 +2172,7 @@ int DTNode_addChildFile(DTNode parent, const char* file,
    assert(parent != NULL);
    assert(file != NULL);
 
-   new = FileNode_create(file, parent, contents, length);
+   new = FileNode_create(file, strlen(file), parent, contents, length);
    if(new == NULL)
       return PARENT_CHILD_ERROR;
 
@@ -373,9 +2189,9 @@ char* DTNode_toString(DTNode n) {
 
    assert(n != NULL);
 
-   copyPath = malloc(strlen(n->path)+1);
+   copyPath = malloc(n->pathLen + 1);
    if(copyPath == NULL)
       return NULL;
    else
-      return strcpy(copyPath, n->path);
+      return DTNode_writePath(n, copyPath);
 }
@@ -8,53 +8,176 @@
 
 #include <stddef.h>
 #include "a4def.h"
+#include "intern.h"
+#include "arena.h"
 #include "FTNode.h"
 
 /*--------------------------------------------------------------------*/
 
-/* A DTNode is an object that contains a path payload and references to
-   the DTNode's parent (if it exists) and children (if they exist). */
+/* A DTNode is an object that contains a name payload, the final
+   component of its path, and references to the DTNode's parent (if it
+   exists) and children (if they exist). Its full path is rebuilt from
+   its ancestors on demand. */
 
-/* Given a parent DTNode and a directory string dir, returns a new
-   DTNode structure or NULL if any allocation error occurs in creating
-   the node or its fields. */
+/* Given a parent DTNode and the first len characters of a directory
+   string dir, returns a new DTNode structure or NULL if any allocation
+   error occurs in creating the node or its fields. dir need not be
+   nul-terminated after those len characters. */
 
 /*--------------------------------------------------------------------*/
 
-DTNode DTNode_create(const char* dir, DTNode parent);
+DTNode DTNode_create(const char* dir, size_t len, DTNode parent);
+
+/*--------------------------------------------------------------------*/
+
+/* Returns a new DTNode, as DTNode_create does, allocated from a new
+   arena from which every node later created beneath it is allocated
+   too, so that destroying it frees the whole subtree at once instead
+   of node by node. If parent is already in an arena, the new DTNode
+   is simply part of that arena's subtree. */
+DTNode DTNode_createArena(const char* dir, size_t len, DTNode parent);
+
+/*--------------------------------------------------------------------*/
+
+/* Returns TRUE if n was allocated from an arena, and FALSE
+   otherwise. Every node created beneath such a node must be allocated
+   from its arena by DTNode_allocInArena. */
+boolean DTNode_isInArena(DTNode n);
+
+/*--------------------------------------------------------------------*/
+
+/* Allocates size bytes, for a node to be created beneath n, from n's
+   arena, counting the node among the arena's, or returns NULL if
+   insufficient memory is available. n must be in an arena. */
+void* DTNode_allocInArena(DTNode n, size_t size);
+
+/*--------------------------------------------------------------------*/
+
+/* Releases node, allocated by DTNode_allocInArena(n, size), to n's
+   arena, which no longer counts it. Nodes that are still in the arena
+   when its subtree is destroyed need not be released. */
+void DTNode_releaseInArena(DTNode n, void* node, size_t size);
+
+/*--------------------------------------------------------------------*/
+
+/* Returns the arena of n's subtree, from which memory owned by the
+   nodes beneath n other than the nodes themselves may be allocated
+   too, to be freed with the arena, or NULL if n is not in an arena. */
+Arena_T DTNode_getArena(DTNode n);
+
+/*--------------------------------------------------------------------*/
+
+/* The kinds of memory held by the nodes of a tree, as tallied by
+   DTNode_charge: the node structs, the names that nodes hold copies
+   of, the hash maps and Bloom filters that locate children, and the
+   copies of contents that files hold. Tallied the same way, though
+   not memory as such, are the lengths of the contents of which files
+   hold copies, shared ones counted once per file, and the lengths of
+   those copies that are not shared. */
+enum DTNode_memory {
+   MEMORY_NODES, MEMORY_NAMES, MEMORY_LOOKUP, MEMORY_CONTENTS,
+   MEMORY_COPIED_LENGTHS, MEMORY_UNSHARED_LENGTHS,
+   NUM_MEMORY_KINDS
+};
+
+/* Counts size more bytes of memory of the given kind as held on
+   behalf of a node beneath or at n, or of a node with no parent if n
+   is NULL. Memory charged to a node in an arena is discounted when
+   the arena is freed, so its nodes need not be discharged. */
+void DTNode_charge(DTNode n, enum DTNode_memory kind, size_t size);
+
+/*--------------------------------------------------------------------*/
+
+/* Counts size fewer bytes of memory of the given kind, charged to n
+   by DTNode_charge, as held. */
+void DTNode_discharge(DTNode n, enum DTNode_memory kind, size_t size);
+
+/*--------------------------------------------------------------------*/
+
+/* Stores in tally[kind] the number of bytes of each kind of memory
+   currently charged, not counting the overhead of the allocators. */
+void DTNode_getMemory(size_t tally[NUM_MEMORY_KINDS]);
+
+/*--------------------------------------------------------------------*/
+
+/* Sets whether DTNodes with short names are allocated from a slab of
+   fixed-size nodes, and the rest from a pool freed together with it,
+   rather than by malloc, and frees the current slab and pool, if any,
+   in bulk. Must not be called while any DTNode outside an arena
+   remains undestroyed. */
+void DTNode_useSlabs(boolean enable);
+
+/*--------------------------------------------------------------------*/
+
+/* Sets the pool in which DTNodes' names are interned, so that a name
+   shared by many nodes is stored once, or NULL for each DTNode to hold
+   its own copy. Must not be called while any DTNode remains
+   undestroyed. */
+void DTNode_useNames(Intern_T pool);
 
 /*--------------------------------------------------------------------*/
 
 /* Destroys the entire hierarchy of DTNodes rooted at n,
-   including n itself. Returns the number of DTNodes destroyed. */
+   including n itself. Returns the number of DTNodes destroyed. If n
+   was created by DTNode_createArena, its arena is freed in one go,
+   without visiting the nodes beneath it. */
 size_t DTNode_destroy(DTNode n);
 
 /*--------------------------------------------------------------------*/
 
-/* Compares node1 and node2 based on their paths.
+/* Destroys every DTNode at once, while slabs are in use, without
+   visiting them: frees the spilled children, maps and filters of the
+   directories outside arenas, every arena with the nodes in it, and
+   the slab. FileNodes outside arenas must then be freed in bulk with
+   FileNode_useSlabs, and names and contents with their pools. */
+void DTNode_destroyAll(void);
+
+/*--------------------------------------------------------------------*/
+
+/* Compares node1 and node2, which must have the same parent, based on
+  their names, which orders them as their paths would.
   Returns <0, 0, or >0 if node1 is less than,
   equal to, or greater than node2, respectively. */
 int DTNode_compare(DTNode node1, DTNode node2);
 
 /*--------------------------------------------------------------------*/
-/* Returns DTNode n's path. */
-const char* DTNode_getPath(DTNode n);
+
+/* Returns the final component of DTNode n's path. */
+const char* DTNode_getName(DTNode n);
+
+/*--------------------------------------------------------------------*/
+
+/* Returns the length of DTNode n's path. */
+size_t DTNode_getPathLength(DTNode n);
+
+/*--------------------------------------------------------------------*/
+
+/* Writes DTNode n's path, with its terminating '\0', into buf, which
+   must hold at least DTNode_getPathLength(n) + 1 characters.
+   Returns buf. */
+char* DTNode_writePath(DTNode n, char* buf);
+
+/*--------------------------------------------------------------------*/
+
+/* Returns TRUE if path is DTNode n's path or begins with n's path
+   followed by a slash, and FALSE otherwise. */
+boolean DTNode_isPathPrefix(DTNode n, const char* path);
 
 /*--------------------------------------------------------------------*/
 
-/* Returns the number of child directories n has. */
-size_t DTNode_getNumDTChildren(DTNode n);
+/* Returns TRUE if path is DTNode n's path, and FALSE otherwise. */
+boolean DTNode_hasPath(DTNode n, const char* path);
 
 /*--------------------------------------------------------------------*/
 
-/* Returns the number of child files n has. */
-size_t DTNode_getNumFileChildren(DTNode n);
+/* Returns the number of children, directories and files together,
+   n has. */
+size_t DTNode_getNumChildren(DTNode n);
 
 /*--------------------------------------------------------------------*/
 
-/* Returns 1 if n has a child directory with path,
-   0 if it does not have such a child, and -1 if
-   there is an allocation error during search.
+/* Returns 1 if n has a child directory or file with path,
+   or 0 if it does not have such a child.
 
    If n does have such a child, and childID is not NULL, store the
    child's identifier in *childID. If n does not have such a child,
@@ -63,10 +186,61 @@ int DTNode_hasChild(DTNode n, const char* path, size_t* childID);
 
 /*--------------------------------------------------------------------*/
 
-/* Returns the child DTNode of n with identifier childID, if one exists,
-   otherwise returns NULL; type is used to indicate whether file node
-   (type = TRUE), or directory node (type = FALSE) is being searched for. */
-DTNode DTNode_getChild(DTNode n, size_t childID, boolean type);
+/* Returns 1 if n has a child whose final path component is the first
+   len characters of name, storing its type, TRUE for a file and FALSE
+   for a directory, in *pType and, if childID is not NULL, its
+   identifier in *childID. Returns 0 if n has no such child, in which
+   case *pType and *childID are unchanged. name need not be
+   NUL-terminated, and no memory is allocated during the search, a
+   single one over the directories and files together. If n keeps a
+   Bloom filter, most misses are answered from it without searching. */
+int DTNode_findChild(DTNode n, const char* name, size_t len,
+                     boolean* pType, size_t* childID);
+
+/*--------------------------------------------------------------------*/
+
+/* Sets whether directories keep Bloom filters over the names of their
+   children once they have enough of them, and resets the counts
+   reported by DTNode_getFilterStats. Affects filters as directories
+   gain children, so it should be set before any are linked. */
+void DTNode_useFilters(boolean enable);
+
+/*--------------------------------------------------------------------*/
+
+/* Sets whether directories with many children locate them through a
+   hash map, appending new ones unsorted, or keep them sorted on every
+   insertion, moving them into a B+-tree once there are very many so
+   that each insertion or removal still takes logarithmic time. Affects
+   maps as directories gain children, so it should be set before any
+   are linked. */
+void DTNode_useMaps(boolean enable);
+
+/*--------------------------------------------------------------------*/
+
+/* Stores in *pProbes the number of DTNode_findChild searches that
+   consulted a filter since DTNode_useFilters was last called, in
+   *pRejects the number of those answered by the filter alone, and in
+   *pFalsePositives the number the filter passed that found no child. */
+void DTNode_getFilterStats(size_t* pProbes, size_t* pRejects,
+                           size_t* pFalsePositives);
+
+/*--------------------------------------------------------------------*/
+
+/* Puts the children of n back in sorted order by path, renumbering
+   their identifiers. Children are kept sorted on every insertion
+   until a directory has many of them; from then on new children
+   are appended and removed children are replaced by the last one, so
+   callers that need the children in order must call this first. */
+void DTNode_sortChildren(DTNode n);
+
+/*--------------------------------------------------------------------*/
+
+/* Returns the child of n with identifier childID, if one exists,
+   otherwise returns NULL. Directories and files share one sequence of
+   identifiers; if pType is not NULL, the child's type is stored in
+   *pType: TRUE for a file, which must be cast to FileNode, and FALSE
+   for a directory. */
+DTNode DTNode_getChild(DTNode n, size_t childID, boolean* pType);
 
 /*--------------------------------------------------------------------*/
 
@@ -77,7 +251,8 @@ DTNode DTNode_getParent(DTNode n);
 
 /* Makes DTNode child a child of parent, if possible, and returns SUCCESS.
   This is not possible in the following cases:
-  * child's path is not parent's path + / + directory,
+  * child was not created with parent as its parent, so child's path
+    is not parent's path + / + name,
     in which case returns PARENT_CHILD_ERROR
     * parent already has a child with child's path,
     in which case returns ALREADY_IN_TREE
@@ -89,7 +264,8 @@ int DTNode_linkChildDirectory(DTNode parent, DTNode child);
 
 /* Makes FileNode child a child of parent, if possible, and returns SUCCESS.
   This is not possible in the following cases:
-  * child's path is not parent's path + / + directory,
+  * child was not created with parent as its parent, so child's path
+    is not parent's path + / + name,
     in which case returns PARENT_CHILD_ERROR
     * parent already has a child with child's path,
     in which case returns ALREADY_IN_TREE
@@ -99,6 +275,24 @@ int DTNode_linkChildFile(DTNode parent, FileNode child);
 
 /*--------------------------------------------------------------------*/
 
+/* Makes the count nodes at children children of parent at once, if
+  possible, and returns SUCCESS. types[i] is TRUE if children[i] is a
+  FileNode and FALSE if it is a DTNode, as for DTNode_getChild. The
+  children need not be in order, though sorting them by name first
+  saves a sort; they are merged into parent's children in one pass,
+  rather than each being inserted with a shift of those after it.
+  No child is linked, and one of the following is returned, if:
+  * a child was not created with parent as its parent,
+    in which case returns PARENT_CHILD_ERROR
+    * parent already has a child with a child's path, or two children
+    have the same path, in which case returns ALREADY_IN_TREE
+    * parent is unable to allocate memory to store the new child links,
+    in which case returns MEMORY_ERROR. */
+int DTNode_linkChildren(DTNode parent, void* children[],
+                        const boolean types[], size_t count);
+
+/*--------------------------------------------------------------------*/
+
 /* Unlinks DTNode parent from its child directory DTNode child, leaving the
   child DTNode unchanged.
 
@@ -0,0 +1,15 @@
+/*--------------------------------------------------------------------*/
+/* FTNode.h                                                           */
+/* Author: Eesha Agarwal                                              */
+/*--------------------------------------------------------------------*/
+
+#ifndef FTNODE_INCLUDED
+#define FTNODE_INCLUDED
+
+/* A DTNode is a directory in a File Tree and a FileNode is a file;
+   each refers to nodes of the other kind, so both are declared here
+   for DTNode.h and FileNode.h alike. */
+typedef struct DTNode* DTNode;
+typedef struct FileNode* FileNode;
+
+#endif
@@ -9,13 +9,23 @@
 #include <stdio.h>
 
 #include "dynarray.h"
+#include "slab.h"
+#include "intern.h"
+#include "arena.h"
+#include "blob.h"
 #include "FileNode.h"
 #include "DTNode.h"
 
+/* The ways in which a FileNode may have been allocated: by malloc,
+   from the slab, from the pool of nodes too large for the slab, or
+   from its parent's arena, together with its own copy of its name
+   unless it is interned. */
+enum FileNode_source { FROM_MALLOC, FROM_SLAB, FROM_OVERFLOW, FROM_ARENA };
+
 /* A FileNode structure represents a file in the file tree. */
 struct FileNode {
-/* the full path of this directory */
-   char* path;
+/* the final component of the path of this file */
+   const char* name;
 
 /* the parent directory of this directory
    NULL for the root of the directory tree */
@@ -26,79 +36,321 @@ struct FileNode {
 
 /* length of the contents of the file. */
    size_t length;
+
+/* how this file was allocated */
+   enum FileNode_source source;
+
+/* TRUE if contents is this file's own copy, allocated from the pool of
+   contents, the pool of shared contents, or its parent's arena, FALSE
+   if it belongs to the client */
+   boolean ownsContents;
 };
 
-/* Returns a path with contents n->path/dir
-   or NULL if there is an allocation error.
+/* The number of characters, including the terminating nul, of the
+   longest name stored in a FileNode allocated from the slab. Unless
+   names are interned, a node and its name are always allocated
+   together, the name following the struct, and longer names make for
+   nodes of other sizes. */
+static const size_t SLAB_NAME_SIZE = 24;
+
+/* TRUE if FileNodes are allocated from slab, and the slab, which is
+   created when it is first needed. */
+static boolean useSlabs = FALSE;
+static Slab_T slab;
+
+/* While slabs are in use, the pool from which FileNodes with names too
+   long for the slab are allocated, so that they are freed in bulk
+   with it, which is created when it is first needed. */
+static Arena_T overflow;
+
+/* The pool in which FileNodes' names are interned, or NULL if each
+   FileNode holds its own copy of its name. */
+static Intern_T names;
+
+/* The pool from which the copies of contents owned by FileNodes
+   outside any arena are allocated, which is created when it is first
+   needed. Each copy takes the smallest power of two of at least
+   MIN_CONTENTS_SIZE bytes that holds it. */
+static Arena_T contentsPool;
+static const size_t MIN_CONTENTS_SIZE = 16;
+
+/* The pool through which FileNodes outside any arena share equal
+   copies of contents, or NULL if each holds a copy of its own. */
+static Blob_T blobs;
+
+/* Allocates a FileNode outside any arena for a name of len
+   characters starting at dir, from the slab, from the pool of larger
+   nodes or by malloc, setting
+   *pName to the name's pooled copy if names are interned, and
+   otherwise to NULL, leaving room for the name after the node.
+   Returns NULL if insufficient memory is available. */
+static FileNode FileNode_alloc(const char* dir, size_t len,
+                               const char** pName) {
+   FileNode new;
+   const char* name = NULL;
 
-   Allocates memory for the returned string,
-   which is then owened by the caller. */
-static char* FileNode_buildPath(DTNode n, const char* file) {
-   char* path;
+   assert(dir != NULL);
+   assert(pName != NULL);
 
-   assert(file != NULL);
+   if(names != NULL) {
+      name = Intern_add(names, dir, len);
+      if(name == NULL)
+         return NULL;
+   }
 
-   if(n == NULL)
-      path = malloc(strlen(file)+1);
-   else
-      path = malloc(strlen(DTNode_getPath(n)) + 1 + strlen(file) + 1);
+   new = NULL;
+   if(useSlabs && (name != NULL || len < SLAB_NAME_SIZE)) {
+      if(slab == NULL)
+         slab = Slab_new(sizeof(struct FileNode) +
+                         (names == NULL ? SLAB_NAME_SIZE : 0));
+      if(slab != NULL)
+         new = Slab_alloc(slab);
+   }
+   if(new != NULL) {
+      new->source = FROM_SLAB;
+   }
+   else if(useSlabs) {
+      if(overflow == NULL)
+         overflow = Arena_new();
+      if(overflow != NULL)
+         new = Arena_alloc(overflow, sizeof(struct FileNode) +
+                           (name == NULL ? len + 1 : 0));
+      if(new != NULL)
+         new->source = FROM_OVERFLOW;
+   }
+   else {
+      new = malloc(sizeof(struct FileNode) +
+                   (name == NULL ? len + 1 : 0));
+      if(new != NULL)
+         new->source = FROM_MALLOC;
+   }
 
-   if(path == NULL)
+   if(new == NULL) {
+      if(name != NULL)
+         Intern_release(names, name);
       return NULL;
-   *path = '\0';
-
-   if(n != NULL) {
-      strcpy(path, DTNode_getPath(n));
-      strcat(path, "/");
    }
-   strcat(path, file);
 
-   return path;
+   *pName = name;
+   return new;
 }
 
 /* FileNode.h contains specification. */
-FileNode FileNode_create(const char* dir, DTNode parent,
+FileNode FileNode_create(const char* dir, size_t len, DTNode parent,
                          void *contents, size_t length){
 
    FileNode new;
+   const char* name = NULL;
+   char* copy;
 
    assert(dir != NULL);
 
-   new = malloc(sizeof(struct FileNode));
-   if(new == NULL)
-      return NULL;
-
-   new->path = FileNode_buildPath(parent, dir);
+   /* Nodes in an arena go with it, so their names are not pooled. */
+   if(parent != NULL && DTNode_isInArena(parent)) {
+      new = DTNode_allocInArena(parent,
+                                sizeof(struct FileNode) + len + 1);
+      if(new == NULL)
+         return NULL;
+      new->source = FROM_ARENA;
+   }
+   else {
+      new = FileNode_alloc(dir, len, &name);
+      if(new == NULL)
+         return NULL;
+   }
 
-   if(new->path == NULL) {
-      free(new);
-      return NULL;
+   DTNode_charge(parent, MEMORY_NODES, sizeof(struct FileNode));
+   if(name == NULL) {
+      copy = (char*)(new + 1);
+      memcpy(copy, dir, len);
+      copy[len] = '\0';
+      name = copy;
+      DTNode_charge(parent, MEMORY_NAMES, len + 1);
    }
+   new->name = name;
 
    new->parent = parent;
    new->contents = contents;
    new->length = length;
+   new->ownsContents = FALSE;
 
    return new;
 }
 
+/* Returns the number of bytes allocated for a copy of contents of
+   length bytes. */
+static size_t FileNode_contentsSize(size_t length) {
+   size_t size = MIN_CONTENTS_SIZE;
+
+   while(size < length)
+      size *= 2;
+   return size;
+}
+
+/* Returns the pool from which n's own copy of its contents is
+   allocated, creating the shared pool if need be, or NULL if
+   insufficient memory is available. */
+static Arena_T FileNode_contentsPool(FileNode n) {
+   assert(n != NULL);
+
+   /* Copies in an arena go with it. */
+   if(n->source == FROM_ARENA)
+      return DTNode_getArena(n->parent);
+
+   if(contentsPool == NULL)
+      contentsPool = Arena_new();
+   return contentsPool;
+}
+
+/* FileNode.h contains specification. */
+boolean FileNode_sharesContents(FileNode n) {
+   assert(n != NULL);
+
+   /* Copies in an arena go with it, so they are not shared. */
+   return n->ownsContents && blobs != NULL && n->source != FROM_ARENA;
+}
+
+/* Counts the length of n's own copy of its contents, if it has one,
+   among the lengths of copies held, if charge is TRUE, or no longer,
+   if charge is FALSE. */
+static void FileNode_tallyContents(FileNode n, boolean charge) {
+   assert(n != NULL);
+
+   if(!n->ownsContents)
+      return;
+   if(charge)
+      DTNode_charge(n->parent, MEMORY_COPIED_LENGTHS, n->length);
+   else
+      DTNode_discharge(n->parent, MEMORY_COPIED_LENGTHS, n->length);
+   if(FileNode_sharesContents(n))
+      return;
+   if(charge)
+      DTNode_charge(n->parent, MEMORY_UNSHARED_LENGTHS, n->length);
+   else
+      DTNode_discharge(n->parent, MEMORY_UNSHARED_LENGTHS, n->length);
+}
+
+/* Frees n's own copy of its contents, if it has one. */
+static void FileNode_releaseContents(FileNode n) {
+   assert(n != NULL);
+
+   if(!n->ownsContents)
+      return;
+   FileNode_tallyContents(n, FALSE);
+   if(FileNode_sharesContents(n)) {
+      Blob_release(blobs, n->contents);
+   }
+   else {
+      DTNode_discharge(n->parent, MEMORY_CONTENTS,
+                       FileNode_contentsSize(n->length));
+      Arena_release(FileNode_contentsPool(n), n->contents,
+                    FileNode_contentsSize(n->length));
+   }
+   n->ownsContents = FALSE;
+}
+
 /* FileNode.h contains specification. */
 void FileNode_destroy(FileNode n) {
-   free(n->path);
-   free(n);
+   assert(n != NULL);
+
+   FileNode_releaseContents(n);
+
+   DTNode_discharge(n->parent, MEMORY_NODES, sizeof(struct FileNode));
+   if(n->source == FROM_ARENA || names == NULL)
+      DTNode_discharge(n->parent, MEMORY_NAMES, strlen(n->name) + 1);
+
+   if(n->source == FROM_ARENA) {
+      DTNode_releaseInArena(n->parent, n,
+                            sizeof(struct FileNode) + strlen(n->name) + 1);
+      return;
+   }
+
+   if(names != NULL)
+      Intern_release(names, n->name);
+
+   if(n->source == FROM_SLAB)
+      Slab_release(slab, n);
+   else if(n->source == FROM_OVERFLOW)
+      Arena_release(overflow, n, sizeof(struct FileNode) +
+                    (names == NULL ? strlen(n->name) + 1 : 0));
+   else
+      free(n);
+}
+
+/* FileNode.h contains specification. */
+void FileNode_useSlabs(boolean enable) {
+   if(slab != NULL) {
+      Slab_free(slab);
+      slab = NULL;
+   }
+   if(overflow != NULL) {
+      Arena_free(overflow);
+      overflow = NULL;
+   }
+   useSlabs = enable;
+}
+
+/* FileNode.h contains specification. */
+void FileNode_useNames(Intern_T pool) {
+   /* The size of the nodes in the slab depends on whether they hold
+      their names. */
+   FileNode_useSlabs(useSlabs);
+   names = pool;
 }
 
 /* FileNode.h contains specification. */
 int FileNode_compare(FileNode node1, FileNode node2) {
    assert(node1 != NULL);
    assert(node2 != NULL);
-   return strcmp(node1->path, node2->path);
+   return strcmp(node1->name, node2->name);
+}
+
+/* FileNode.h contains specification. */
+const char* FileNode_getName(FileNode n) {
+   assert(n != NULL);
+   return n->name;
+}
+
+/* FileNode.h contains specification. */
+size_t FileNode_getPathLength(FileNode n) {
+   assert(n != NULL);
+
+   if(n->parent == NULL)
+      return strlen(n->name);
+   return DTNode_getPathLength(n->parent) + 1 + strlen(n->name);
+}
+
+/* FileNode.h contains specification. */
+char* FileNode_writePath(FileNode n, char* buf) {
+   size_t parentLen;
+
+   assert(n != NULL);
+   assert(buf != NULL);
+
+   if(n->parent == NULL)
+      return strcpy(buf, n->name);
+
+   parentLen = DTNode_getPathLength(n->parent);
+   (void) DTNode_writePath(n->parent, buf);
+   buf[parentLen] = '/';
+   strcpy(buf + parentLen + 1, n->name);
+   return buf;
 }
 
 /* FileNode.h contains specification. */
-const char* FileNode_getPath(FileNode n) {
+boolean FileNode_hasPath(FileNode n, const char* path) {
+   size_t parentLen;
+
    assert(n != NULL);
-   return n->path;
+   assert(path != NULL);
+
+   if(n->parent == NULL)
+      return strcmp(path, n->name) == 0;
+
+   parentLen = DTNode_getPathLength(n->parent);
+   return DTNode_isPathPrefix(n->parent, path) &&
+          path[parentLen] == '/' &&
+          strcmp(path + parentLen + 1, n->name) == 0;
 }
 
 /* FileNode.h contains specification. */
@@ -124,12 +376,82 @@ void* FileNode_replaceContents(FileNode n, void *newContents,
                                size_t newLength) {
    void* oldContents;
    assert(n != NULL);
-   oldContents = n->contents;
+   oldContents = n->ownsContents ? NULL : n->contents;
+   FileNode_releaseContents(n);
    n->contents = newContents;
    n->length = newLength;
    return oldContents;
 }
 
+/* FileNode.h contains specification. */
+boolean FileNode_copyContents(FileNode n, const void *newContents,
+                              size_t newLength) {
+   Arena_T pool;
+   void* copy;
+
+   assert(n != NULL);
+   assert(newContents != NULL || newLength == 0);
+
+   /* Sharing any equal copy, adding the new contents before releasing
+      the old ones, in case they are the same. */
+   if(blobs != NULL && n->source != FROM_ARENA) {
+      copy = (void*)Blob_add(blobs, newContents, newLength);
+      if(copy == NULL)
+         return FALSE;
+      FileNode_releaseContents(n);
+      n->contents = copy;
+      n->length = newLength;
+      n->ownsContents = TRUE;
+      FileNode_tallyContents(n, TRUE);
+      return TRUE;
+   }
+
+   /* Reusing n's copy if the new contents are of its size class. */
+   if(n->ownsContents && FileNode_contentsSize(n->length) ==
+      FileNode_contentsSize(newLength)) {
+      copy = n->contents;
+      FileNode_tallyContents(n, FALSE);
+   }
+   else {
+      pool = FileNode_contentsPool(n);
+      if(pool == NULL)
+         return FALSE;
+      copy = Arena_alloc(pool, FileNode_contentsSize(newLength));
+      if(copy == NULL)
+         return FALSE;
+      FileNode_releaseContents(n);
+      DTNode_charge(n->parent, MEMORY_CONTENTS,
+                    FileNode_contentsSize(newLength));
+   }
+
+   if(newLength != 0)
+      memcpy(copy, newContents, newLength);
+   n->contents = copy;
+   n->length = newLength;
+   n->ownsContents = TRUE;
+   FileNode_tallyContents(n, TRUE);
+   return TRUE;
+}
+
+/* FileNode.h contains specification. */
+boolean FileNode_ownsContents(FileNode n) {
+   assert(n != NULL);
+   return n->ownsContents;
+}
+
+/* FileNode.h contains specification. */
+void FileNode_useBlobs(Blob_T pool) {
+   blobs = pool;
+}
+
+/* FileNode.h contains specification. */
+void FileNode_freeContentsPool(void) {
+   if(contentsPool != NULL) {
+      Arena_free(contentsPool);
+      contentsPool = NULL;
+   }
+}
+
 /* FileNode.h contains specification. */
 void FileNode_setParent(FileNode n, DTNode parent) {
    assert(n != NULL);
@@ -143,9 +465,9 @@ char* FileNode_toString(FileNode n) {
 
    assert(n != NULL);
 
-   copyPath = malloc(strlen(n->path)+1);
+   copyPath = malloc(FileNode_getPathLength(n) + 1);
    if(copyPath == NULL)
       return NULL;
    else
-      return strcpy(copyPath, n->path);
+      return FileNode_writePath(n, copyPath);
 }
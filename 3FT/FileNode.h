@@ -8,20 +8,25 @@
 
 #include <stddef.h>
 #include "a4def.h"
+#include "intern.h"
+#include "blob.h"
 #include "FTNode.h"
 
 /*--------------------------------------------------------------------*/
 
-/* A FileNode is an object that contains a path payload and references to
-   the FileNode's parent (if it exists). */
+/* A FileNode is an object that contains a name payload, the final
+   component of its path, and references to the FileNode's parent (if
+   it exists). Its full path is rebuilt from its ancestors on demand. */
 
 /*--------------------------------------------------------------------*/
 
-/* Given a parent DTNode, a directory string dir, contents, and the length of
-   contents, returns a new FileNode structure or NULL if any allocation error
-   occurs in creating the node or its fields. */
+/* Given a parent DTNode, the first len characters of a directory
+   string dir, contents, and the length of contents, returns a new
+   FileNode structure or NULL if any allocation error occurs in creating
+   the node or its fields. dir need not be nul-terminated after those
+   len characters. */
 
-FileNode FileNode_create(const char* dir, DTNode parent,
+FileNode FileNode_create(const char* dir, size_t len, DTNode parent,
                          void *contents, size_t length);
 
 /*--------------------------------------------------------------------*/
@@ -31,12 +36,56 @@ void FileNode_destroy(FileNode n);
 
 /*--------------------------------------------------------------------*/
 
-/* Returns FileNode n's path. */
-const char* FileNode_getPath(FileNode n);
+/* Sets whether FileNodes with short names are allocated from a slab
+   of fixed-size nodes, and the rest from a pool freed together with
+   it, rather than by malloc, and frees the current slab and pool, if
+   any, in bulk. Must not be called while any FileNode outside an
+   arena remains undestroyed, except to free them all at once. */
+void FileNode_useSlabs(boolean enable);
 
 /*--------------------------------------------------------------------*/
 
-/* Compares node1 and node2 based on their paths.
+/* Sets the pool in which FileNodes' names are interned, so that a
+   name shared by many nodes is stored once, or NULL for each FileNode
+   to hold its own copy. Must not be called while any FileNode remains
+   undestroyed. */
+void FileNode_useNames(Intern_T pool);
+
+/*--------------------------------------------------------------------*/
+
+/* Sets the pool through which FileNodes outside any arena share their
+   own copies of contents, so that equal contents held by many nodes
+   are stored once, or NULL for each FileNode to hold a copy of its
+   own. Must not be called while any FileNode holding its own copy
+   remains undestroyed. */
+void FileNode_useBlobs(Blob_T pool);
+
+/*--------------------------------------------------------------------*/
+
+/* Returns the final component of FileNode n's path. */
+const char* FileNode_getName(FileNode n);
+
+/*--------------------------------------------------------------------*/
+
+/* Returns the length of FileNode n's path. */
+size_t FileNode_getPathLength(FileNode n);
+
+/*--------------------------------------------------------------------*/
+
+/* Writes FileNode n's path, with its terminating '\0', into buf, which
+   must hold at least FileNode_getPathLength(n) + 1 characters.
+   Returns buf. */
+char* FileNode_writePath(FileNode n, char* buf);
+
+/*--------------------------------------------------------------------*/
+
+/* Returns TRUE if path is FileNode n's path, and FALSE otherwise. */
+boolean FileNode_hasPath(FileNode n, const char* path);
+
+/*--------------------------------------------------------------------*/
+
+/* Compares node1 and node2, which must have the same parent, based on
+  their names, which orders them as their paths would.
   Returns <0, 0, or >0 if node1 is less than,
   equal to, or greater than node2, respectively. */
 int FileNode_compare(FileNode node1, FileNode node2);
@@ -60,12 +109,46 @@ size_t FileNode_getLength(FileNode n);
 
 /* Replaces the contents of FileNode n with newContents, and
    the length of contents with newLength. Returns the old contents
-   of n. */
+   of n, or NULL if they were n's own copy, which is freed. */
 void* FileNode_replaceContents(FileNode n, void *newContents,
                                size_t newLength);
 
 /*--------------------------------------------------------------------*/
 
+/* Replaces the contents of FileNode n with n's own copy of the
+   newLength bytes at newContents, reusing n's current copy if it has
+   one of the same power-of-two size class, and otherwise allocating
+   one from a pool shared by FileNodes, or from the arena of n's
+   subtree if n is in one, and freeing n's current copy. If a pool of
+   shared contents is set and n is in no arena, the copy is instead
+   the pool's, shared with every FileNode holding equal contents, and
+   must not be modified. Contents that belonged to the client are
+   simply dropped. Returns TRUE if successful, or FALSE, leaving n
+   unchanged, if insufficient memory is available. */
+boolean FileNode_copyContents(FileNode n, const void *newContents,
+                              size_t newLength);
+
+/*--------------------------------------------------------------------*/
+
+/* Returns TRUE if the contents of FileNode n are its own copy, made
+   by FileNode_copyContents, and FALSE if they belong to the client. */
+boolean FileNode_ownsContents(FileNode n);
+
+/*--------------------------------------------------------------------*/
+
+/* Returns TRUE if the contents of FileNode n are its own copy, shared
+   through the pool set by FileNode_useBlobs, and FALSE otherwise. */
+boolean FileNode_sharesContents(FileNode n);
+
+/*--------------------------------------------------------------------*/
+
+/* Frees the pool from which FileNodes outside any arena allocate their
+   own copies of contents, in bulk. Must not be called while any
+   FileNode holding such a copy remains undestroyed. */
+void FileNode_freeContentsPool(void);
+
+/*--------------------------------------------------------------------*/
+
 /* Updates the parent of FileNode n to be the input DTNode parent. */
 void FileNode_setParent(FileNode n, DTNode parent);
 
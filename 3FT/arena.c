@@ -0,0 +1,256 @@
+/*--------------------------------------------------------------------*/
+/* arena.c                                                            */
+/*--------------------------------------------------------------------*/
+
+#include "arena.h"
+#include "slab.h"
+#include <assert.h>
+#include <stdlib.h>
+
+/*--------------------------------------------------------------------*/
+
+/* The difference in size between consecutive size classes of small
+   objects, which are carved out of slabs, and the size of the largest
+   such class. */
+
+enum { CLASS_STEP = 16 };
+enum { NUM_CLASSES = 16 };
+static const size_t MAX_CLASS_SIZE = CLASS_STEP * NUM_CLASSES;
+
+/* The number of size classes of large objects, which are allocated
+   individually, each twice the size of the one before it, starting at
+   twice MAX_CLASS_SIZE.  Released objects of these sizes are kept for
+   reuse, while any larger ones are freed at once. */
+
+enum { NUM_LARGE_CLASSES = 12 };
+
+/*--------------------------------------------------------------------*/
+
+/* A type whose alignment suits any object. */
+
+union ArenaAlign
+{
+   long double ld;
+   double d;
+   long l;
+   void *pv;
+   void (*pf)(void);
+};
+
+/* The header of an individually allocated object, which links it
+   into its Arena object's list of such objects and is followed by the
+   object itself. */
+
+union ArenaLarge
+{
+   struct
+   {
+      /* The neighbouring objects in the list, or NULL at its ends. */
+      union ArenaLarge *puPrev;
+      union ArenaLarge *puNext;
+   } sLinks;
+
+   /* Padding, so that the object that follows is aligned. */
+   union ArenaAlign uAlign;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* A released large object, whose first bytes link the free list of
+   its size class. */
+
+struct ArenaFree
+{
+   struct ArenaFree *psNext;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* An Arena consists of a slab for each size class of small objects, a
+   list of all of its large objects, and a list of the released large
+   objects of each size class. */
+
+struct Arena
+{
+   /* The slab of each size class, or NULL until it is first needed.
+      Class i holds objects of (i + 1) * CLASS_STEP bytes. */
+   Slab_T aoSlabs[NUM_CLASSES];
+
+   /* The most recently allocated large object, or NULL. */
+   union ArenaLarge *puLarge;
+
+   /* The most recently released large object of each size class, or
+      NULL.  Class i holds objects of MAX_CLASS_SIZE << (i + 1)
+      bytes. */
+   struct ArenaFree *apsFree[NUM_LARGE_CLASSES];
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Return the size class of objects of uSize bytes, which must be at
+   most MAX_CLASS_SIZE. */
+
+static size_t Arena_class(size_t uSize)
+{
+   assert(uSize <= MAX_CLASS_SIZE);
+
+   if (uSize == 0)
+      return 0;
+   return (uSize - 1) / CLASS_STEP;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Store in *puClass the size class of large objects of uSize bytes,
+   which must be more than MAX_CLASS_SIZE, and return the size of the
+   objects of that class, or return 0 if uSize is too large for any
+   class. */
+
+static size_t Arena_largeClass(size_t uSize, size_t *puClass)
+{
+   size_t uClassSize = MAX_CLASS_SIZE * 2;
+   size_t u;
+
+   assert(uSize > MAX_CLASS_SIZE);
+   assert(puClass != NULL);
+
+   for (u = 0; u < NUM_LARGE_CLASSES; u++)
+   {
+      if (uSize <= uClassSize)
+      {
+         *puClass = u;
+         return uClassSize;
+      }
+      uClassSize *= 2;
+   }
+   return 0;
+}
+
+/*--------------------------------------------------------------------*/
+
+Arena_T Arena_new(void)
+{
+   Arena_T oArena;
+   size_t u;
+
+   oArena = (struct Arena*)malloc(sizeof(struct Arena));
+   if (oArena == NULL)
+      return NULL;
+
+   for (u = 0; u < NUM_CLASSES; u++)
+      oArena->aoSlabs[u] = NULL;
+   oArena->puLarge = NULL;
+   for (u = 0; u < NUM_LARGE_CLASSES; u++)
+      oArena->apsFree[u] = NULL;
+
+   return oArena;
+}
+
+/*--------------------------------------------------------------------*/
+
+void Arena_free(Arena_T oArena)
+{
+   union ArenaLarge *puLarge;
+   union ArenaLarge *puNext;
+   size_t u;
+
+   assert(oArena != NULL);
+
+   for (u = 0; u < NUM_CLASSES; u++)
+      if (oArena->aoSlabs[u] != NULL)
+         Slab_free(oArena->aoSlabs[u]);
+
+   for (puLarge = oArena->puLarge; puLarge != NULL; puLarge = puNext)
+   {
+      puNext = puLarge->sLinks.puNext;
+      free(puLarge);
+   }
+   free(oArena);
+}
+
+/*--------------------------------------------------------------------*/
+
+void *Arena_alloc(Arena_T oArena, size_t uSize)
+{
+   union ArenaLarge *puLarge;
+   struct ArenaFree *psFree;
+   size_t uClassSize;
+   size_t uClass;
+
+   assert(oArena != NULL);
+
+   if (uSize > MAX_CLASS_SIZE)
+   {
+      uClassSize = Arena_largeClass(uSize, &uClass);
+      if (uClassSize != 0)
+      {
+         /* Reusing a released object of the same class first. */
+         if (oArena->apsFree[uClass] != NULL)
+         {
+            psFree = oArena->apsFree[uClass];
+            oArena->apsFree[uClass] = psFree->psNext;
+            return psFree;
+         }
+         uSize = uClassSize;
+      }
+
+      puLarge = (union ArenaLarge*)malloc(sizeof(union ArenaLarge) +
+         uSize);
+      if (puLarge == NULL)
+         return NULL;
+
+      puLarge->sLinks.puPrev = NULL;
+      puLarge->sLinks.puNext = oArena->puLarge;
+      if (oArena->puLarge != NULL)
+         oArena->puLarge->sLinks.puPrev = puLarge;
+      oArena->puLarge = puLarge;
+      return puLarge + 1;
+   }
+
+   uClass = Arena_class(uSize);
+   if (oArena->aoSlabs[uClass] == NULL)
+   {
+      oArena->aoSlabs[uClass] = Slab_new((uClass + 1) * CLASS_STEP);
+      if (oArena->aoSlabs[uClass] == NULL)
+         return NULL;
+   }
+   return Slab_alloc(oArena->aoSlabs[uClass]);
+}
+
+/*--------------------------------------------------------------------*/
+
+void Arena_release(Arena_T oArena, void *pvObject, size_t uSize)
+{
+   union ArenaLarge *puLarge;
+   struct ArenaFree *psFree;
+   size_t uClass;
+
+   assert(oArena != NULL);
+   assert(pvObject != NULL);
+
+   if (uSize > MAX_CLASS_SIZE)
+   {
+      /* Keeping the object, still on the list of all large objects,
+         for reuse if its size has a class. */
+      if (Arena_largeClass(uSize, &uClass) != 0)
+      {
+         psFree = (struct ArenaFree*)pvObject;
+         psFree->psNext = oArena->apsFree[uClass];
+         oArena->apsFree[uClass] = psFree;
+         return;
+      }
+
+      puLarge = (union ArenaLarge*)pvObject - 1;
+      if (puLarge->sLinks.puPrev != NULL)
+         puLarge->sLinks.puPrev->sLinks.puNext = puLarge->sLinks.puNext;
+      else
+         oArena->puLarge = puLarge->sLinks.puNext;
+      if (puLarge->sLinks.puNext != NULL)
+         puLarge->sLinks.puNext->sLinks.puPrev = puLarge->sLinks.puPrev;
+      free(puLarge);
+      return;
+   }
+
+   assert(oArena->aoSlabs[Arena_class(uSize)] != NULL);
+   Slab_release(oArena->aoSlabs[Arena_class(uSize)], pvObject);
+}
@@ -0,0 +1,50 @@
+/*--------------------------------------------------------------------*/
+/* arena.h                                                            */
+/*--------------------------------------------------------------------*/
+
+#ifndef ARENA_INCLUDED
+#define ARENA_INCLUDED
+
+#include <stddef.h>
+
+/* An Arena_T object allocates objects of any size, keeping those
+   released to it for reuse by later objects of the same size class,
+   and frees every object allocated from it at once when it is freed
+   itself. Objects of up to 256 bytes are carved out of slabs, one per
+   class of sizes that are multiples of 16 bytes. Larger objects are
+   allocated individually, their sizes rounded up to a power of two,
+   and those of over 1 MiB are freed as soon as they are released. */
+
+typedef struct Arena *Arena_T;
+
+/*--------------------------------------------------------------------*/
+
+/* Return a new Arena_T object, or NULL if insufficient memory is
+   available.  No memory for objects is allocated until the first
+   object is. */
+
+Arena_T Arena_new(void);
+
+/*--------------------------------------------------------------------*/
+
+/* Free oArena and every object allocated from it, whether or not the
+   objects have been released. */
+
+void Arena_free(Arena_T oArena);
+
+/*--------------------------------------------------------------------*/
+
+/* Return a new object of uSize bytes allocated from oArena, suitably
+   aligned for any type, or NULL if insufficient memory is
+   available. */
+
+void *Arena_alloc(Arena_T oArena, size_t uSize);
+
+/*--------------------------------------------------------------------*/
+
+/* Release pvObject, which must have been allocated from oArena with
+   size uSize, for reuse by a later Arena_alloc. */
+
+void Arena_release(Arena_T oArena, void *pvObject, size_t uSize);
+
+#endif
@@ -0,0 +1,17 @@
+/*--------------------------------------------------------------------*/
+/* bench.c                                                            */
+/*--------------------------------------------------------------------*/
+
+#include "bench.h"
+
+/*--------------------------------------------------------------------*/
+
+clock_t Bench_start(void) {
+  return clock();
+}
+
+/*--------------------------------------------------------------------*/
+
+double Bench_since(clock_t start) {
+  return (double) (clock() - start) / CLOCKS_PER_SEC;
+}
@@ -0,0 +1,26 @@
+/*--------------------------------------------------------------------*/
+/* bench.h                                                            */
+/*--------------------------------------------------------------------*/
+
+#ifndef BENCH_INCLUDED
+#define BENCH_INCLUDED
+
+#include <time.h>
+
+/* The timer that every benchmark reads, so that all of them measure
+   the same processor time in the same way. */
+
+/*--------------------------------------------------------------------*/
+
+/* Returns the current reading of the timer, to be passed later to
+   Bench_since. */
+
+clock_t Bench_start(void);
+
+/*--------------------------------------------------------------------*/
+
+/* Returns the seconds of processor time since the reading start. */
+
+double Bench_since(clock_t start);
+
+#endif
@@ -0,0 +1,87 @@
+/*--------------------------------------------------------------------*/
+/* bench_bigdir.c                                                     */
+/*--------------------------------------------------------------------*/
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "ft.h"
+#include "bench.h"
+
+/* The number of files inserted unless another is given. */
+enum { DEFAULT_FILES = 1000000 };
+
+/* Exits, reporting what failed, unless status is SUCCESS. */
+static void check(int status, const char* what) {
+  if(status != SUCCESS) {
+    fprintf(stderr, "%s failed with status %d\n", what, status);
+    exit(EXIT_FAILURE);
+  }
+}
+
+/* Stores in path the path of the i-th of count files, numbered in a
+   scattered order so that each is inserted among the others. */
+static void filePath(char* path, size_t i, size_t count) {
+  sprintf(path, "root/big/f%010lu",
+          (unsigned long) (i * 2654435761UL % 4294967291UL % (4 * count)));
+}
+
+/* Inserts count files into one directory of an FT initialized with
+   options, then finds and removes each of them, printing the time each
+   phase takes under label. */
+static void run(const char* label, unsigned int options, size_t count) {
+  char path[64];
+  clock_t start;
+  double insert;
+  double find;
+  size_t found = 0;
+  size_t i;
+
+  check(FT_initWithOptions(options), "FT_initWithOptions");
+  check(FT_insertDir("root/big"), "FT_insertDir");
+
+  start = Bench_start();
+  for(i = 0; i < count; i++) {
+    filePath(path, i, count);
+    /* Numbers that collide leave fewer files, which is harmless. */
+    (void) FT_insertFile(path, NULL, 0);
+  }
+  insert = Bench_since(start);
+
+  start = Bench_start();
+  for(i = 0; i < count; i++) {
+    filePath(path, i, count);
+    found += FT_containsFile(path);
+  }
+  find = Bench_since(start);
+  if(found != count) {
+    fprintf(stderr, "only %lu of %lu files found\n",
+            (unsigned long) found, (unsigned long) count);
+    exit(EXIT_FAILURE);
+  }
+
+  start = Bench_start();
+  for(i = 0; i < count; i++) {
+    filePath(path, i, count);
+    (void) FT_rmFile(path);
+  }
+  printf("%-16s %9.2f s %9.2f s %9.2f s\n", label, insert, find,
+         Bench_since(start));
+  check(FT_destroy(), "FT_destroy");
+}
+
+/* Measures filling one directory with argv[1] files, or
+   DEFAULT_FILES, with hashed child maps and with sorted children.
+   Returns 0. */
+int main(int argc, char* argv[]) {
+  size_t count = DEFAULT_FILES;
+
+  if(argc > 1)
+    count = (size_t) strtoul(argv[1], NULL, 10);
+
+  printf("%lu files in one directory\n", (unsigned long) count);
+  printf("%-16s %11s %11s %11s\n", "", "insert", "find", "remove");
+  run("maps", 0, count);
+  run("sorted", FT_SORTED_CHILDREN, count);
+  return 0;
+}
@@ -0,0 +1,68 @@
+/*--------------------------------------------------------------------*/
+/* bench_fanout.c                                                     */
+/*--------------------------------------------------------------------*/
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "ft.h"
+#include "bench.h"
+
+/* The number of lookups timed at each fanout. */
+enum { NUM_LOOKUPS = 1000000 };
+
+/* The fanouts measured. */
+static const size_t fanouts[] = { 10, 100, 1000, 10000, 50000 };
+
+/* Exits, reporting what failed, unless status is SUCCESS. */
+static void check(int status, const char* what) {
+  if(status != SUCCESS) {
+    fprintf(stderr, "%s failed with status %d\n", what, status);
+    exit(EXIT_FAILURE);
+  }
+}
+
+/* Measures the time that FT_containsFile takes to find a file among
+   the files of a directory with each of fanouts, beside a directory
+   with as many subdirectories, and prints it in nanoseconds per
+   lookup. Returns 0. */
+int main(void) {
+  char path[64];
+  clock_t start;
+  double elapsed;
+  size_t fanout;
+  size_t found;
+  size_t i;
+  size_t k;
+
+  printf("  fanout   ns/lookup\n");
+  for(k = 0; k < sizeof(fanouts) / sizeof(fanouts[0]); k++) {
+    fanout = fanouts[k];
+    check(FT_init(), "FT_init");
+    check(FT_insertDir("r/d"), "FT_insertDir");
+    for(i = 0; i < fanout; i++) {
+      sprintf(path, "r/d/d%07lu", (unsigned long) i);
+      check(FT_insertDir(path), "FT_insertDir");
+      sprintf(path, "r/f/f%07lu", (unsigned long) i);
+      check(FT_insertFile(path, NULL, 0), "FT_insertFile");
+    }
+
+    /* Visiting the files in a scattered order. */
+    found = 0;
+    start = Bench_start();
+    for(i = 0; i < NUM_LOOKUPS; i++) {
+      sprintf(path, "r/f/f%07lu", (unsigned long) (i * 7919 % fanout));
+      found += FT_containsFile(path);
+    }
+    elapsed = Bench_since(start);
+    if(found != NUM_LOOKUPS) {
+      fprintf(stderr, "only %lu lookups found their file\n",
+              (unsigned long) found);
+      return EXIT_FAILURE;
+    }
+    printf("%8lu %11.1f\n", (unsigned long) fanout,
+           elapsed / NUM_LOOKUPS * 1e9);
+    check(FT_destroy(), "FT_destroy");
+  }
+  return 0;
+}
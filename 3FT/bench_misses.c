@@ -0,0 +1,102 @@
+/*--------------------------------------------------------------------*/
+/* bench_misses.c                                                     */
+/*--------------------------------------------------------------------*/
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "ft.h"
+#include "bench.h"
+
+/* The number of lookups timed for each shape of tree. */
+enum { NUM_LOOKUPS = 4000000 };
+
+/* The files of a directory are numbered by tens, and lookups seek
+   numbers in the whole range, so that nine in ten miss. */
+enum { NUMBER_STEP = 10 };
+
+/* The shapes of tree measured: numbers of directories and of files in
+   each. */
+static const size_t shapes[][2] = { { 2000, 200 }, { 200, 2000 } };
+
+/* The state of the pseudo-random number generator. */
+static unsigned long state;
+
+/* Returns the next pseudo-random number below bound. */
+static size_t randomBelow(size_t bound) {
+  state = (state * 1103515245UL + 12345UL) & 0x7fffffffUL;
+  return (size_t) (state >> 8) % bound;
+}
+
+/* Exits, reporting what failed, unless status is SUCCESS. */
+static void check(int status, const char* what) {
+  if(status != SUCCESS) {
+    fprintf(stderr, "%s failed with status %d\n", what, status);
+    exit(EXIT_FAILURE);
+  }
+}
+
+/* Fills an FT initialized with options with numDirs directories of
+   numFiles files, then times lookups by FT_containsFile and FT_stat
+   alternately, nine in ten of which miss, and prints their cost and
+   the filter statistics under label. */
+static void run(const char* label, unsigned int options, size_t numDirs,
+                size_t numFiles) {
+  char path[64];
+  clock_t start;
+  double elapsed;
+  boolean type;
+  size_t length;
+  size_t found = 0;
+  size_t probes;
+  size_t rejects;
+  size_t falsePositives;
+  size_t i;
+  size_t j;
+
+  check(FT_initWithOptions(options), "FT_initWithOptions");
+  for(i = 0; i < numDirs; i++) {
+    for(j = 0; j < numFiles; j++) {
+      sprintf(path, "root/dir%04lu/file%06lu", (unsigned long) i,
+              (unsigned long) (j * NUMBER_STEP));
+      check(FT_insertFile(path, NULL, 0), "FT_insertFile");
+    }
+  }
+
+  state = 1;
+  start = Bench_start();
+  for(i = 0; i < NUM_LOOKUPS; i++) {
+    sprintf(path, "root/dir%04lu/file%06lu",
+            (unsigned long) randomBelow(numDirs),
+            (unsigned long) randomBelow(numFiles * NUMBER_STEP));
+    if(i % 2 == 0)
+      found += FT_containsFile(path);
+    else
+      found += (FT_stat(path, &type, &length) == SUCCESS);
+  }
+  elapsed = Bench_since(start);
+
+  check(FT_getFilterStats(&probes, &rejects, &falsePositives),
+        "FT_getFilterStats");
+  printf("%-8s %5lu x %5lu %8.1f ns %6.1f%% %9lu %9lu %6.2f%%\n",
+         label, (unsigned long) numDirs, (unsigned long) numFiles,
+         elapsed / NUM_LOOKUPS * 1e9, 100.0 * found / NUM_LOOKUPS,
+         (unsigned long) probes, (unsigned long) rejects,
+         rejects + falsePositives == 0 ? 0.0 :
+         100.0 * falsePositives / (rejects + falsePositives));
+  check(FT_destroy(), "FT_destroy");
+}
+
+/* Measures miss-heavy lookups with and without Bloom filters, for
+   each of shapes. Returns 0. */
+int main(void) {
+  size_t k;
+
+  printf("%-8s %13s %11s %7s %9s %9s %7s\n", "", "dirs x files",
+         "per lookup", "found", "probes", "rejects", "false+");
+  for(k = 0; k < sizeof(shapes) / sizeof(shapes[0]); k++) {
+    run("plain", 0, shapes[k][0], shapes[k][1]);
+    run("filters", FT_BLOOM_FILTERS, shapes[k][0], shapes[k][1]);
+  }
+  return 0;
+}
@@ -0,0 +1,213 @@
+/*--------------------------------------------------------------------*/
+/* bench_search.c                                                     */
+/*--------------------------------------------------------------------*/
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "dynarraydef.h"
+#include "bench.h"
+
+/* The number of searches timed for each length. */
+enum { NUM_SEARCHES = 1000000 };
+
+/* The number of times each measurement is repeated, of which the
+   quickest is reported. */
+enum { NUM_RUNS = 3 };
+
+/* The lengths measured, on both sides of DYNARRAY_BRANCHLESS_MAX. */
+static const size_t lengths[] = {
+  256, 16384, 65536, 65537, 262144, 1048576
+};
+
+/* An element: a number, and a name made from it. */
+struct Item {
+  long key;
+  char name[24];
+};
+
+/* The sum of the results of the searches, kept so that they are not
+   optimized away. */
+static volatile size_t found;
+
+/* The state of the pseudo-random number generator. */
+static unsigned long state = 7;
+
+/* Returns the next pseudo-random number below bound. */
+static size_t randomBelow(size_t bound) {
+  state = (state * 1103515245UL + 12345UL) & 0x7fffffffUL;
+  return (size_t) (state >> 4) % bound;
+}
+
+/* Compares the number at pvKey with the number of the item at
+   pvItem. */
+static int compareKey(const void* pvKey, const void* pvItem) {
+  long key = *(const long*) pvKey;
+  long itemKey = ((const struct Item*) pvItem)->key;
+
+  return (key > itemKey) - (key < itemKey);
+}
+
+/* Compares the name at pvName with the name of the item at pvItem. */
+static int compareName(const void* pvName, const void* pvItem) {
+  return strcmp(pvName, ((const struct Item*) pvItem)->name);
+}
+
+/* Searches the length elements at array for key, as
+   DynArray_bsearchKey does, by the classic three-way binary search
+   that it uses only for arrays longer than DYNARRAY_BRANCHLESS_MAX. */
+static int threeWay(const void** array, size_t length, const void* key,
+                    size_t* pIndex,
+                    int (*compare)(const void* key,
+                                   const void* element)) {
+  size_t low = 0;
+  size_t high = length;
+  size_t mid;
+  int result;
+
+  while(low < high) {
+    mid = low + (high - low) / 2;
+    result = compare(key, array[mid]);
+    if(result == 0) {
+      *pIndex = mid;
+      return 1;
+    }
+    if(result < 0)
+      high = mid;
+    else
+      low = mid + 1;
+  }
+  *pIndex = low;
+  return 0;
+}
+
+/* Measures searches of a DynArray of length items, scattered in
+   memory as separately allocated nodes are, by number and by name,
+   with the three-way search, with DynArray_bsearchKey, and with
+   DynArray_bsearchKey once the DynArray is frozen, printing the best
+   of NUM_RUNS times for each. */
+static void run(size_t length) {
+  struct Item* items;
+  size_t* places;
+  long* keys;
+  char (*names)[24];
+  const void** array;
+  DynArray_T oArray;
+  clock_t start;
+  double best[6];
+  double elapsed;
+  size_t index;
+  size_t attempt;
+  size_t place;
+  size_t i;
+  size_t j;
+  int m;
+
+  items = malloc(length * sizeof(struct Item));
+  places = malloc(length * sizeof(size_t));
+  keys = malloc(NUM_SEARCHES * sizeof(long));
+  names = malloc(NUM_SEARCHES * sizeof(names[0]));
+  oArray = DynArray_new(0);
+  if(items == NULL || places == NULL || keys == NULL || names == NULL ||
+     oArray == NULL || ! DynArray_reserve(oArray, length)) {
+    fprintf(stderr, "insufficient memory\n");
+    exit(EXIT_FAILURE);
+  }
+
+  /* Placing the items in memory in a shuffled order. */
+  for(i = 0; i < length; i++)
+    places[i] = i;
+  for(i = length; i > 1; i--) {
+    j = randomBelow(i);
+    place = places[i - 1];
+    places[i - 1] = places[j];
+    places[j] = place;
+  }
+  for(i = 0; i < length; i++) {
+    items[places[i]].key = (long) (2 * i);
+    sprintf(items[places[i]].name, "file%09lu",
+            (unsigned long) (2 * i));
+    (void) DynArray_add(oArray, &items[places[i]]);
+  }
+  for(i = 0; i < NUM_SEARCHES; i++) {
+    keys[i] = (long) randomBelow(2 * length);
+    sprintf(names[i], "file%09lu", (unsigned long) keys[i]);
+  }
+
+  for(m = 0; m < 6; m++)
+    best[m] = 1e9;
+  for(attempt = 0; attempt < NUM_RUNS; attempt++) {
+    for(m = 0; m < 6; m++) {
+      /* Getting the array thaws the DynArray for the searches in
+         place, and the frozen searches come after them. */
+      if(m == 0)
+        array = DynArray_getArray(oArray);
+      if(m == 4 && ! DynArray_freeze(oArray)) {
+        fprintf(stderr, "insufficient memory\n");
+        exit(EXIT_FAILURE);
+      }
+      start = Bench_start();
+      for(i = 0; i < NUM_SEARCHES; i++) {
+        switch(m) {
+        case 0:
+          found += threeWay(array, length, &keys[i], &index,
+                            compareKey);
+          break;
+        case 1:
+          found += DynArray_bsearchKey(oArray, &keys[i], &index,
+                                       compareKey);
+          break;
+        case 2:
+          found += threeWay(array, length, names[i], &index,
+                            compareName);
+          break;
+        case 3:
+          found += DynArray_bsearchKey(oArray, names[i], &index,
+                                       compareName);
+          break;
+        case 4:
+          found += DynArray_bsearchKey(oArray, &keys[i], &index,
+                                       compareKey);
+          break;
+        default:
+          found += DynArray_bsearchKey(oArray, names[i], &index,
+                                       compareName);
+          break;
+        }
+      }
+      elapsed = Bench_since(start);
+      if(elapsed < best[m])
+        best[m] = elapsed;
+    }
+  }
+
+  printf("%8lu %10.1f ns %9.1f ns %10.1f ns %9.1f ns %10.1f ns %9.1f ns"
+         "   %s\n", (unsigned long) length,
+         best[0] / NUM_SEARCHES * 1e9, best[1] / NUM_SEARCHES * 1e9,
+         best[2] / NUM_SEARCHES * 1e9, best[3] / NUM_SEARCHES * 1e9,
+         best[4] / NUM_SEARCHES * 1e9, best[5] / NUM_SEARCHES * 1e9,
+         length > DYNARRAY_BRANCHLESS_MAX ? "three-way" : "branchless");
+  DynArray_free(oArray);
+  free(items);
+  free(places);
+  free(keys);
+  free(names);
+}
+
+/* Measures DynArray_bsearchKey, which searches by a branchless lower
+   bound up to DYNARRAY_BRANCHLESS_MAX elements and three ways beyond,
+   and its search of the frozen layout, against the three-way search
+   alone at each of lengths. Returns 0. */
+int main(void) {
+  size_t k;
+
+  printf("%8s %26s %26s %26s\n", "", "number", "name",
+         "frozen number / name");
+  printf("%8s %13s %12s %13s %12s %13s %12s   %s\n", "length",
+         "three-way", "DynArray", "three-way", "DynArray", "DynArray",
+         "DynArray", "unfrozen mode");
+  for(k = 0; k < sizeof(lengths) / sizeof(lengths[0]); k++)
+    run(lengths[k]);
+  return 0;
+}
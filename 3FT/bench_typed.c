@@ -0,0 +1,197 @@
+/*--------------------------------------------------------------------*/
+/* bench_typed.c                                                      */
+/*--------------------------------------------------------------------*/
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "dynarraydef.h"
+#include "bench.h"
+
+/* The number of searches timed for each length. */
+enum { NUM_SEARCHES = 2000000 };
+
+/* The number of times each measurement is repeated, of which the
+   quickest is reported. */
+enum { NUM_RUNS = 3 };
+
+/* The lengths measured. */
+static const size_t lengths[] = { 1000, 100000 };
+
+/* An element: a number, and a name made from it. */
+struct Item {
+  long key;
+  char name[24];
+};
+
+/* The sum of the results of the searches, kept so that they are not
+   optimized away. */
+static volatile size_t found;
+
+/* The state of the pseudo-random number generator. */
+static unsigned long state = 7;
+
+/* Returns the next pseudo-random number below bound. */
+static size_t randomBelow(size_t bound) {
+  state = (state * 1103515245UL + 12345UL) & 0x7fffffffUL;
+  return (size_t) (state >> 4) % bound;
+}
+
+/* Compares key with the number of item. */
+static int compareKey(long key, const struct Item* item) {
+  return (key > item->key) - (key < item->key);
+}
+
+/* Compares name with the name of item. */
+static int compareName(const char* name, const struct Item* item) {
+  return strcmp(name, item->name);
+}
+
+/* Compares item1 and item2 by name. */
+static int compareItems(const struct Item* item1,
+                        const struct Item* item2) {
+  return strcmp(item1->name, item2->name);
+}
+
+/* The comparisons above, taking and passing void pointers, for the
+   generic DynArray functions. */
+static int compareKeyGeneric(const void* pvKey, const void* pvItem) {
+  return compareKey(*(const long*) pvKey, pvItem);
+}
+static int compareNameGeneric(const void* pvName, const void* pvItem) {
+  return compareName(pvName, pvItem);
+}
+static int compareItemsGeneric(const void* pvItem1, const void* pvItem2) {
+  return compareItems(pvItem1, pvItem2);
+}
+
+/* KeyArray_T and NameArray_T are DynArrays of items sought by number
+   and by name, both sorted by name, which orders them as their numbers
+   do. */
+DYNARRAY_DECLARE(KeyArray, const struct Item*, long)
+DYNARRAY_DEFINE(KeyArray, const struct Item*, compareItems, long,
+                compareKey)
+DYNARRAY_DECLARE(NameArray, const struct Item*, const char*)
+DYNARRAY_DEFINE(NameArray, const struct Item*, compareItems,
+                const char*, compareName)
+
+/* Shuffles the elements of oArray. */
+static void shuffle(DynArray_T oArray) {
+  size_t i;
+  size_t j;
+  void* pv;
+
+  for(i = DynArray_getLength(oArray); i > 1; i--) {
+    j = randomBelow(i);
+    pv = DynArray_set(oArray, i - 1, DynArray_get(oArray, j));
+    (void) DynArray_set(oArray, j, pv);
+  }
+}
+
+/* Measures the searches and sorts of generic and typed DynArrays of
+   length items, printing the best of NUM_RUNS times for each. */
+static void run(size_t length) {
+  struct Item* items;
+  long* keys;
+  char (*names)[24];
+  DynArray_T oArray;
+  clock_t start;
+  double best[6];
+  double elapsed;
+  double shuffling;
+  size_t index;
+  size_t sorts;
+  size_t attempt;
+  size_t i;
+  int m;
+
+  items = malloc(length * sizeof(struct Item));
+  keys = malloc(NUM_SEARCHES * sizeof(long));
+  names = malloc(NUM_SEARCHES * sizeof(names[0]));
+  oArray = DynArray_new(0);
+  if(items == NULL || keys == NULL || names == NULL || oArray == NULL) {
+    fprintf(stderr, "insufficient memory\n");
+    exit(EXIT_FAILURE);
+  }
+  for(i = 0; i < length; i++) {
+    items[i].key = (long) (2 * i);
+    sprintf(items[i].name, "n%08lu", (unsigned long) (2 * i));
+    if(! DynArray_add(oArray, &items[i])) {
+      fprintf(stderr, "insufficient memory\n");
+      exit(EXIT_FAILURE);
+    }
+  }
+  for(i = 0; i < NUM_SEARCHES; i++) {
+    keys[i] = (long) randomBelow(2 * length);
+    sprintf(names[i], "n%08lu", (unsigned long) keys[i]);
+  }
+  /* Sorting about as many elements in all at each length. */
+  sorts = 2000000 / length;
+
+  for(m = 0; m < 6; m++)
+    best[m] = 1e9;
+  for(attempt = 0; attempt < NUM_RUNS; attempt++) {
+    for(m = 0; m < 6; m++) {
+      start = Bench_start();
+      shuffling = 0;
+      for(i = 0; i < (m < 4 ? NUM_SEARCHES : sorts); i++) {
+        switch(m) {
+        case 0:
+          found += DynArray_bsearchKey(oArray, &keys[i], &index,
+                                       compareKeyGeneric);
+          break;
+        case 1:
+          found += KeyArray_bsearchKey((KeyArray_T) oArray, keys[i],
+                                       &index);
+          break;
+        case 2:
+          found += DynArray_bsearchKey(oArray, names[i], &index,
+                                       compareNameGeneric);
+          break;
+        case 3:
+          found += NameArray_bsearchKey((NameArray_T) oArray, names[i],
+                                        &index);
+          break;
+        default:
+          /* Timing only the sort, not the shuffle before it. */
+          shuffling -= Bench_since(start);
+          shuffle(oArray);
+          shuffling += Bench_since(start);
+          if(m == 4)
+            DynArray_sort(oArray, compareItemsGeneric);
+          else
+            KeyArray_sort((KeyArray_T) oArray);
+          break;
+        }
+      }
+      elapsed = Bench_since(start) - shuffling;
+      if(elapsed < best[m])
+        best[m] = elapsed;
+    }
+  }
+
+  printf("%8lu %9.1f ns %6.1f ns %9.1f ns %6.1f ns %9.1f us %6.1f us\n",
+         (unsigned long) length,
+         best[0] / NUM_SEARCHES * 1e9, best[1] / NUM_SEARCHES * 1e9,
+         best[2] / NUM_SEARCHES * 1e9, best[3] / NUM_SEARCHES * 1e9,
+         best[4] / sorts * 1e6, best[5] / sorts * 1e6);
+  DynArray_free(oArray);
+  free(items);
+  free(keys);
+  free(names);
+}
+
+/* Measures generic against typed DynArrays at each of lengths.
+   Returns 0. */
+int main(void) {
+  size_t k;
+
+  printf("%8s %22s %22s %22s\n", "", "number bsearch",
+         "name bsearch", "name sort");
+  printf("%8s %12s %9s %12s %9s %12s %9s\n", "length", "generic",
+         "typed", "generic", "typed", "generic", "typed");
+  for(k = 0; k < sizeof(lengths) / sizeof(lengths[0]); k++)
+    run(lengths[k]);
+  return 0;
+}
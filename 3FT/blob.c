@@ -0,0 +1,325 @@
+/*--------------------------------------------------------------------*/
+/* blob.c                                                             */
+/*--------------------------------------------------------------------*/
+
+#include "blob.h"
+#include "hash.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*--------------------------------------------------------------------*/
+
+/* The number of slots in the table of a new Blob object. */
+
+static const size_t MIN_CAPACITY = 64;
+
+/* The odd multiplier with which Blob_hash mixes each word of data. */
+
+static const size_t HASH_MULTIPLIER = (size_t)0x9E3779B1U;
+
+/*--------------------------------------------------------------------*/
+
+/* A type whose alignment suits any object. */
+
+union BlobAlign
+{
+   long double ld;
+   double d;
+   long l;
+   void *pv;
+   void (*pf)(void);
+};
+
+/* The header of a stored byte string, which is followed in the same
+   allocation by the bytes themselves. */
+
+union BlobData
+{
+   struct
+   {
+      /* The number of references not yet released. */
+      size_t uRefs;
+
+      /* The hash of the bytes. */
+      size_t uHash;
+
+      /* The number of bytes. */
+      size_t uLength;
+   } sInfo;
+
+   /* Padding, so that the bytes that follow are aligned. */
+   union BlobAlign uAlign;
+};
+
+/* A Blob object is an open-addressing hash table, using linear
+   probing, of its byte strings. */
+
+struct Blob
+{
+   /* The slots of the table, each the header of a byte string or
+      NULL. */
+   union BlobData **ppuSlots;
+
+   /* The number of slots, a power of two. */
+   size_t uCapacity;
+
+   /* The number of byte strings in the table. */
+   size_t uLength;
+
+   /* The total length of the byte strings in the table. */
+   size_t uBytes;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Return a hash of the uLength bytes at pvData, mixing in a word at a
+   time where FNV-1a, which suits short names, would take a byte. */
+
+static size_t Blob_hash(const void *pvData, size_t uLength)
+{
+   const unsigned char *pucData = (const unsigned char*)pvData;
+   size_t uHash = uLength;
+   size_t uWord;
+
+   assert(pvData != NULL || uLength == 0);
+
+   for (; uLength >= sizeof(size_t); uLength -= sizeof(size_t))
+   {
+      memcpy(&uWord, pucData, sizeof(size_t));
+      uHash = (uHash ^ uWord) * HASH_MULTIPLIER;
+      uHash ^= uHash >> 15;
+      pucData += sizeof(size_t);
+   }
+   for (; uLength > 0; uLength--)
+   {
+      uHash = (uHash ^ *pucData++) * HASH_MULTIPLIER;
+      uHash ^= uHash >> 15;
+   }
+   return uHash;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the bytes of the byte string whose header is puData. */
+
+static unsigned char *Blob_bytes(union BlobData *puData)
+{
+   assert(puData != NULL);
+
+   return (unsigned char*)(puData + 1);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* If the table slot at pvSlot holds a byte string, store its hash in
+   *puHash and return 1; otherwise return 0. */
+
+static int Blob_getHash(const void *pvSlot, size_t *puHash)
+{
+   const union BlobData *puData;
+
+   assert(pvSlot != NULL);
+   assert(puHash != NULL);
+
+   puData = *(union BlobData *const*)pvSlot;
+   if (puData == NULL)
+      return 0;
+   *puHash = puData->sInfo.uHash;
+   return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the index of the slot of oBlob holding the uLength bytes at
+   pvData, which hash to uHash, or of the empty slot ending their probe
+   sequence if oBlob has no such byte string. */
+
+static size_t Blob_slot(Blob_T oBlob, const void *pvData,
+                        size_t uLength, size_t uHash)
+{
+   union BlobData *puData;
+   size_t uMask;
+   size_t u;
+
+   assert(oBlob != NULL);
+   assert(pvData != NULL || uLength == 0);
+
+   uMask = oBlob->uCapacity - 1;
+   for (u = uHash & uMask; oBlob->ppuSlots[u] != NULL;
+        u = (u + 1) & uMask)
+   {
+      puData = oBlob->ppuSlots[u];
+      if (puData->sInfo.uHash == uHash &&
+          puData->sInfo.uLength == uLength &&
+          (uLength == 0 ||
+           memcmp(Blob_bytes(puData), pvData, uLength) == 0))
+         break;
+   }
+   return u;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Double the number of slots of oBlob.  Return 1 (TRUE) if successful,
+   or 0 (FALSE) if insufficient memory is available. */
+
+static int Blob_grow(Blob_T oBlob)
+{
+   union BlobData **ppuNewSlots;
+   size_t uNewCapacity;
+   size_t uMask;
+   size_t u;
+   size_t v;
+
+   assert(oBlob != NULL);
+
+   uNewCapacity = oBlob->uCapacity * 2;
+   ppuNewSlots = (union BlobData**)calloc(uNewCapacity,
+      sizeof(union BlobData*));
+   if (ppuNewSlots == NULL)
+      return 0;
+
+   uMask = uNewCapacity - 1;
+   for (u = 0; u < oBlob->uCapacity; u++)
+   {
+      if (oBlob->ppuSlots[u] == NULL)
+         continue;
+      for (v = oBlob->ppuSlots[u]->sInfo.uHash & uMask;
+           ppuNewSlots[v] != NULL; v = (v + 1) & uMask)
+         ;
+      ppuNewSlots[v] = oBlob->ppuSlots[u];
+   }
+
+   free(oBlob->ppuSlots);
+   oBlob->ppuSlots = ppuNewSlots;
+   oBlob->uCapacity = uNewCapacity;
+   return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+Blob_T Blob_new(void)
+{
+   Blob_T oBlob;
+
+   oBlob = (struct Blob*)malloc(sizeof(struct Blob));
+   if (oBlob == NULL)
+      return NULL;
+
+   oBlob->ppuSlots = (union BlobData**)calloc(MIN_CAPACITY,
+      sizeof(union BlobData*));
+   if (oBlob->ppuSlots == NULL)
+   {
+      free(oBlob);
+      return NULL;
+   }
+   oBlob->uCapacity = MIN_CAPACITY;
+   oBlob->uLength = 0;
+   oBlob->uBytes = 0;
+
+   return oBlob;
+}
+
+/*--------------------------------------------------------------------*/
+
+void Blob_free(Blob_T oBlob)
+{
+   size_t u;
+
+   assert(oBlob != NULL);
+
+   for (u = 0; u < oBlob->uCapacity; u++)
+      free(oBlob->ppuSlots[u]);
+   free(oBlob->ppuSlots);
+   free(oBlob);
+}
+
+/*--------------------------------------------------------------------*/
+
+const void *Blob_add(Blob_T oBlob, const void *pvData, size_t uLength)
+{
+   union BlobData *puData;
+   size_t uHash;
+   size_t u;
+
+   assert(oBlob != NULL);
+   assert(pvData != NULL || uLength == 0);
+
+   uHash = Blob_hash(pvData, uLength);
+   u = Blob_slot(oBlob, pvData, uLength, uHash);
+   if (oBlob->ppuSlots[u] != NULL)
+   {
+      puData = oBlob->ppuSlots[u];
+      puData->sInfo.uRefs++;
+      return Blob_bytes(puData);
+   }
+
+   /* Keeping the table at most half full. */
+   if ((oBlob->uLength + 1) * 2 > oBlob->uCapacity)
+   {
+      if (! Blob_grow(oBlob))
+         return NULL;
+      u = Blob_slot(oBlob, pvData, uLength, uHash);
+   }
+
+   puData = (union BlobData*)malloc(sizeof(union BlobData) + uLength);
+   if (puData == NULL)
+      return NULL;
+   puData->sInfo.uRefs = 1;
+   puData->sInfo.uHash = uHash;
+   puData->sInfo.uLength = uLength;
+   if (uLength != 0)
+      memcpy(Blob_bytes(puData), pvData, uLength);
+
+   oBlob->ppuSlots[u] = puData;
+   oBlob->uLength++;
+   oBlob->uBytes += uLength;
+   return Blob_bytes(puData);
+}
+
+/*--------------------------------------------------------------------*/
+
+void Blob_release(Blob_T oBlob, const void *pvData)
+{
+   union BlobData *puData;
+   union BlobData *puEmpty = NULL;
+   size_t uMask;
+   size_t u;
+
+   assert(oBlob != NULL);
+   assert(pvData != NULL);
+
+   puData = (union BlobData*)pvData - 1;
+   assert(puData->sInfo.uRefs > 0);
+   if (--puData->sInfo.uRefs > 0)
+      return;
+
+   uMask = oBlob->uCapacity - 1;
+   for (u = puData->sInfo.uHash & uMask; oBlob->ppuSlots[u] != puData;
+        u = (u + 1) & uMask)
+      assert(oBlob->ppuSlots[u] != NULL);
+   Hash_remove(oBlob->ppuSlots, sizeof(union BlobData*),
+               oBlob->uCapacity, u, &puEmpty, Blob_getHash);
+   oBlob->uLength--;
+   oBlob->uBytes -= puData->sInfo.uLength;
+   free(puData);
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t Blob_getLength(Blob_T oBlob)
+{
+   assert(oBlob != NULL);
+
+   return oBlob->uLength;
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t Blob_getBytes(Blob_T oBlob)
+{
+   assert(oBlob != NULL);
+
+   return oBlob->uBytes;
+}
@@ -0,0 +1,62 @@
+/*--------------------------------------------------------------------*/
+/* blob.h                                                             */
+/*--------------------------------------------------------------------*/
+
+#ifndef BLOB_INCLUDED
+#define BLOB_INCLUDED
+
+#include <stddef.h>
+
+/* A Blob_T object is a pool of byte strings, of any length and
+   content, in which each distinct byte string is stored once, however
+   many times it is added. Each stored copy keeps a count of its
+   additions and is freed when as many releases drop the count to
+   zero. The copies are suitably aligned for any type, and must not be
+   modified, since they may be shared. */
+
+typedef struct Blob *Blob_T;
+
+/*--------------------------------------------------------------------*/
+
+/* Return a new empty Blob_T object, or NULL if insufficient memory is
+   available. */
+
+Blob_T Blob_new(void);
+
+/*--------------------------------------------------------------------*/
+
+/* Free oBlob and every byte string in it, whether or not the byte
+   strings have been released. */
+
+void Blob_free(Blob_T oBlob);
+
+/*--------------------------------------------------------------------*/
+
+/* Add the uLength bytes at pvData, which may be NULL if uLength is 0,
+   to oBlob, and return the pool's copy of them, counting one more
+   reference to it. Return NULL if insufficient memory is
+   available. */
+
+const void *Blob_add(Blob_T oBlob, const void *pvData, size_t uLength);
+
+/*--------------------------------------------------------------------*/
+
+/* Drop one reference to pvData, a copy returned by Blob_add on oBlob,
+   freeing it if no references remain. */
+
+void Blob_release(Blob_T oBlob, const void *pvData);
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of distinct byte strings in oBlob. */
+
+size_t Blob_getLength(Blob_T oBlob);
+
+/*--------------------------------------------------------------------*/
+
+/* Return the total length of the distinct byte strings in oBlob,
+   counting each once however many references it has. */
+
+size_t Blob_getBytes(Blob_T oBlob);
+
+#endif
@@ -0,0 +1,1028 @@
+/*--------------------------------------------------------------------*/
+/* btree.c                                                            */
+/*--------------------------------------------------------------------*/
+
+#include "btree.h"
+#include <assert.h>
+#include <stdlib.h>
+
+/*--------------------------------------------------------------------*/
+
+/* The most elements that a leaf holds, and the most children that an
+   inner node has, so that a leaf fills two 64-byte cache lines and an
+   inner node nearly four.  Every node but the root holds at least
+   half as many. */
+
+enum { LEAF_MAX = 14, LEAF_MIN = LEAF_MAX / 2 };
+enum { INNER_MAX = 10, INNER_MIN = INNER_MAX / 2 };
+
+/* The greatest number of levels of inner nodes, which, with every
+   node at its minimum, would hold more elements than memory can. */
+
+enum { MAX_HEIGHT = 40 };
+
+/*--------------------------------------------------------------------*/
+
+/* The total length of all BTree objects that have not been freed, and
+   the total size of their nodes, kept up to date as they change so
+   that BTree_getTotals need not visit them. */
+
+static size_t uTotalLength;
+static size_t uTotalBytes;
+
+/*--------------------------------------------------------------------*/
+
+/* A leaf holds a run of consecutive elements of a BTree. */
+
+struct BTreeLeaf
+{
+   /* The number of elements in the leaf. */
+   size_t uLength;
+
+   /* The leaf holding the elements that follow, or NULL. */
+   struct BTreeLeaf *psNext;
+
+   /* The elements, in order. */
+   const void *apvElements[LEAF_MAX];
+};
+
+/* An inner node holds the roots of consecutive subtrees, all of the
+   same height, along with what a search needs to know of each without
+   visiting it. */
+
+struct BTreeInner
+{
+   /* The number of children of the node. */
+   size_t uLength;
+
+   /* The number of elements beneath each child. */
+   size_t auCounts[INNER_MAX];
+
+   /* The first element beneath each child. */
+   const void *apvFirst[INNER_MAX];
+
+   /* The children: leaves, if the node is just above them, and
+      otherwise inner nodes. */
+   void *apvChildren[INNER_MAX];
+};
+
+/* A BTree consists of the root of its B+-tree, which is a leaf while
+   there are few elements, and a finger on the leaf last visited. */
+
+struct BTree
+{
+   /* The number of elements in the BTree. */
+   size_t uLength;
+
+   /* The number of levels of inner nodes above the leaves. */
+   size_t uHeight;
+
+   /* The root: a leaf if uHeight is 0, and an inner node
+      otherwise. */
+   void *pvRoot;
+
+   /* The leaf last visited by BTree_get or BTree_bsearchKey, or NULL
+      if it may have changed since, and the index of its first
+      element. */
+   struct BTreeLeaf *psFinger;
+   size_t uFingerStart;
+};
+
+/*--------------------------------------------------------------------*/
+
+#ifndef NDEBUG
+
+/* Check the invariants of oBTree that can be checked without visiting
+   its nodes.  Return 1 (TRUE) iff oBTree is in a valid state. */
+
+static int BTree_isValid(BTree_T oBTree)
+{
+   struct BTreeLeaf *psLeaf;
+
+   if (oBTree->pvRoot == NULL) return 0;
+   if (oBTree->uHeight >= MAX_HEIGHT) return 0;
+   if (oBTree->uHeight == 0)
+   {
+      psLeaf = (struct BTreeLeaf*)oBTree->pvRoot;
+      if (psLeaf->uLength != oBTree->uLength) return 0;
+   }
+   else if (((struct BTreeInner*)oBTree->pvRoot)->uLength < 2)
+      return 0;
+   return 1;
+}
+
+#endif
+
+/*--------------------------------------------------------------------*/
+
+/* Return a new empty leaf, or NULL if insufficient memory is
+   available. */
+
+static struct BTreeLeaf *BTree_newLeaf(void)
+{
+   struct BTreeLeaf *psLeaf;
+
+   psLeaf = (struct BTreeLeaf*)malloc(sizeof(struct BTreeLeaf));
+   if (psLeaf == NULL)
+      return NULL;
+   uTotalBytes += sizeof(struct BTreeLeaf);
+   psLeaf->uLength = 0;
+   psLeaf->psNext = NULL;
+   return psLeaf;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return a new inner node without children, or NULL if insufficient
+   memory is available. */
+
+static struct BTreeInner *BTree_newInner(void)
+{
+   struct BTreeInner *psInner;
+
+   psInner = (struct BTreeInner*)malloc(sizeof(struct BTreeInner));
+   if (psInner == NULL)
+      return NULL;
+   uTotalBytes += sizeof(struct BTreeInner);
+   psInner->uLength = 0;
+   return psInner;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Free pvNode, a leaf if uHeight is 0 and otherwise an inner node
+   with uHeight levels of inner nodes at and below it, without its
+   children. */
+
+static void BTree_freeShallow(void *pvNode, size_t uHeight)
+{
+   assert(pvNode != NULL);
+
+   if (uHeight == 0)
+      uTotalBytes -= sizeof(struct BTreeLeaf);
+   else
+      uTotalBytes -= sizeof(struct BTreeInner);
+   free(pvNode);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Free pvNode, as BTree_freeShallow does, and everything beneath
+   it. */
+
+static void BTree_freeNode(void *pvNode, size_t uHeight)
+{
+   struct BTreeInner *psInner;
+   size_t u;
+
+   assert(pvNode != NULL);
+
+   if (uHeight > 0)
+   {
+      psInner = (struct BTreeInner*)pvNode;
+      for (u = 0; u < psInner->uLength; u++)
+         BTree_freeNode(psInner->apvChildren[u], uHeight - 1);
+   }
+   BTree_freeShallow(pvNode, uHeight);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of elements or children, as uHeight is 0 or not,
+   held directly by pvNode. */
+
+static size_t BTree_entriesOf(const void *pvNode, size_t uHeight)
+{
+   assert(pvNode != NULL);
+
+   if (uHeight == 0)
+      return ((const struct BTreeLeaf*)pvNode)->uLength;
+   return ((const struct BTreeInner*)pvNode)->uLength;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of elements beneath pvNode, which has uHeight
+   levels of inner nodes at and below it. */
+
+static size_t BTree_countOf(const void *pvNode, size_t uHeight)
+{
+   const struct BTreeInner *psInner;
+   size_t uCount;
+   size_t u;
+
+   assert(pvNode != NULL);
+
+   if (uHeight == 0)
+      return ((const struct BTreeLeaf*)pvNode)->uLength;
+   psInner = (const struct BTreeInner*)pvNode;
+   uCount = 0;
+   for (u = 0; u < psInner->uLength; u++)
+      uCount += psInner->auCounts[u];
+   return uCount;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the first element beneath pvNode, which has uHeight levels
+   of inner nodes at and below it and must not be empty. */
+
+static const void *BTree_firstOf(const void *pvNode, size_t uHeight)
+{
+   assert(pvNode != NULL);
+   assert(BTree_entriesOf(pvNode, uHeight) > 0);
+
+   if (uHeight == 0)
+      return ((const struct BTreeLeaf*)pvNode)->apvElements[0];
+   return ((const struct BTreeInner*)pvNode)->apvFirst[0];
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Record in slot uSlot of psInner the count and first element of its
+   child there, which has uHeight levels of inner nodes at and below
+   it. */
+
+static void BTree_refresh(struct BTreeInner *psInner, size_t uSlot,
+                          size_t uHeight)
+{
+   assert(psInner != NULL);
+   assert(uSlot < psInner->uLength);
+
+   psInner->auCounts[uSlot] =
+      BTree_countOf(psInner->apvChildren[uSlot], uHeight);
+   psInner->apvFirst[uSlot] =
+      BTree_firstOf(psInner->apvChildren[uSlot], uHeight);
+}
+
+/*--------------------------------------------------------------------*/
+
+BTree_T BTree_new(void)
+{
+   BTree_T oBTree;
+
+   oBTree = (BTree_T)malloc(sizeof(struct BTree));
+   if (oBTree == NULL)
+      return NULL;
+
+   oBTree->pvRoot = BTree_newLeaf();
+   if (oBTree->pvRoot == NULL)
+   {
+      free(oBTree);
+      return NULL;
+   }
+   oBTree->uLength = 0;
+   oBTree->uHeight = 0;
+   oBTree->psFinger = NULL;
+   oBTree->uFingerStart = 0;
+
+   assert(BTree_isValid(oBTree));
+
+   return oBTree;
+}
+
+/*--------------------------------------------------------------------*/
+
+BTree_T BTree_fromArray(const void **ppvArray, size_t uLength)
+{
+   BTree_T oBTree;
+   struct BTreeLeaf *psLeaf;
+   struct BTreeInner *psInner;
+   void **ppvLevel;
+   void **ppvUpper;
+   size_t uNodes;
+   size_t uUppers;
+   size_t uHeight;
+   size_t uNext;
+   size_t u;
+   size_t v;
+
+   assert(ppvArray != NULL || uLength == 0);
+
+   if (uLength == 0)
+      return BTree_new();
+
+   oBTree = (BTree_T)malloc(sizeof(struct BTree));
+   if (oBTree == NULL)
+      return NULL;
+
+   /* Filling the leaves as evenly as possible, so that each holds at
+      least LEAF_MIN elements unless there is only one. */
+   uNodes = (uLength + LEAF_MAX - 1) / LEAF_MAX;
+   ppvLevel = (void**)malloc(uNodes * sizeof(void*));
+   if (ppvLevel == NULL)
+   {
+      free(oBTree);
+      return NULL;
+   }
+   uNext = 0;
+   psLeaf = NULL;
+   for (u = 0; u < uNodes; u++)
+   {
+      ppvLevel[u] = BTree_newLeaf();
+      if (ppvLevel[u] == NULL)
+      {
+         while (u-- > 0)
+            BTree_freeShallow(ppvLevel[u], 0);
+         free(ppvLevel);
+         free(oBTree);
+         return NULL;
+      }
+      if (psLeaf != NULL)
+         psLeaf->psNext = (struct BTreeLeaf*)ppvLevel[u];
+      psLeaf = (struct BTreeLeaf*)ppvLevel[u];
+      psLeaf->uLength = uLength / uNodes + (u < uLength % uNodes);
+      for (v = 0; v < psLeaf->uLength; v++)
+         psLeaf->apvElements[v] = ppvArray[uNext++];
+   }
+
+   /* Building each level of inner nodes over the one below, as
+      evenly, until one node remains. */
+   for (uHeight = 1; uNodes > 1; uHeight++)
+   {
+      uUppers = (uNodes + INNER_MAX - 1) / INNER_MAX;
+      ppvUpper = (void**)malloc(uUppers * sizeof(void*));
+      u = 0;
+      if (ppvUpper != NULL)
+      {
+         uNext = 0;
+         for (; u < uUppers; u++)
+         {
+            psInner = BTree_newInner();
+            if (psInner == NULL)
+               break;
+            ppvUpper[u] = psInner;
+            psInner->uLength = uNodes / uUppers + (u < uNodes % uUppers);
+            for (v = 0; v < psInner->uLength; v++)
+            {
+               psInner->apvChildren[v] = ppvLevel[uNext++];
+               BTree_refresh(psInner, v, uHeight - 1);
+            }
+         }
+      }
+      if (u < uUppers)
+      {
+         while (u-- > 0)
+            BTree_freeShallow(ppvUpper[u], uHeight);
+         free(ppvUpper);
+         for (u = 0; u < uNodes; u++)
+            BTree_freeNode(ppvLevel[u], uHeight - 1);
+         free(ppvLevel);
+         free(oBTree);
+         return NULL;
+      }
+      free(ppvLevel);
+      ppvLevel = ppvUpper;
+      uNodes = uUppers;
+   }
+
+   oBTree->pvRoot = ppvLevel[0];
+   free(ppvLevel);
+   oBTree->uLength = uLength;
+   oBTree->uHeight = uHeight - 1;
+   oBTree->psFinger = NULL;
+   oBTree->uFingerStart = 0;
+   uTotalLength += uLength;
+
+   assert(BTree_isValid(oBTree));
+
+   return oBTree;
+}
+
+/*--------------------------------------------------------------------*/
+
+void BTree_free(BTree_T oBTree)
+{
+   if (oBTree == NULL)
+      return;
+
+   uTotalLength -= oBTree->uLength;
+   BTree_freeNode(oBTree->pvRoot, oBTree->uHeight);
+   free(oBTree);
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t BTree_getLength(BTree_T oBTree)
+{
+   assert(oBTree != NULL);
+   assert(BTree_isValid(oBTree));
+
+   return oBTree->uLength;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the leaf of oBTree holding its uIndex'th element, and make
+   it the finger.  Reached from the finger when uIndex lies in it or
+   in the leaf after it, and by descending from the root otherwise. */
+
+static struct BTreeLeaf *BTree_findLeaf(BTree_T oBTree, size_t uIndex)
+{
+   struct BTreeLeaf *psLeaf;
+   struct BTreeInner *psInner;
+   void *pvNode;
+   size_t uStart;
+   size_t uHeight;
+   size_t u;
+
+   assert(oBTree != NULL);
+   assert(uIndex < oBTree->uLength);
+
+   psLeaf = oBTree->psFinger;
+   uStart = oBTree->uFingerStart;
+   if (psLeaf != NULL && uIndex >= uStart)
+   {
+      if (uIndex - uStart < psLeaf->uLength)
+         return psLeaf;
+      if (uIndex - uStart - psLeaf->uLength < psLeaf->psNext->uLength)
+      {
+         oBTree->uFingerStart = uStart + psLeaf->uLength;
+         oBTree->psFinger = psLeaf->psNext;
+         return psLeaf->psNext;
+      }
+   }
+
+   pvNode = oBTree->pvRoot;
+   uStart = 0;
+   for (uHeight = oBTree->uHeight; uHeight > 0; uHeight--)
+   {
+      psInner = (struct BTreeInner*)pvNode;
+      for (u = 0; uIndex - uStart >= psInner->auCounts[u]; u++)
+         uStart += psInner->auCounts[u];
+      pvNode = psInner->apvChildren[u];
+   }
+   oBTree->psFinger = (struct BTreeLeaf*)pvNode;
+   oBTree->uFingerStart = uStart;
+   return oBTree->psFinger;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *BTree_get(BTree_T oBTree, size_t uIndex)
+{
+   struct BTreeLeaf *psLeaf;
+
+   assert(oBTree != NULL);
+   assert(uIndex < oBTree->uLength);
+   assert(BTree_isValid(oBTree));
+
+   psLeaf = BTree_findLeaf(oBTree, uIndex);
+   return (void*)psLeaf->apvElements[uIndex - oBTree->uFingerStart];
+}
+
+/*--------------------------------------------------------------------*/
+
+void *BTree_set(BTree_T oBTree, size_t uIndex, const void *pvElement)
+{
+   struct BTreeLeaf *psLeaf;
+   struct BTreeInner *psInner;
+   const void *pvOldElement;
+   void *pvNode;
+   size_t uHeight;
+   size_t u;
+
+   assert(oBTree != NULL);
+   assert(uIndex < oBTree->uLength);
+   assert(BTree_isValid(oBTree));
+
+   psLeaf = BTree_findLeaf(oBTree, uIndex);
+   u = uIndex - oBTree->uFingerStart;
+   pvOldElement = psLeaf->apvElements[u];
+   psLeaf->apvElements[u] = pvElement;
+   if (u > 0)
+      return (void*)pvOldElement;
+
+   /* The element is first beneath the inner nodes on the way to its
+      leaf that it is first in. */
+   pvNode = oBTree->pvRoot;
+   for (uHeight = oBTree->uHeight; uHeight > 0; uHeight--)
+   {
+      psInner = (struct BTreeInner*)pvNode;
+      for (u = 0; uIndex >= psInner->auCounts[u]; u++)
+         uIndex -= psInner->auCounts[u];
+      if (uIndex == 0)
+         psInner->apvFirst[u] = pvElement;
+      pvNode = psInner->apvChildren[u];
+   }
+   return (void*)pvOldElement;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Insert pvElement into psLeaf at index uIndex.  If psRight is not
+   NULL, psLeaf must be full, and its elements and pvElement are split
+   between it and psRight, an empty leaf that follows it. */
+
+static void BTree_leafInsert(struct BTreeLeaf *psLeaf, size_t uIndex,
+                             const void *pvElement,
+                             struct BTreeLeaf *psRight)
+{
+   const void *apvAll[LEAF_MAX + 1];
+   size_t uLeft;
+   size_t u;
+
+   assert(psLeaf != NULL);
+   assert(uIndex <= psLeaf->uLength);
+
+   if (psRight == NULL)
+   {
+      assert(psLeaf->uLength < LEAF_MAX);
+      for (u = psLeaf->uLength; u > uIndex; u--)
+         psLeaf->apvElements[u] = psLeaf->apvElements[u - 1];
+      psLeaf->apvElements[uIndex] = pvElement;
+      psLeaf->uLength++;
+      return;
+   }
+
+   assert(psLeaf->uLength == LEAF_MAX);
+   for (u = 0; u < uIndex; u++)
+      apvAll[u] = psLeaf->apvElements[u];
+   apvAll[uIndex] = pvElement;
+   for (u = uIndex; u < LEAF_MAX; u++)
+      apvAll[u + 1] = psLeaf->apvElements[u];
+
+   uLeft = (LEAF_MAX + 1) / 2;
+   for (u = 0; u < uLeft; u++)
+      psLeaf->apvElements[u] = apvAll[u];
+   for (u = uLeft; u < LEAF_MAX + 1; u++)
+      psRight->apvElements[u - uLeft] = apvAll[u];
+   psLeaf->uLength = uLeft;
+   psRight->uLength = LEAF_MAX + 1 - uLeft;
+   psRight->psNext = psLeaf->psNext;
+   psLeaf->psNext = psRight;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Insert pvChild, which has uHeight levels of inner nodes at and
+   below it, into psInner at slot uSlot.  If psRight is not NULL,
+   psInner must be full, and its children and pvChild are split
+   between it and psRight, an inner node without children. */
+
+static void BTree_innerInsert(struct BTreeInner *psInner, size_t uSlot,
+                              void *pvChild, size_t uHeight,
+                              struct BTreeInner *psRight)
+{
+   void *apvAll[INNER_MAX + 1];
+   size_t uLeft;
+   size_t u;
+
+   assert(psInner != NULL);
+   assert(uSlot <= psInner->uLength);
+   assert(pvChild != NULL);
+
+   if (psRight == NULL)
+   {
+      assert(psInner->uLength < INNER_MAX);
+      for (u = psInner->uLength; u > uSlot; u--)
+      {
+         psInner->apvChildren[u] = psInner->apvChildren[u - 1];
+         psInner->auCounts[u] = psInner->auCounts[u - 1];
+         psInner->apvFirst[u] = psInner->apvFirst[u - 1];
+      }
+      psInner->apvChildren[uSlot] = pvChild;
+      psInner->uLength++;
+      BTree_refresh(psInner, uSlot, uHeight);
+      return;
+   }
+
+   assert(psInner->uLength == INNER_MAX);
+   for (u = 0; u < uSlot; u++)
+      apvAll[u] = psInner->apvChildren[u];
+   apvAll[uSlot] = pvChild;
+   for (u = uSlot; u < INNER_MAX; u++)
+      apvAll[u + 1] = psInner->apvChildren[u];
+
+   /* Recounting every child is no slower than moving the counts,
+      there being so few. */
+   uLeft = (INNER_MAX + 1) / 2;
+   psInner->uLength = uLeft;
+   for (u = 0; u < uLeft; u++)
+   {
+      psInner->apvChildren[u] = apvAll[u];
+      BTree_refresh(psInner, u, uHeight);
+   }
+   psRight->uLength = INNER_MAX + 1 - uLeft;
+   for (u = uLeft; u < INNER_MAX + 1; u++)
+   {
+      psRight->apvChildren[u - uLeft] = apvAll[u];
+      BTree_refresh(psRight, u - uLeft, uHeight);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+int BTree_addAt(BTree_T oBTree, size_t uIndex, const void *pvElement)
+{
+   struct BTreeInner *apsPath[MAX_HEIGHT];
+   size_t auSlots[MAX_HEIGHT];
+   struct BTreeInner *apsSpares[MAX_HEIGHT + 1];
+   struct BTreeLeaf *psLeaf;
+   struct BTreeLeaf *psNewLeaf;
+   struct BTreeInner *psInner;
+   void *pvChild;
+   void *pvSplit;
+   size_t uSpares;
+   size_t uLevel;
+   size_t uHeight;
+   size_t u;
+
+   assert(oBTree != NULL);
+   assert(uIndex <= oBTree->uLength);
+   assert(BTree_isValid(oBTree));
+
+   /* Descending to the leaf, recording the way, and to the end of a
+      child rather than the start of the next where uIndex lies
+      between two. */
+   pvChild = oBTree->pvRoot;
+   for (uLevel = 0; uLevel < oBTree->uHeight; uLevel++)
+   {
+      psInner = (struct BTreeInner*)pvChild;
+      for (u = 0; u + 1 < psInner->uLength &&
+                  uIndex > psInner->auCounts[u]; u++)
+         uIndex -= psInner->auCounts[u];
+      apsPath[uLevel] = psInner;
+      auSlots[uLevel] = u;
+      pvChild = psInner->apvChildren[u];
+   }
+   psLeaf = (struct BTreeLeaf*)pvChild;
+
+   /* Allocating every node that splitting full nodes will need before
+      changing any, so that a failure leaves oBTree unchanged: a leaf,
+      if the leaf is full, an inner node for each full one above it up
+      to the first with room, and a new root if there is none. */
+   psNewLeaf = NULL;
+   uSpares = 0;
+   if (psLeaf->uLength == LEAF_MAX)
+   {
+      psNewLeaf = BTree_newLeaf();
+      if (psNewLeaf == NULL)
+         return 0;
+      for (uLevel = oBTree->uHeight;
+           uLevel > 0 && apsPath[uLevel - 1]->uLength == INNER_MAX;
+           uLevel--)
+         uSpares++;
+      if (uLevel == 0)
+         uSpares++;
+      for (u = 0; u < uSpares; u++)
+      {
+         apsSpares[u] = BTree_newInner();
+         if (apsSpares[u] == NULL)
+         {
+            while (u > 0)
+               BTree_freeShallow(apsSpares[--u], 1);
+            BTree_freeShallow(psNewLeaf, 0);
+            return 0;
+         }
+      }
+   }
+
+   BTree_leafInsert(psLeaf, uIndex, pvElement, psNewLeaf);
+   pvChild = psLeaf;
+   pvSplit = psNewLeaf;
+
+   /* Recording the new element, and any node split off below, in each
+      node on the way back up. */
+   for (uLevel = oBTree->uHeight; uLevel-- > 0; )
+   {
+      psInner = apsPath[uLevel];
+      u = auSlots[uLevel];
+      uHeight = oBTree->uHeight - 1 - uLevel;
+      if (pvSplit == NULL)
+      {
+         psInner->auCounts[u]++;
+         psInner->apvFirst[u] = BTree_firstOf(pvChild, uHeight);
+      }
+      else if (psInner->uLength < INNER_MAX)
+      {
+         BTree_refresh(psInner, u, uHeight);
+         BTree_innerInsert(psInner, u + 1, pvSplit, uHeight, NULL);
+         pvSplit = NULL;
+      }
+      else
+      {
+         BTree_refresh(psInner, u, uHeight);
+         BTree_innerInsert(psInner, u + 1, pvSplit, uHeight,
+                           apsSpares[--uSpares]);
+         pvSplit = apsSpares[uSpares];
+      }
+      pvChild = psInner;
+   }
+
+   /* A root that split gains a parent. */
+   if (pvSplit != NULL)
+   {
+      psInner = apsSpares[--uSpares];
+      BTree_innerInsert(psInner, 0, oBTree->pvRoot, oBTree->uHeight,
+                        NULL);
+      BTree_innerInsert(psInner, 1, pvSplit, oBTree->uHeight, NULL);
+      oBTree->pvRoot = psInner;
+      oBTree->uHeight++;
+   }
+   assert(uSpares == 0);
+
+   oBTree->psFinger = NULL;
+   oBTree->uLength++;
+   uTotalLength++;
+
+   assert(BTree_isValid(oBTree));
+
+   return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Move the entry of pvFrom, which has uHeight levels of inner nodes at
+   and below it, at index uFrom to pvTo at index uTo, shifting the
+   entries of each to close or open the gap. */
+
+static void BTree_moveEntry(void *pvFrom, size_t uFrom, void *pvTo,
+                            size_t uTo, size_t uHeight)
+{
+   struct BTreeLeaf *psFrom;
+   struct BTreeLeaf *psTo;
+   struct BTreeInner *psInnerFrom;
+   struct BTreeInner *psInnerTo;
+   size_t u;
+
+   assert(pvFrom != NULL);
+   assert(pvTo != NULL);
+
+   if (uHeight == 0)
+   {
+      psFrom = (struct BTreeLeaf*)pvFrom;
+      psTo = (struct BTreeLeaf*)pvTo;
+      for (u = psTo->uLength; u > uTo; u--)
+         psTo->apvElements[u] = psTo->apvElements[u - 1];
+      psTo->apvElements[uTo] = psFrom->apvElements[uFrom];
+      psTo->uLength++;
+      psFrom->uLength--;
+      for (u = uFrom; u < psFrom->uLength; u++)
+         psFrom->apvElements[u] = psFrom->apvElements[u + 1];
+      return;
+   }
+
+   psInnerFrom = (struct BTreeInner*)pvFrom;
+   psInnerTo = (struct BTreeInner*)pvTo;
+   for (u = psInnerTo->uLength; u > uTo; u--)
+   {
+      psInnerTo->apvChildren[u] = psInnerTo->apvChildren[u - 1];
+      psInnerTo->auCounts[u] = psInnerTo->auCounts[u - 1];
+      psInnerTo->apvFirst[u] = psInnerTo->apvFirst[u - 1];
+   }
+   psInnerTo->apvChildren[uTo] = psInnerFrom->apvChildren[uFrom];
+   psInnerTo->auCounts[uTo] = psInnerFrom->auCounts[uFrom];
+   psInnerTo->apvFirst[uTo] = psInnerFrom->apvFirst[uFrom];
+   psInnerTo->uLength++;
+   psInnerFrom->uLength--;
+   for (u = uFrom; u < psInnerFrom->uLength; u++)
+   {
+      psInnerFrom->apvChildren[u] = psInnerFrom->apvChildren[u + 1];
+      psInnerFrom->auCounts[u] = psInnerFrom->auCounts[u + 1];
+      psInnerFrom->apvFirst[u] = psInnerFrom->apvFirst[u + 1];
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Restore the minimum to the child of psParent at uSlot, which has
+   uHeight levels of inner nodes at and below it and one entry too
+   few: by moving an entry to it from a sibling that can spare one,
+   or else by merging it with a sibling, which leaves psParent with
+   one child fewer. */
+
+static void BTree_rebalance(struct BTreeInner *psParent, size_t uSlot,
+                            size_t uHeight)
+{
+   size_t uMin;
+   size_t uLeft;
+   void *pvLeft;
+   void *pvRight;
+   size_t u;
+
+   assert(psParent != NULL);
+   assert(psParent->uLength >= 2);
+   assert(uSlot < psParent->uLength);
+
+   uMin = (uHeight == 0) ? LEAF_MIN : INNER_MIN;
+
+   /* Working on the child and its left sibling, or, for the first
+      child, its right sibling and it. */
+   uLeft = (uSlot > 0) ? uSlot - 1 : 0;
+   pvLeft = psParent->apvChildren[uLeft];
+   pvRight = psParent->apvChildren[uLeft + 1];
+
+   if (uLeft < uSlot && BTree_entriesOf(pvLeft, uHeight) > uMin)
+      BTree_moveEntry(pvLeft, BTree_entriesOf(pvLeft, uHeight) - 1,
+                      pvRight, 0, uHeight);
+   else if (uLeft == uSlot && BTree_entriesOf(pvRight, uHeight) > uMin)
+      BTree_moveEntry(pvRight, 0, pvLeft,
+                      BTree_entriesOf(pvLeft, uHeight), uHeight);
+   else
+   {
+      /* The two fit in one node, since one is at its minimum and the
+         other just short of it. */
+      while (BTree_entriesOf(pvRight, uHeight) > 0)
+         BTree_moveEntry(pvRight, 0, pvLeft,
+                         BTree_entriesOf(pvLeft, uHeight), uHeight);
+      if (uHeight == 0)
+         ((struct BTreeLeaf*)pvLeft)->psNext =
+            ((struct BTreeLeaf*)pvRight)->psNext;
+      BTree_freeShallow(pvRight, uHeight);
+      psParent->uLength--;
+      for (u = uLeft + 1; u < psParent->uLength; u++)
+      {
+         psParent->apvChildren[u] = psParent->apvChildren[u + 1];
+         psParent->auCounts[u] = psParent->auCounts[u + 1];
+         psParent->apvFirst[u] = psParent->apvFirst[u + 1];
+      }
+      BTree_refresh(psParent, uLeft, uHeight);
+      return;
+   }
+   BTree_refresh(psParent, uLeft, uHeight);
+   BTree_refresh(psParent, uLeft + 1, uHeight);
+}
+
+/*--------------------------------------------------------------------*/
+
+void *BTree_removeAt(BTree_T oBTree, size_t uIndex)
+{
+   struct BTreeInner *apsPath[MAX_HEIGHT];
+   size_t auSlots[MAX_HEIGHT];
+   struct BTreeLeaf *psLeaf;
+   struct BTreeInner *psInner;
+   const void *pvOldElement;
+   void *pvChild;
+   size_t uLevel;
+   size_t uHeight;
+   size_t u;
+
+   assert(oBTree != NULL);
+   assert(uIndex < oBTree->uLength);
+   assert(BTree_isValid(oBTree));
+
+   pvChild = oBTree->pvRoot;
+   for (uLevel = 0; uLevel < oBTree->uHeight; uLevel++)
+   {
+      psInner = (struct BTreeInner*)pvChild;
+      for (u = 0; uIndex >= psInner->auCounts[u]; u++)
+         uIndex -= psInner->auCounts[u];
+      apsPath[uLevel] = psInner;
+      auSlots[uLevel] = u;
+      pvChild = psInner->apvChildren[u];
+   }
+   psLeaf = (struct BTreeLeaf*)pvChild;
+
+   pvOldElement = psLeaf->apvElements[uIndex];
+   psLeaf->uLength--;
+   for (u = uIndex; u < psLeaf->uLength; u++)
+      psLeaf->apvElements[u] = psLeaf->apvElements[u + 1];
+
+   /* Restoring the minimum to each node on the way back up that has
+      fallen below it, which may take a child from its parent. */
+   for (uLevel = oBTree->uHeight; uLevel-- > 0; )
+   {
+      psInner = apsPath[uLevel];
+      u = auSlots[uLevel];
+      uHeight = oBTree->uHeight - 1 - uLevel;
+      if (BTree_entriesOf(psInner->apvChildren[u], uHeight) <
+          ((uHeight == 0) ? LEAF_MIN : INNER_MIN))
+         BTree_rebalance(psInner, u, uHeight);
+      else
+      {
+         psInner->auCounts[u]--;
+         psInner->apvFirst[u] =
+            BTree_firstOf(psInner->apvChildren[u], uHeight);
+      }
+   }
+
+   /* A root left with one child gives way to it. */
+   while (oBTree->uHeight > 0 &&
+          ((struct BTreeInner*)oBTree->pvRoot)->uLength == 1)
+   {
+      pvChild = ((struct BTreeInner*)oBTree->pvRoot)->apvChildren[0];
+      BTree_freeShallow(oBTree->pvRoot, oBTree->uHeight);
+      oBTree->pvRoot = pvChild;
+      oBTree->uHeight--;
+   }
+
+   oBTree->psFinger = NULL;
+   oBTree->uLength--;
+   uTotalLength--;
+
+   assert(BTree_isValid(oBTree));
+
+   return (void*)pvOldElement;
+}
+
+/*--------------------------------------------------------------------*/
+
+void BTree_toArray(BTree_T oBTree, void **ppvArray)
+{
+   struct BTreeLeaf *psLeaf;
+   void *pvNode;
+   size_t uHeight;
+   size_t uNext;
+   size_t u;
+
+   assert(oBTree != NULL);
+   assert(ppvArray != NULL);
+   assert(BTree_isValid(oBTree));
+
+   pvNode = oBTree->pvRoot;
+   for (uHeight = oBTree->uHeight; uHeight > 0; uHeight--)
+      pvNode = ((struct BTreeInner*)pvNode)->apvChildren[0];
+
+   uNext = 0;
+   for (psLeaf = (struct BTreeLeaf*)pvNode; psLeaf != NULL;
+        psLeaf = psLeaf->psNext)
+      for (u = 0; u < psLeaf->uLength; u++)
+         ppvArray[uNext++] = (void*)psLeaf->apvElements[u];
+}
+
+/*--------------------------------------------------------------------*/
+
+int BTree_bsearchKey(BTree_T oBTree,
+                     const void *pvKey,
+                     size_t *puIndex,
+                     int (*pfCompareKey)(const void *pvKey,
+                                         const void *pvElement))
+{
+   struct BTreeLeaf *psLeaf;
+   struct BTreeInner *psInner;
+   void *pvNode;
+   size_t uHeight;
+   size_t uStart;
+   size_t uLow;
+   size_t uHigh;
+   size_t uMid;
+   size_t u;
+
+   assert(oBTree != NULL);
+   assert(puIndex != NULL);
+   assert(pfCompareKey != NULL);
+   assert(BTree_isValid(oBTree));
+
+   /* Descending into the last child whose first element is less than
+      the key, or the first child if there is none, beneath which or
+      just after which the first element not less than the key must
+      lie. */
+   pvNode = oBTree->pvRoot;
+   uStart = 0;
+   for (uHeight = oBTree->uHeight; uHeight > 0; uHeight--)
+   {
+      psInner = (struct BTreeInner*)pvNode;
+      uLow = 1;
+      uHigh = psInner->uLength;
+      while (uLow < uHigh)
+      {
+         uMid = uLow + (uHigh - uLow) / 2;
+         if ((*pfCompareKey)(pvKey, psInner->apvFirst[uMid]) > 0)
+            uLow = uMid + 1;
+         else
+            uHigh = uMid;
+      }
+      for (u = 0; u < uLow - 1; u++)
+         uStart += psInner->auCounts[u];
+      pvNode = psInner->apvChildren[uLow - 1];
+   }
+
+   psLeaf = (struct BTreeLeaf*)pvNode;
+   uLow = 0;
+   uHigh = psLeaf->uLength;
+   while (uLow < uHigh)
+   {
+      uMid = uLow + (uHigh - uLow) / 2;
+      if ((*pfCompareKey)(pvKey, psLeaf->apvElements[uMid]) > 0)
+         uLow = uMid + 1;
+      else
+         uHigh = uMid;
+   }
+   *puIndex = uStart + uLow;
+
+   /* The first element not less than the key may be the first of the
+      next leaf. */
+   if (uLow == psLeaf->uLength && psLeaf->psNext != NULL)
+   {
+      uStart += psLeaf->uLength;
+      psLeaf = psLeaf->psNext;
+      uLow = 0;
+   }
+   oBTree->psFinger = psLeaf;
+   oBTree->uFingerStart = uStart;
+   if (uLow == psLeaf->uLength)
+      return 0;
+   return (*pfCompareKey)(pvKey, psLeaf->apvElements[uLow]) == 0;
+}
+
+/*--------------------------------------------------------------------*/
+
+void BTree_getTotals(size_t *puLength, size_t *puBytes)
+{
+   assert(puLength != NULL);
+   assert(puBytes != NULL);
+
+   *puLength = uTotalLength;
+   *puBytes = uTotalBytes;
+}
@@ -0,0 +1,107 @@
+/*--------------------------------------------------------------------*/
+/* btree.h                                                            */
+/*--------------------------------------------------------------------*/
+
+#ifndef BTREE_INCLUDED
+#define BTREE_INCLUDED
+
+#include <stddef.h>
+
+/* A BTree_T object is a sequence of elements, as a DynArray_T object
+   is, held in the leaves of a B+-tree whose nodes span a few cache
+   lines each and record how many elements lie beneath each of their
+   children.  Getting, setting, adding and removing the element at any
+   index takes O(log n) time for a length of n, rather than the O(n)
+   that adding or removing one in the middle of an array takes, and
+   growing the sequence never copies it.  Getting the elements in
+   order of their indices takes O(1) time each. */
+
+typedef struct BTree *BTree_T;
+
+/*--------------------------------------------------------------------*/
+
+/* Return a new empty BTree_T object, or NULL if insufficient memory
+   is available. */
+
+BTree_T BTree_new(void);
+
+/*--------------------------------------------------------------------*/
+
+/* Return a new BTree_T object holding the uLength elements at
+   ppvArray, in order, or NULL if insufficient memory is available.
+   Takes O(uLength) time. */
+
+BTree_T BTree_fromArray(const void **ppvArray, size_t uLength);
+
+/*--------------------------------------------------------------------*/
+
+/* Free oBTree. */
+
+void BTree_free(BTree_T oBTree);
+
+/*--------------------------------------------------------------------*/
+
+/* Return the length of oBTree. */
+
+size_t BTree_getLength(BTree_T oBTree);
+
+/*--------------------------------------------------------------------*/
+
+/* Return the uIndex'th element of oBTree. */
+
+void *BTree_get(BTree_T oBTree, size_t uIndex);
+
+/*--------------------------------------------------------------------*/
+
+/* Assign pvElement to the uIndex'th element of oBTree.  Return the
+   old element. */
+
+void *BTree_set(BTree_T oBTree, size_t uIndex, const void *pvElement);
+
+/*--------------------------------------------------------------------*/
+
+/* Add pvElement to oBTree such that it is the uIndex'th element, as
+   DynArray_addAt does.  Return 1 (TRUE) if successful, or 0 (FALSE),
+   leaving oBTree unchanged, if insufficient memory is available. */
+
+int BTree_addAt(BTree_T oBTree, size_t uIndex, const void *pvElement);
+
+/*--------------------------------------------------------------------*/
+
+/* Remove and return the uIndex'th element of oBTree. */
+
+void *BTree_removeAt(BTree_T oBTree, size_t uIndex);
+
+/*--------------------------------------------------------------------*/
+
+/* Fill ppvArray with the elements of oBTree.  ppvArray must point to
+   an area of memory that is large enough to hold all elements of
+   oBTree. */
+
+void BTree_toArray(BTree_T oBTree, void **ppvArray);
+
+/*--------------------------------------------------------------------*/
+
+/* Binary search oBTree for an element matching *pvKey using
+   *pfCompareKey to determine equality, as DynArray_bsearchKey does.
+   If the element is found, then assign its index to *puIndex and
+   return 1.  If the element is not found, then assign the index
+   where it would belong to *puIndex and return 0.  Of several
+   matching elements, the first is found.  Getting the element at
+   *puIndex next takes O(1) time. */
+
+int BTree_bsearchKey(BTree_T oBTree,
+                     const void *pvKey,
+                     size_t *puIndex,
+                     int (*pfCompareKey)(const void *pvKey,
+                                         const void *pvElement));
+
+/*--------------------------------------------------------------------*/
+
+/* Assign to *puLength the total length of all BTree_T objects that
+   have not been freed, and to *puBytes the total size of their
+   nodes. */
+
+void BTree_getTotals(size_t *puLength, size_t *puBytes);
+
+#endif
@@ -0,0 +1,592 @@
+/*--------------------------------------------------------------------*/
+/* dynarraydef.h                                                      */
+/*--------------------------------------------------------------------*/
+
+#ifndef DYNARRAYDEF_INCLUDED
+#define DYNARRAYDEF_INCLUDED
+
+#include "dynarray.h"
+#include <assert.h>
+#include <stddef.h>
+
+/* These macros generate DynArrays of a given pointer type whose sort
+   and binary search call a given comparison function directly, so
+   that the compiler may inline it into their inner loops, rather than
+   through the function pointer that DynArray_sort and DynArray_bsearch
+   must take.  dynarray.c generates DynArray_sort and DynArray_bsearch
+   from the same algorithms, so that all sorting and searching of
+   DynArrays is done one way.
+
+   A file that uses them must invoke each at file scope and without a
+   following semicolon. */
+
+/*--------------------------------------------------------------------*/
+
+/* The length of the longest range that DYNARRAY_DEFINE_SORT sorts by
+   insertion rather than by partitioning it further. */
+
+enum { DYNARRAY_INSERTION_MAX = 16 };
+
+/* Define a static function
+      void Func(const void **ppvArray, size_t uLength, Ctx ctx)
+   that sorts the uLength elements at ppvArray in ascending order, as
+   determined by Cmp(ctx, pvElement1, pvElement2).  Cmp must return
+   <0, 0, or >0 depending upon whether pvElement1 is less than, equal
+   to, or greater than pvElement2, respectively.  Also define the
+   static functions Func_insertion, Func_siftDown, Func_heapsort and
+   Func_intro that it uses.
+
+   Func is an introsort: a quicksort on medians of three that sorts
+   short ranges by insertion, and that, if partitioning goes so badly
+   that its depth reaches twice the base-2 logarithm of uLength, sorts
+   the range by heapsort instead.  So it takes O(uLength log uLength)
+   time whatever the input, and, since it recurses only into the
+   shorter part of each partition, O(log uLength) stack. */
+
+#define DYNARRAY_DEFINE_SORT(Func, Ctx, Cmp)                            \
+static void Func##_insertion(const void **ppvLo, const void **ppvHi,   \
+                             Ctx ctx)                                  \
+{                                                                      \
+   const void **ppv;                                                   \
+   const void **ppvHole;                                               \
+   const void *pvElement;                                              \
+                                                                       \
+   for (ppv = ppvLo + 1; ppv <= ppvHi; ppv++)                          \
+   {                                                                   \
+      pvElement = *ppv;                                                \
+      for (ppvHole = ppv;                                              \
+           ppvHole > ppvLo && Cmp(ctx, pvElement, ppvHole[-1]) < 0;    \
+           ppvHole--)                                                  \
+         *ppvHole = ppvHole[-1];                                       \
+      *ppvHole = pvElement;                                            \
+   }                                                                   \
+}                                                                      \
+                                                                       \
+static void Func##_siftDown(const void **ppvHeap, size_t uRoot,        \
+                            size_t uLength, Ctx ctx)                   \
+{                                                                      \
+   const void *pvElement;                                              \
+   size_t uChild;                                                      \
+                                                                       \
+   pvElement = ppvHeap[uRoot];                                         \
+   while ((uChild = 2 * uRoot + 1) < uLength)                          \
+   {                                                                   \
+      if (uChild + 1 < uLength &&                                      \
+          Cmp(ctx, ppvHeap[uChild], ppvHeap[uChild + 1]) < 0)          \
+         uChild++;                                                     \
+      if (Cmp(ctx, pvElement, ppvHeap[uChild]) >= 0)                   \
+         break;                                                        \
+      ppvHeap[uRoot] = ppvHeap[uChild];                                \
+      uRoot = uChild;                                                  \
+   }                                                                   \
+   ppvHeap[uRoot] = pvElement;                                         \
+}                                                                      \
+                                                                       \
+static void Func##_heapsort(const void **ppvLo, const void **ppvHi,    \
+                            Ctx ctx)                                   \
+{                                                                      \
+   const void *pvTemp;                                                 \
+   size_t uLength;                                                     \
+   size_t u;                                                           \
+                                                                       \
+   uLength = (size_t)(ppvHi - ppvLo) + 1;                              \
+   for (u = uLength / 2; u > 0; u--)                                   \
+      Func##_siftDown(ppvLo, u - 1, uLength, ctx);                     \
+   for (u = uLength - 1; u > 0; u--)                                   \
+   {                                                                   \
+      pvTemp = ppvLo[0];                                               \
+      ppvLo[0] = ppvLo[u];                                             \
+      ppvLo[u] = pvTemp;                                               \
+      Func##_siftDown(ppvLo, 0, u, ctx);                               \
+   }                                                                   \
+}                                                                      \
+                                                                       \
+static void Func##_intro(const void **ppvLo, const void **ppvHi,       \
+                         size_t uDepth, Ctx ctx)                       \
+{                                                                      \
+   const void **ppvMid;                                                \
+   const void **ppvRight;                                              \
+   const void **ppvLeft;                                               \
+   const void *pvPivot;                                                \
+   const void *pvTemp;                                                 \
+                                                                       \
+   while (ppvHi - ppvLo >= DYNARRAY_INSERTION_MAX)                     \
+   {                                                                   \
+      if (uDepth == 0)                                                 \
+      {                                                                \
+         Func##_heapsort(ppvLo, ppvHi, ctx);                           \
+         return;                                                       \
+      }                                                                \
+      uDepth--;                                                        \
+                                                                       \
+      /* Ordering the first, middle and last elements, so that the     \
+         middle one is their median and the pivot, and the outer ones  \
+         stop the scans below from leaving the range. */               \
+      ppvMid = ppvLo + (ppvHi - ppvLo) / 2;                            \
+      if (Cmp(ctx, *ppvMid, *ppvLo) < 0)                               \
+      {                                                                \
+         pvTemp = *ppvMid; *ppvMid = *ppvLo; *ppvLo = pvTemp;          \
+      }                                                                \
+      if (Cmp(ctx, *ppvHi, *ppvMid) < 0)                               \
+      {                                                                \
+         pvTemp = *ppvHi; *ppvHi = *ppvMid; *ppvMid = pvTemp;          \
+         if (Cmp(ctx, *ppvMid, *ppvLo) < 0)                            \
+         {                                                             \
+            pvTemp = *ppvMid; *ppvMid = *ppvLo; *ppvLo = pvTemp;       \
+         }                                                             \
+      }                                                                \
+      pvPivot = *ppvMid;                                               \
+                                                                       \
+      /* Partitioning, stopping at elements equal to the pivot on both \
+         sides, so that runs of equal elements split evenly. */        \
+      ppvRight = ppvLo;                                                \
+      ppvLeft = ppvHi;                                                 \
+      for (;;)                                                         \
+      {                                                                \
+         do                                                            \
+            ppvRight++;                                                \
+         while (Cmp(ctx, *ppvRight, pvPivot) < 0);                     \
+         do                                                            \
+            ppvLeft--;                                                 \
+         while (Cmp(ctx, pvPivot, *ppvLeft) < 0);                      \
+         if (ppvRight >= ppvLeft)                                      \
+            break;                                                     \
+         pvTemp = *ppvRight;                                           \
+         *ppvRight = *ppvLeft;                                         \
+         *ppvLeft = pvTemp;                                            \
+      }                                                                \
+                                                                       \
+      /* Now ppvLo...ppvLeft are no greater than the pivot and the     \
+         rest no less.  Recursing into the shorter part and looping on \
+         the longer bounds the stack. */                               \
+      if (ppvLeft - ppvLo < ppvHi - ppvLeft)                           \
+      {                                                                \
+         Func##_intro(ppvLo, ppvLeft, uDepth, ctx);                    \
+         ppvLo = ppvLeft + 1;                                          \
+      }                                                                \
+      else                                                             \
+      {                                                                \
+         Func##_intro(ppvLeft + 1, ppvHi, uDepth, ctx);                \
+         ppvHi = ppvLeft;                                              \
+      }                                                                \
+   }                                                                   \
+   Func##_insertion(ppvLo, ppvHi, ctx);                                \
+}                                                                      \
+                                                                       \
+static void Func(const void **ppvArray, size_t uLength, Ctx ctx)       \
+{                                                                      \
+   size_t uDepth;                                                      \
+   size_t u;                                                           \
+                                                                       \
+   assert(ppvArray != NULL || uLength == 0);                           \
+                                                                       \
+   if (uLength < 2)                                                    \
+      return;                                                          \
+   uDepth = 0;                                                         \
+   for (u = uLength; u > 1; u /= 2)                                    \
+      uDepth += 2;                                                     \
+   Func##_intro(ppvArray, ppvArray + uLength - 1, uDepth, ctx);         \
+}
+
+/*--------------------------------------------------------------------*/
+
+/* DYNARRAY_PREFETCH(pv) hints that the memory at pv will soon be
+   read, where the compiler offers a way to say so. */
+
+#ifdef __GNUC__
+#define DYNARRAY_PREFETCH(pv) __builtin_prefetch(pv)
+#else
+#define DYNARRAY_PREFETCH(pv) ((void)0)
+#endif
+
+/* DYNARRAY_DROP_ONES(u) shifts the trailing 1 bits of u, which must
+   have a 0 bit, and the 0 bit above them out of u, in one step where
+   the compiler offers a way to count them. */
+
+#ifdef __GNUC__
+#define DYNARRAY_DROP_ONES(u) \
+   ((u) >> (__builtin_ctzl(~(unsigned long)(u)) + 1))
+#else
+#define DYNARRAY_DROP_ONES(u) DynArray_dropOnes(u)
+static size_t DynArray_dropOnes(size_t u)
+{
+   while (u & 1)
+      u >>= 1;
+   return u >> 1;
+}
+#endif
+
+/* The length of the longest array that DYNARRAY_DEFINE_BSEARCH
+   searches without branching on its comparisons.  Longer arrays are
+   searched three ways instead, whose branches let the processor fetch
+   the element it probes next before each comparison is done, which
+   pays once there are too many elements to stay in cache. */
+
+enum { DYNARRAY_BRANCHLESS_MAX = 65536 };
+
+/* Define a static function
+      int Func(const void **ppvArray, size_t uLength, K key,
+               size_t *puIndex, Ctx ctx)
+   that binary searches the uLength elements at ppvArray for one
+   matching key.  If such an element is found, then it assigns its
+   index to *puIndex and returns 1.  Otherwise it assigns the index
+   where the element would belong to *puIndex and returns 0.
+   Cmp(ctx, key, pvElement) must return <0, 0, or >0 if key is less
+   than, equal to, or greater than pvElement, and the elements must be
+   sorted consistently with it.
+
+   Also define a static function
+      int Func_frozen(const void **ppvFrozen, const size_t *puRanks,
+                      size_t uLength, K key, size_t *puIndex, Ctx ctx)
+   that does the same for uLength sorted elements laid out by
+   DynArray_freeze: in Eytzinger order at ppvFrozen[1...uLength],
+   with the index of each in sorted order at the same place in
+   puRanks.  Of several matching elements, it finds the first.
+
+   Of up to DYNARRAY_BRANCHLESS_MAX elements, Func, and Func_frozen
+   at any length, seek the first not less than key without branching
+   on the comparisons, so that the processor need not guess which way
+   each goes, and fetch the elements that they may probe next while
+   they compare.  Func searches more elements three ways. */
+
+#define DYNARRAY_DEFINE_BSEARCH(Func, K, Ctx, Cmp)                      \
+static int Func(const void **ppvArray, size_t uLength, K key,          \
+                size_t *puIndex, Ctx ctx)                              \
+{                                                                      \
+   const void **ppvBase;                                               \
+   size_t uLo;                                                         \
+   size_t uHi;                                                         \
+   size_t uMid;                                                        \
+   size_t uLeft;                                                       \
+   size_t uHalf;                                                       \
+   size_t uIndex;                                                      \
+   int iCompare;                                                       \
+                                                                       \
+   assert(ppvArray != NULL || uLength == 0);                           \
+   assert(puIndex != NULL);                                            \
+                                                                       \
+   if (uLength > DYNARRAY_BRANCHLESS_MAX)                              \
+   {                                                                   \
+      /* The element sought lies at an index in [uLo, uHi), if any. */ \
+      uLo = 0;                                                         \
+      uHi = uLength;                                                   \
+      while (uLo < uHi)                                                \
+      {                                                                \
+         uMid = uLo + (uHi - uLo) / 2;                                 \
+         iCompare = Cmp(ctx, key, ppvArray[uMid]);                     \
+         if (iCompare < 0)                                             \
+            uHi = uMid;                                                \
+         else if (iCompare > 0)                                        \
+            uLo = uMid + 1;                                            \
+         else                                                          \
+         {                                                             \
+            *puIndex = uMid;                                           \
+            return 1;                                                  \
+         }                                                             \
+      }                                                                \
+      *puIndex = uLo;                                                  \
+      return 0;                                                        \
+   }                                                                   \
+                                                                       \
+   if (uLength == 0)                                                   \
+   {                                                                   \
+      *puIndex = 0;                                                    \
+      return 0;                                                        \
+   }                                                                   \
+                                                                       \
+   /* The first element not less than key is at ppvBase[0...uLeft],   \
+      where ppvBase[uLeft] may be one past the end. */                 \
+   ppvBase = ppvArray;                                                 \
+   for (uLeft = uLength; uLeft > 1; uLeft -= uHalf)                    \
+   {                                                                   \
+      uHalf = uLeft / 2;                                               \
+      DYNARRAY_PREFETCH(ppvBase[uHalf / 2]);                           \
+      DYNARRAY_PREFETCH(ppvBase[uHalf + uHalf / 2]);                   \
+      ppvBase = (Cmp(ctx, key, ppvBase[uHalf]) > 0) ?                  \
+         ppvBase + uHalf : ppvBase;                                    \
+   }                                                                   \
+                                                                       \
+   uIndex = (size_t)(ppvBase - ppvArray);                              \
+   iCompare = Cmp(ctx, key, *ppvBase);                                 \
+   if (iCompare > 0)                                                   \
+   {                                                                   \
+      uIndex++;                                                        \
+      iCompare = (uIndex < uLength) ?                                  \
+         Cmp(ctx, key, ppvArray[uIndex]) : -1;                         \
+   }                                                                   \
+   *puIndex = uIndex;                                                  \
+   return iCompare == 0;                                               \
+}                                                                      \
+                                                                       \
+static int Func##_frozen(const void **ppvFrozen,                       \
+                         const size_t *puRanks, size_t uLength,        \
+                         K key, size_t *puIndex, Ctx ctx)              \
+{                                                                      \
+   size_t k;                                                           \
+                                                                       \
+   assert(ppvFrozen != NULL);                                          \
+   assert(puRanks != NULL);                                            \
+   assert(puIndex != NULL);                                            \
+                                                                       \
+   /* Descending from the root, 1, to the left child, 2k, of each      \
+      element k not less than key, and otherwise to its right child,   \
+      2k+1.  The eight descendants three levels below k share a cache  \
+      line, fetched while k and its children are compared. */          \
+   for (k = 1; k <= uLength;                                           \
+        k = 2 * k + (Cmp(ctx, key, ppvFrozen[k]) > 0))                 \
+   {                                                                   \
+      if (8 * k <= uLength)                                            \
+         DYNARRAY_PREFETCH(&ppvFrozen[8 * k]);                         \
+      if (2 * k < uLength)                                             \
+      {                                                                \
+         DYNARRAY_PREFETCH(ppvFrozen[2 * k]);                          \
+         DYNARRAY_PREFETCH(ppvFrozen[2 * k + 1]);                      \
+      }                                                                \
+   }                                                                   \
+                                                                       \
+   /* Retracing the right turns after the last left turn, and that     \
+      turn, to the first element not less than key, if any. */         \
+   k = DYNARRAY_DROP_ONES(k);                                          \
+   if (k == 0)                                                         \
+   {                                                                   \
+      *puIndex = uLength;                                              \
+      return 0;                                                        \
+   }                                                                   \
+   *puIndex = puRanks[k];                                              \
+   return Cmp(ctx, key, ppvFrozen[k]) == 0;                            \
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Define a static function
+      void Func(const void **ppvArray, size_t uLength,
+                const void **ppvBatch, size_t uCount, Ctx ctx)
+   that merges the uCount elements at ppvBatch into the uLength
+   elements at ppvArray, both sorted as determined by
+   Cmp(ctx, pvElement1, pvElement2), leaving all of them sorted at
+   ppvArray, which must have room for them.  Elements of the batch
+   follow the elements of the array that are equal to them.
+
+   Func merges from the back, into the room after the array, so that
+   it needs no other memory, moves each element once, and leaves the
+   elements before the place of the first of the batch untouched. */
+
+#define DYNARRAY_DEFINE_MERGE(Func, Ctx, Cmp)                           \
+static void Func(const void **ppvArray, size_t uLength,                \
+                 const void **ppvBatch, size_t uCount, Ctx ctx)        \
+{                                                                      \
+   const void **ppvTo;                                                 \
+   const void **ppvFrom;                                               \
+   const void **ppvNext;                                               \
+                                                                       \
+   assert(ppvArray != NULL || uLength + uCount == 0);                  \
+   assert(ppvBatch != NULL || uCount == 0);                            \
+                                                                       \
+   ppvTo = ppvArray + uLength + uCount;                                \
+   ppvFrom = ppvArray + uLength;                                       \
+   ppvNext = ppvBatch + uCount;                                        \
+   while (ppvNext > ppvBatch)                                          \
+   {                                                                   \
+      if (ppvFrom > ppvArray && Cmp(ctx, ppvNext[-1], ppvFrom[-1]) < 0) \
+         *--ppvTo = *--ppvFrom;                                        \
+      else                                                             \
+         *--ppvTo = *--ppvNext;                                        \
+   }                                                                   \
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Declare Name_T, a DynArray_T whose elements are of the pointer type
+   T, and these functions on it, which behave as the DynArray_T
+   functions of the same names but take and return elements as T:
+
+      Name_T Name_new(size_t uLength);
+      void Name_free(Name_T oArray);
+      size_t Name_getLength(Name_T oArray);
+      T Name_get(Name_T oArray, size_t uIndex);
+      T Name_set(Name_T oArray, size_t uIndex, T element);
+      int Name_add(Name_T oArray, T element);
+      int Name_addAt(Name_T oArray, size_t uIndex, T element);
+      int Name_addMany(Name_T oArray, T *elements, size_t uCount);
+      T Name_removeAt(Name_T oArray, size_t uIndex);
+      int Name_reserve(Name_T oArray, size_t uPhysLength);
+      void Name_shrinkToFit(Name_T oArray);
+      int Name_freeze(Name_T oArray);
+
+   together with these, which take no comparison function, being
+   bound to those given to DYNARRAY_DEFINE:
+
+      void Name_sort(Name_T oArray);
+      int Name_addManySorted(Name_T oArray, T *elements,
+                             size_t uCount);
+      int Name_bsearch(Name_T oArray, T element, size_t *puIndex);
+      int Name_bsearchKey(Name_T oArray, K key, size_t *puIndex);
+
+   The functions have external linkage, so Name must be unique within
+   the program. */
+
+#define DYNARRAY_DECLARE(Name, T, K)                                    \
+typedef struct Name *Name##_T;                                         \
+Name##_T Name##_new(size_t uLength);                                   \
+void Name##_free(Name##_T oArray);                                     \
+size_t Name##_getLength(Name##_T oArray);                              \
+T Name##_get(Name##_T oArray, size_t uIndex);                          \
+T Name##_set(Name##_T oArray, size_t uIndex, T element);               \
+int Name##_add(Name##_T oArray, T element);                            \
+int Name##_addAt(Name##_T oArray, size_t uIndex, T element);           \
+int Name##_addMany(Name##_T oArray, T *elements, size_t uCount);       \
+T Name##_removeAt(Name##_T oArray, size_t uIndex);                     \
+int Name##_reserve(Name##_T oArray, size_t uPhysLength);               \
+void Name##_shrinkToFit(Name##_T oArray);                              \
+int Name##_freeze(Name##_T oArray);                                    \
+void Name##_sort(Name##_T oArray);                                     \
+int Name##_addManySorted(Name##_T oArray, T *elements, size_t uCount); \
+int Name##_bsearch(Name##_T oArray, T element, size_t *puIndex);       \
+int Name##_bsearchKey(Name##_T oArray, K key, size_t *puIndex);
+
+/*--------------------------------------------------------------------*/
+
+/* Define the functions declared by DYNARRAY_DECLARE(Name, T, K).
+   Name_sort, Name_addManySorted and Name_bsearch order the elements
+   by
+   Cmp(element1, element2), and Name_bsearchKey seeks key by
+   CmpKey(key, element), each returning <0, 0, or >0 as for
+   DynArray_sort and DynArray_bsearchKey.  Cmp and CmpKey must be
+   functions or macros visible where DYNARRAY_DEFINE is invoked. */
+
+#define DYNARRAY_DEFINE(Name, T, Cmp, K, CmpKey)                        \
+static int Name##_compare(int iUnused, const void *pvElement1,         \
+                          const void *pvElement2)                      \
+{                                                                      \
+   (void)iUnused;                                                      \
+   return Cmp((T)pvElement1, (T)pvElement2);                           \
+}                                                                      \
+                                                                       \
+static int Name##_compareKey(int iUnused, K key,                       \
+                             const void *pvElement)                    \
+{                                                                      \
+   (void)iUnused;                                                      \
+   return CmpKey(key, (T)pvElement);                                   \
+}                                                                      \
+                                                                       \
+DYNARRAY_DEFINE_SORT(Name##_sortHelp, int, Name##_compare)             \
+DYNARRAY_DEFINE_MERGE(Name##_mergeHelp, int, Name##_compare)           \
+DYNARRAY_DEFINE_BSEARCH(Name##_bsearchHelp, T, int, Name##_compare)     \
+DYNARRAY_DEFINE_BSEARCH(Name##_bsearchKeyHelp, K, int,                  \
+                        Name##_compareKey)                             \
+                                                                       \
+Name##_T Name##_new(size_t uLength)                                    \
+{                                                                      \
+   return (Name##_T)DynArray_new(uLength);                             \
+}                                                                      \
+                                                                       \
+void Name##_free(Name##_T oArray)                                      \
+{                                                                      \
+   DynArray_free((DynArray_T)oArray);                                  \
+}                                                                      \
+                                                                       \
+size_t Name##_getLength(Name##_T oArray)                               \
+{                                                                      \
+   return DynArray_getLength((DynArray_T)oArray);                      \
+}                                                                      \
+                                                                       \
+T Name##_get(Name##_T oArray, size_t uIndex)                           \
+{                                                                      \
+   return (T)DynArray_get((DynArray_T)oArray, uIndex);                 \
+}                                                                      \
+                                                                       \
+T Name##_set(Name##_T oArray, size_t uIndex, T element)                \
+{                                                                      \
+   return (T)DynArray_set((DynArray_T)oArray, uIndex, element);        \
+}                                                                      \
+                                                                       \
+int Name##_add(Name##_T oArray, T element)                             \
+{                                                                      \
+   return DynArray_add((DynArray_T)oArray, element);                   \
+}                                                                      \
+                                                                       \
+int Name##_addAt(Name##_T oArray, size_t uIndex, T element)            \
+{                                                                      \
+   return DynArray_addAt((DynArray_T)oArray, uIndex, element);         \
+}                                                                      \
+                                                                       \
+int Name##_addMany(Name##_T oArray, T *elements, size_t uCount)        \
+{                                                                      \
+   return DynArray_addMany((DynArray_T)oArray,                         \
+      (const void **)elements, uCount);                                \
+}                                                                      \
+                                                                       \
+T Name##_removeAt(Name##_T oArray, size_t uIndex)                      \
+{                                                                      \
+   return (T)DynArray_removeAt((DynArray_T)oArray, uIndex);            \
+}                                                                      \
+                                                                       \
+int Name##_reserve(Name##_T oArray, size_t uPhysLength)                \
+{                                                                      \
+   return DynArray_reserve((DynArray_T)oArray, uPhysLength);           \
+}                                                                      \
+                                                                       \
+void Name##_shrinkToFit(Name##_T oArray)                               \
+{                                                                      \
+   DynArray_shrinkToFit((DynArray_T)oArray);                           \
+}                                                                      \
+                                                                       \
+int Name##_freeze(Name##_T oArray)                                     \
+{                                                                      \
+   return DynArray_freeze((DynArray_T)oArray);                         \
+}                                                                      \
+                                                                       \
+void Name##_sort(Name##_T oArray)                                      \
+{                                                                      \
+   assert(oArray != NULL);                                             \
+                                                                       \
+   Name##_sortHelp(DynArray_getArray((DynArray_T)oArray),              \
+      DynArray_getLength((DynArray_T)oArray), 0);                      \
+}                                                                      \
+                                                                       \
+int Name##_addManySorted(Name##_T oArray, T *elements, size_t uCount)  \
+{                                                                      \
+   size_t uLength;                                                     \
+                                                                       \
+   assert(oArray != NULL);                                             \
+                                                                       \
+   uLength = DynArray_getLength((DynArray_T)oArray);                   \
+   if (! DynArray_addMany((DynArray_T)oArray,                          \
+                          (const void **)elements, uCount))            \
+      return 0;                                                        \
+   Name##_mergeHelp(DynArray_getArray((DynArray_T)oArray), uLength,    \
+      (const void **)elements, uCount, 0);                             \
+   return 1;                                                           \
+}                                                                      \
+                                                                       \
+int Name##_bsearch(Name##_T oArray, T element, size_t *puIndex)        \
+{                                                                      \
+   const void **ppvFrozen;                                             \
+   const size_t *puRanks;                                              \
+                                                                       \
+   assert(oArray != NULL);                                             \
+                                                                       \
+   ppvFrozen = DynArray_getFrozen((DynArray_T)oArray, &puRanks);       \
+   if (ppvFrozen != NULL)                                              \
+      return Name##_bsearchHelp_frozen(ppvFrozen, puRanks,             \
+         DynArray_getLength((DynArray_T)oArray), element, puIndex, 0); \
+   return Name##_bsearchHelp(DynArray_getArray((DynArray_T)oArray),    \
+      DynArray_getLength((DynArray_T)oArray), element, puIndex, 0);    \
+}                                                                      \
+                                                                       \
+int Name##_bsearchKey(Name##_T oArray, K key, size_t *puIndex)         \
+{                                                                      \
+   const void **ppvFrozen;                                             \
+   const size_t *puRanks;                                              \
+                                                                       \
+   assert(oArray != NULL);                                             \
+                                                                       \
+   ppvFrozen = DynArray_getFrozen((DynArray_T)oArray, &puRanks);       \
+   if (ppvFrozen != NULL)                                              \
+      return Name##_bsearchKeyHelp_frozen(ppvFrozen, puRanks,          \
+         DynArray_getLength((DynArray_T)oArray), key, puIndex, 0);     \
+   return Name##_bsearchKeyHelp(DynArray_getArray((DynArray_T)oArray), \
+      DynArray_getLength((DynArray_T)oArray), key, puIndex, 0);        \
+}
+
+#endif
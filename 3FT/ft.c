@@ -10,6 +10,10 @@
 #include <stdlib.h>
 
 #include "dynarray.h"
+#include "btree.h"
+#include "intern.h"
+#include "blob.h"
+#include "hash.h"
 #include "ft.h"
 #include "DTNode.h"
 #include "FileNode.h"
@@ -26,63 +30,600 @@ static FileNode fileRoot;
 /* a counter of the number of Nodes in the hierarchy */
 static size_t count;
 
+/* and TRUE if, initialized with FT_SLAB_ALLOCATOR, nodes are allocated
+   from slabs, so that FT_destroy frees them in bulk */
+static boolean useSlabs;
+
+/* and, if initialized with FT_PATH_INDEX, a path index: an
+   open-addressing hash table, using linear probing, that maps the
+   full path of every node under root to that node. */
+
+/* An entry in the path index. An empty slot has a NULL node. */
+struct FT_indexEntry {
+   /* the hash of the node's full path */
+   size_t hash;
+
+   /* the DTNode or FileNode at that path */
+   void* node;
+
+   /* TRUE if node is a FileNode, FALSE if it is a DTNode */
+   boolean isFile;
+};
+
+/* a flag for if the path index is maintained (TRUE) or not (FALSE) */
+static boolean useIndex;
+/* the slots of the path index, or NULL if none are allocated yet */
+static struct FT_indexEntry* pathIndex;
+/* the number of slots in the path index, zero or a power of two */
+static size_t indexCapacity;
+/* the number of nodes in the path index */
+static size_t indexSize;
+
+/* and a cache of the directories most recently reached by
+   FT_traversePath, from which later traversals resume rather than
+   starting again at the root. */
+
+/* The number of directories in the cache. */
+enum { CACHE_SIZE = 4 };
+
+/* the cached directories, most recently used first, with any unused
+   slots NULL and last */
+static DTNode cache[CACHE_SIZE];
+/* the numbers of traversals that did and did not resume from the
+   cache since initialization */
+static size_t cacheHits;
+static size_t cacheMisses;
+
+/* and a table of the directories opened by FT_openDir, indexed by the
+   slot of each handle. */
+
+/* A slot in the handle table. A free slot has a NULL dir. */
+struct FT_handleSlot {
+   /* the open directory */
+   DTNode dir;
+
+   /* the generation of the handle that opened dir */
+   size_t generation;
+};
+
+/* the slots of the handle table, or NULL if none are allocated yet */
+static struct FT_handleSlot* handles;
+/* the number of slots in the handle table */
+static size_t handleCapacity;
+/* no slot below this index is free */
+static size_t handleFirstFree;
+/* the generation given to the last handle opened, never reset, so that
+   no handle is valid again once its slot has been reused, even across
+   FT_destroy and FT_init */
+static size_t handleGeneration;
+
+/* and, if initialized with FT_INTERN_NAMES, the pool in which the
+   names of all its nodes are interned, otherwise NULL */
+static Intern_T names;
+
+/* and TRUE if, initialized with FT_COPY_CONTENTS, files hold their own
+   copies of their contents */
+static boolean copyContents;
+
+/* and, if initialized with FT_DEDUP_CONTENTS, the pool through which
+   files share equal copies, otherwise NULL */
+static Blob_T blobs;
+
+/* Returns the FNV-1a hash of the string str appended to a string
+   whose hash is hash. */
+static size_t FT_hashContinue(size_t hash, const char* str) {
+   assert(str != NULL);
+
+   return Hash_continue(hash, str, strlen(str));
+}
+
+/* Returns the FNV-1a hash of the string path. */
+static size_t FT_hashPath(const char* path) {
+   assert(path != NULL);
+
+   return Hash_bytes(path, strlen(path));
+}
+
+/* Returns the hash of the full path of directory n, computed from the
+   names of its ancestors without building the path. */
+static size_t FT_hashDir(DTNode n) {
+   assert(n != NULL);
+
+   if(DTNode_getParent(n) == NULL)
+      return FT_hashPath(DTNode_getName(n));
+   return FT_hashContinue(FT_hashContinue(FT_hashDir(DTNode_getParent(n)),
+                                          "/"),
+                          DTNode_getName(n));
+}
+
+/* Returns the hash of the full path of the node in path index entry
+   e. */
+static size_t FT_hashEntry(const struct FT_indexEntry* e) {
+   FileNode file;
+
+   assert(e != NULL);
+   assert(e->node != NULL);
+
+   if(!e->isFile)
+      return FT_hashDir((DTNode) e->node);
+   file = (FileNode) e->node;
+   if(FileNode_getParent(file) == NULL)
+      return FT_hashPath(FileNode_getName(file));
+   return FT_hashContinue(FT_hashContinue(
+                             FT_hashDir(FileNode_getParent(file)), "/"),
+                          FileNode_getName(file));
+}
+
+/* Returns TRUE if path is the full path of the node in path index
+   entry e, and FALSE otherwise. */
+static boolean FT_indexEntryHasPath(const struct FT_indexEntry* e,
+                                    const char* path) {
+   assert(e != NULL);
+   assert(e->node != NULL);
+
+   if(e->isFile)
+      return FileNode_hasPath((FileNode) e->node, path);
+   return DTNode_hasPath((DTNode) e->node, path);
+}
+
+/* The smallest number of slots in a path index that has any. */
+enum { MIN_INDEX_CAPACITY = 64 };
+
+/* Moves the entries of the path index into newCapacity slots, a power
+   of two more than twice the number of entries, or frees the slots if
+   newCapacity is 0, which requires the index to be empty.
+   Returns SUCCESS, or MEMORY_ERROR, leaving the index unchanged, if
+   the new slots cannot be allocated. */
+static int FT_indexResize(size_t newCapacity) {
+   struct FT_indexEntry* newIndex = NULL;
+   size_t mask;
+   size_t i;
+   size_t j;
+
+   assert(newCapacity == 0 || indexSize < newCapacity / 2);
+   assert(newCapacity != 0 || indexSize == 0);
+
+   if(newCapacity != 0) {
+      newIndex = calloc(newCapacity, sizeof(struct FT_indexEntry));
+      if(newIndex == NULL)
+         return MEMORY_ERROR;
+   }
+
+   /* Rehashing the existing entries into the new slots. */
+   mask = newCapacity - 1;
+   for(i = 0; i < indexCapacity; i++) {
+      if(pathIndex[i].node != NULL) {
+         j = pathIndex[i].hash & mask;
+         while(newIndex[j].node != NULL)
+            j = (j + 1) & mask;
+         newIndex[j] = pathIndex[i];
+      }
+   }
+
+   free(pathIndex);
+   pathIndex = newIndex;
+   indexCapacity = newCapacity;
+   return SUCCESS;
+}
+
+/* Ensures the path index can hold n more nodes while remaining at
+   most half full, so that FT_indexAdd cannot fail afterwards.
+   Returns SUCCESS, or MEMORY_ERROR if the index cannot be grown. */
+static int FT_indexReserve(size_t n) {
+   size_t newCapacity;
+
+   newCapacity = (indexCapacity == 0) ? MIN_INDEX_CAPACITY
+                                      : indexCapacity;
+   while(newCapacity / 2 < indexSize + n)
+      newCapacity *= 2;
+   if(newCapacity == indexCapacity)
+      return SUCCESS;
+   return FT_indexResize(newCapacity);
+}
+
+/* Shrinks the path index once removals have left it at most an eighth
+   full, to the fewest slots that leave it at most a quarter full, so
+   that it must be added to until half full, or removed from until an
+   eighth full again, before it is next resized. Frees the slots once
+   the index is empty. */
+static void FT_indexShrink(void) {
+   size_t newCapacity;
+
+   if(indexSize * 8 > indexCapacity)
+      return;
+   newCapacity = indexCapacity;
+   while(newCapacity > MIN_INDEX_CAPACITY && indexSize * 8 <= newCapacity)
+      newCapacity /= 2;
+   if(indexSize == 0)
+      newCapacity = 0;
+   if(newCapacity == indexCapacity)
+      return;
+
+   /* Should calloc fail to provide the smaller index, the index
+      simply stays as it is. */
+   (void) FT_indexResize(newCapacity);
+}
+
+/* Adds node, a FileNode if isFile and otherwise a DTNode, to the
+   path index. Space must already have been reserved. */
+static void FT_indexAdd(void* node, boolean isFile) {
+   struct FT_indexEntry e;
+   size_t mask;
+   size_t i;
+
+   assert(node != NULL);
+   assert(indexSize < indexCapacity / 2);
+
+   e.node = node;
+   e.isFile = isFile;
+   e.hash = FT_hashEntry(&e);
+
+   mask = indexCapacity - 1;
+   i = e.hash & mask;
+   while(pathIndex[i].node != NULL)
+      i = (i + 1) & mask;
+   pathIndex[i] = e;
+   indexSize++;
+}
+
+/* If the path index slot at slot holds an entry, stores its hash in
+   *hash and returns 1; otherwise returns 0. */
+static int FT_indexGetHash(const void* slot, size_t* hash) {
+   const struct FT_indexEntry* e = (const struct FT_indexEntry*) slot;
+
+   assert(e != NULL);
+   assert(hash != NULL);
+
+   if(e->node == NULL)
+      return 0;
+   *hash = e->hash;
+   return 1;
+}
+
+/* Removes node from the path index, shifting back any later entries
+   of its probe sequence so that no tombstones are needed. */
+static void FT_indexRemove(void* node, boolean isFile) {
+   static const struct FT_indexEntry empty;
+   struct FT_indexEntry e;
+   size_t mask;
+   size_t i;
+
+   assert(node != NULL);
+   assert(pathIndex != NULL);
+
+   e.node = node;
+   e.isFile = isFile;
+   mask = indexCapacity - 1;
+   i = FT_hashEntry(&e) & mask;
+   while(pathIndex[i].node != node) {
+      assert(pathIndex[i].node != NULL);
+      i = (i + 1) & mask;
+   }
+
+   Hash_remove(pathIndex, sizeof(struct FT_indexEntry), indexCapacity,
+               i, &empty, FT_indexGetHash);
+   indexSize--;
+}
+
+/* Adds n and all of its descendants to the path index. Space must
+   already have been reserved. */
+static void FT_indexAddTree(DTNode n) {
+   DTNode child;
+   boolean type;
+   size_t c;
+
+   assert(n != NULL);
+
+   FT_indexAdd(n, FALSE);
+   for(c = 0; c < DTNode_getNumChildren(n); c++) {
+      child = DTNode_getChild(n, c, &type);
+      if(type)
+         FT_indexAdd(child, TRUE);
+      else
+         FT_indexAddTree(child);
+   }
+}
+
+/* Removes n and all of its descendants from the path index. */
+static void FT_indexRemoveTree(DTNode n) {
+   DTNode child;
+   boolean type;
+   size_t c;
+
+   assert(n != NULL);
+
+   for(c = 0; c < DTNode_getNumChildren(n); c++) {
+      child = DTNode_getChild(n, c, &type);
+      if(type)
+         FT_indexRemove(child, TRUE);
+      else
+         FT_indexRemoveTree(child);
+   }
+   FT_indexRemove(n, FALSE);
+}
+
+/* Returns the node at exactly path according to the path index, or
+   NULL if there is none. If the node is a file, sets *piResult to
+   PARENT_CHILD_ERROR. */
+static DTNode FT_indexGet(char* path, int* piResult) {
+   size_t hash;
+   size_t mask;
+   size_t i;
+
+   assert(path != NULL);
+   assert(piResult != NULL);
+
+   if(pathIndex == NULL)
+      return NULL;
+
+   hash = FT_hashPath(path);
+   mask = indexCapacity - 1;
+   for(i = hash & mask; pathIndex[i].node != NULL; i = (i + 1) & mask) {
+      if(pathIndex[i].hash == hash &&
+         FT_indexEntryHasPath(&pathIndex[i], path)) {
+         if(pathIndex[i].isFile)
+            *piResult = PARENT_CHILD_ERROR;
+         return (DTNode) pathIndex[i].node;
+      }
+   }
+   return NULL;
+}
+
+/* Starting at the parameter curr, whose path is followed in the path
+  being traversed by rest, descends as far down the hierarchy as
+  possible while still matching rest, one path component at a time.
+
+  Returns a pointer to the farthest matching Node, and sets *piResult
+  to PARENT_CHILD_ERROR if it is a file, as FT_traversePathFrom does. */
+static DTNode FT_descendFrom(const char* rest, DTNode curr,
+                             int *piResult) {
+   const char* component = rest;
+   size_t len;
+   size_t childID;
+   boolean type;
+
+   assert(rest != NULL);
+   assert(curr != NULL);
+   assert(piResult != NULL);
+
+   /* Descending one component at a time, searching the children of
+      curr for each. */
+   while(*component == '/') {
+      component++;
+      len = strcspn(component, "/");
+
+      if(!DTNode_findChild(curr, component, len, &type, &childID)) {
+         return curr;
+      }
+      /* If a file matches, the descent ends there. */
+      if(type) {
+         *piResult = PARENT_CHILD_ERROR;
+         return DTNode_getChild(curr, childID, NULL);
+      }
+      curr = DTNode_getChild(curr, childID, NULL);
+      component += len;
+   }
+   return curr;
+}
+
 /* Starting at the parameter curr, traverses as far down
   the hierarchy as possible while still matching the path
-  parameter.
+  parameter, one path component at a time.
 
   Returns a pointer to the farthest matching Node down that path,
-  or NULL if there is no node in curr's hierarchy that matches
-  a prefix of the path. piResult is used to indicate whether the
-  node matched is a file or a directory. */
+  or NULL if curr is NULL or curr's path is not a prefix of the path.
+  piResult is used to indicate whether the node matched is a file or
+  a directory: a file that matches a prefix of the path ends the
+  descent and sets *piResult to PARENT_CHILD_ERROR. */
 static DTNode FT_traversePathFrom(char* path, DTNode curr, int *piResult) {
-   DTNode found;
-   size_t i;
-
    assert(path != NULL);
+   assert(piResult != NULL);
 
    if(curr == NULL) {
       return NULL;
    }
 
-   else if(!strcmp(path, DTNode_getPath(curr))) {
-      return curr;
+   /* Checking that curr's path matches path up to a component
+      boundary. */
+   if(!DTNode_isPathPrefix(curr, path)) {
+      return NULL;
    }
 
-   /* Checking if the first n characters match the path of curr, where n is
-      length of the path of curr, i.e. checking if the path is currently
-      the same. */
-   else if(!strncmp(path, DTNode_getPath(curr), strlen(DTNode_getPath(curr)))) {
-      /* Recursively traversing the directories that are children of the curr
-         DTNode. */
-      for(i = 0; i < DTNode_getNumDTChildren(curr); i++) {
-         found = FT_traversePathFrom(path, DTNode_getChild(curr, i, FALSE),
-                                     piResult);
-         if(found != NULL) {
-            return found;
-         }
-      }
-      /* If found is NULL, searching for child file instead. */
-      for (i = 0; i < DTNode_getNumFileChildren(curr); i++) {
-         found = DTNode_getChild(curr, i, TRUE);
+   return FT_descendFrom(path + DTNode_getPathLength(curr), curr,
+                         piResult);
+}
 
-         /* If current path matches the path for a given child node. */
-         if (strcmp(DTNode_getPath(found), path) == 0) {
-            *piResult = PARENT_CHILD_ERROR;
-            return found;
-         }
+/* Empties the cache, as must be done before any directory is
+   destroyed. */
+static void FT_cacheClear(void) {
+   size_t i;
 
-      }
-      return curr;
+   for(i = 0; i < CACHE_SIZE; i++)
+      cache[i] = NULL;
+}
+
+/* Moves the entry of the cache at index i to the front, shifting the
+   more recently used entries back by one. */
+static void FT_cacheToFront(size_t i) {
+   DTNode n;
+
+   assert(i < CACHE_SIZE);
+
+   n = cache[i];
+   for(; i > 0; i--)
+      cache[i] = cache[i - 1];
+   cache[0] = n;
+}
+
+/* Returns the deepest cached directory whose path is a prefix of
+   path, marking it most recently used, or NULL if there is none. */
+static DTNode FT_cacheFind(const char* path) {
+   size_t best = CACHE_SIZE;
+   size_t i;
+
+   assert(path != NULL);
+
+   for(i = 0; i < CACHE_SIZE && cache[i] != NULL; i++) {
+      if((best == CACHE_SIZE ||
+          DTNode_getPathLength(cache[i]) >
+          DTNode_getPathLength(cache[best])) &&
+         DTNode_isPathPrefix(cache[i], path))
+         best = i;
    }
-   return NULL;
+   if(best == CACHE_SIZE)
+      return NULL;
+
+   FT_cacheToFront(best);
+   return cache[0];
+}
+
+/* Adds directory n to the cache as its most recently used entry,
+   evicting the least recently used one if the cache is full. */
+static void FT_cacheAdd(DTNode n) {
+   size_t i;
+
+   assert(n != NULL);
+
+   for(i = 0; i < CACHE_SIZE - 1 && cache[i] != NULL; i++) {
+      if(cache[i] == n)
+         break;
+   }
+   cache[i] = n;
+   FT_cacheToFront(i);
 }
 
 /* Returns the farthest node reachable from the root following a given
    path, or NULL if there is no node in the hierarchy that matches a
-   prefix of the path. */
+   prefix of the path. Resumes from the deepest cached directory on the
+   path, if any, and caches the deepest directory reached. */
 static DTNode FT_traversePath(char* path, int* piResult) {
+   DTNode start;
+   DTNode found;
+
+   assert(path != NULL);
+   assert(piResult != NULL);
+
+   start = FT_cacheFind(path);
+   if(start != NULL) {
+      cacheHits++;
+      found = FT_descendFrom(path + DTNode_getPathLength(start), start,
+                             piResult);
+   }
+   else {
+      cacheMisses++;
+      found = FT_traversePathFrom(path, root, piResult);
+   }
+
+   if(found != NULL) {
+      if(*piResult == PARENT_CHILD_ERROR)
+         FT_cacheAdd(FileNode_getParent((FileNode) found));
+      else
+         FT_cacheAdd(found);
+   }
+   return found;
+}
+
+/* Returns the node at path for a point query. With the path index in
+   use, only an exact match is returned, without walking the tree;
+   otherwise, behaves as FT_traversePath. Either way, a returned node
+   is the node at path if and only if its path equals path, and
+   *piResult is set to PARENT_CHILD_ERROR if it is a file. */
+static DTNode FT_lookupPath(char* path, int* piResult) {
+   assert(path != NULL);
+
+   if(useIndex)
+      return FT_indexGet(path, piResult);
+   return FT_traversePath(path, piResult);
+}
+
+/* Resolves path as FT_lookupPath does, for the next query of a batch
+   whose previous path was prevPath, or NULL for the first query. *pDir
+   is the deepest directory reached resolving prevPath, or NULL. Rather
+   than starting again at the root, the traversal resumes from the
+   deepest ancestor of *pDir that is also a prefix of path, so that
+   paths given in sorted order share the work on their common prefix.
+   Updates *pDir for the next query. */
+static DTNode FT_lookupNext(char* path, const char* prevPath,
+                            DTNode* pDir, int* piResult) {
+   DTNode dir;
+   DTNode found;
+   size_t common = 0;
+   size_t len = 0;
+
    assert(path != NULL);
-   return FT_traversePathFrom(path, root, piResult);
+   assert(pDir != NULL);
+   assert(piResult != NULL);
+
+   if(useIndex)
+      return FT_indexGet(path, piResult);
+
+   /* Climbing from the previous directory until its path, which is a
+      prefix of prevPath, is also a prefix of path. */
+   dir = *pDir;
+   if(dir != NULL) {
+      assert(prevPath != NULL);
+      while(path[common] != '\0' && path[common] == prevPath[common])
+         common++;
+      while(dir != NULL) {
+         len = DTNode_getPathLength(dir);
+         if(len <= common && (path[len] == '/' || path[len] == '\0'))
+            break;
+         dir = DTNode_getParent(dir);
+      }
+   }
+
+   if(dir == NULL)
+      found = FT_traversePath(path, piResult);
+   else
+      found = FT_descendFrom(path + len, dir, piResult);
+
+   if(found == NULL)
+      *pDir = NULL;
+   else if(*piResult == PARENT_CHILD_ERROR)
+      *pDir = FileNode_getParent((FileNode) found);
+   else
+      *pDir = found;
+   return found;
+}
+
+/* Returns the directory that handle refers to, or NULL if handle was
+   never opened, has been closed, or its directory has been removed. */
+static DTNode FT_handleDir(FT_DirHandle handle) {
+   if(handle.slot >= handleCapacity ||
+      handles[handle.slot].dir == NULL ||
+      handles[handle.slot].generation != handle.generation) {
+      return NULL;
+   }
+   return handles[handle.slot].dir;
+}
+
+/* Frees the handle slot at index slot. */
+static void FT_handleFree(size_t slot) {
+   assert(slot < handleCapacity);
+
+   handles[slot].dir = NULL;
+   if(slot < handleFirstFree) {
+      handleFirstFree = slot;
+   }
+}
+
+/* Closes every handle to dir or to a directory beneath it, as must be
+   done before the hierarchy rooted at dir is destroyed. */
+static void FT_handleCloseUnder(DTNode dir) {
+   DTNode curr;
+   size_t i;
+
+   assert(dir != NULL);
+
+   for(i = 0; i < handleCapacity; i++) {
+      for(curr = handles[i].dir; curr != NULL;
+          curr = DTNode_getParent(curr)) {
+         if(curr == dir) {
+            FT_handleFree(i);
+            break;
+         }
+      }
+   }
 }
 
 /* Given a prospective parent DTNode and child FileNode,
@@ -119,11 +660,53 @@ static int FT_linkParentToChildDirectory(DTNode parent, DTNode child) {
    return SUCCESS;
 }
 
+/* Advances *pComponent past any slashes and returns the length of the
+   path component that starts there, which is 0 if no components
+   remain. The path itself is not modified. */
+static size_t FT_nextComponent(const char** pComponent) {
+   const char* component;
+
+   assert(pComponent != NULL);
+   assert(*pComponent != NULL);
+
+   component = *pComponent;
+   while(*component == '/')
+      component++;
+   *pComponent = component;
+
+   return strcspn(component, "/");
+}
+
+/* Returns a new FileNode, as FileNode_create does, holding its own
+   copy of contents if copy is TRUE, or NULL if insufficient memory is
+   available. */
+static FileNode FT_newFile(const char* name, size_t len, DTNode parent,
+                           void* contents, size_t length,
+                           boolean copy) {
+   FileNode new;
+
+   assert(name != NULL);
+
+   if(!copy)
+      return FileNode_create(name, len, parent, contents, length);
+
+   new = FileNode_create(name, len, parent, NULL, 0);
+   if(new != NULL && !FileNode_copyContents(new, contents, length)) {
+      FileNode_destroy(new);
+      return NULL;
+   }
+   return new;
+}
+
 /* Inserts a new path into the tree rooted at parent, or, if
    parent is NULL, as the root of the data structure.
 
    If a Node representing path already exists, returns ALREADY_IN_TREE.
 
+   If arena is TRUE, type must be FALSE, and the directory at path is
+   created with an arena of its own for its subtree. If copy is TRUE,
+   the file at path holds its own copy of contents.
+
    If there is an allocation error in creating any of the new nodes or
    their fields, returns MEMORY_ERROR.
 
@@ -132,17 +715,19 @@ static int FT_linkParentToChildDirectory(DTNode parent, DTNode child) {
 
    Otherwise, returns SUCCESS. */
 static int FT_insertRestOfPath(char* path, DTNode parent, boolean type,
-                               void* contents, size_t length) {
+                               void* contents, size_t length,
+                               boolean arena, boolean copy) {
    DTNode curr = parent;
    boolean firstNew = TRUE;
    FileNode firstFile = NULL;
    DTNode firstDir = NULL;
    DTNode newDir = NULL;
    FileNode newFile = NULL;
-   char* copyPath;
-   char* restPath = path;
-   char* dirToken;
-   char* nextToken;
+   const char* restPath = path;
+   const char* dirToken;
+   const char* nextToken;
+   size_t tokenLen;
+   size_t nextLen;
    int result;
    size_t newCount = 0;
 
@@ -156,34 +741,57 @@ static int FT_insertRestOfPath(char* path, DTNode parent, boolean type,
    else {
       /* Comparing path of current node with input path, in case they
          are the same, node is already in the tree. */
-      if(!strcmp(path, DTNode_getPath(curr))) {
+      if(DTNode_hasPath(curr, path)) {
          return ALREADY_IN_TREE;
       }
-      restPath += (strlen(DTNode_getPath(curr)) + 1);
+      restPath += (DTNode_getPathLength(curr) + 1);
    }
 
-   copyPath = malloc(strlen(restPath)+1);
-
-   /* In case of insufficient memory. */
-   if(copyPath == NULL) {
-      return MEMORY_ERROR;
+   /* Reserving path index space for every new node up front, so that
+      indexing cannot fail once the tree has been changed. */
+   if(useIndex) {
+      newCount = 1;
+      for(dirToken = restPath; *dirToken != '\0'; dirToken++) {
+         if(*dirToken == '/')
+            newCount++;
+      }
+      if(FT_indexReserve(newCount) != SUCCESS) {
+         return MEMORY_ERROR;
+      }
+      newCount = 0;
    }
 
-   strcpy(copyPath, restPath);
-   dirToken = strtok(copyPath, "/");
+   /* Walking the components of restPath in place, one ahead so that
+      the last one is known when it is reached. */
+   dirToken = restPath;
+   tokenLen = FT_nextComponent(&dirToken);
 
-
-   while(dirToken != NULL) {
-      nextToken = strtok(NULL, "/");
+   while(tokenLen != 0) {
+      nextToken = dirToken + tokenLen;
+      nextLen = FT_nextComponent(&nextToken);
 
       /* If file is being inserted. */
-      if ((nextToken == NULL) && (type)) {
-         newFile = FileNode_create(dirToken, curr, contents, length);
+      if ((nextLen == 0) && (type)) {
+         newFile = FT_newFile(dirToken, tokenLen, curr,
+                              contents, length, copy);
+         if(newFile == NULL) {
+            if(firstDir != NULL)
+               (void) DTNode_destroy(firstDir);
+            return MEMORY_ERROR;
+         }
       }
 
       /* If directory is being inserted. */
       else {
-         newDir = DTNode_create(dirToken, curr);
+         if(arena && nextLen == 0)
+            newDir = DTNode_createArena(dirToken, tokenLen, curr);
+         else
+            newDir = DTNode_create(dirToken, tokenLen, curr);
+         if(newDir == NULL) {
+            if(firstDir != NULL)
+               (void) DTNode_destroy(firstDir);
+            return MEMORY_ERROR;
+         }
       }
 
       newCount++;
@@ -196,65 +804,35 @@ static int FT_insertRestOfPath(char* path, DTNode parent, boolean type,
       }
 
       else {
-         /* In case of a directory being inserted. */
-         if (!type) {
+         /* In case of a directory being inserted, including the
+            intermediate directories above an inserted file. The
+            linking functions destroy the child themselves on
+            failure, leaving only the path up until it. */
+         if ((!type) || (nextLen != 0)) {
             result = FT_linkParentToChildDirectory(curr, newDir);
-            if(result != SUCCESS) {
-               /* Destroying temporary directory newDir no longer in
-                 use. */
-               (void) DTNode_destroy(newDir);
-
-               /* Destroying the path up until this directory. */
-               (void) DTNode_destroy(firstDir);
-               free(copyPath);
-               return result;
-            }
          }
          else {
-            /* In case of a file being inserted. */
             result = FT_linkParentToChildFile(curr, newFile);
-            if(result != SUCCESS) {
-               /* Destroying temporary file newFile no longer in
-                  use. */
-               (void) FileNode_destroy(newFile);
-
-               /* Destroying the path up until this file. */
-               (void) DTNode_destroy(firstDir);
-               free(copyPath);
-               return result;
-            }
-         }
-      }
-
-      /* If end of path has been reached. */
-      if (nextToken == NULL) {
-         /* In case directory was being inserted and
-            insufficient memory was available. */
-         if((!type) && (newDir == NULL)) {
-            (void) DTNode_destroy(firstDir);
-            free(copyPath);
-            return MEMORY_ERROR;
          }
-
-         /* In case file was being inserted and
-            insufficient memory was available. */
-         if((type) && (newFile == NULL)) {
+         if(result != SUCCESS) {
             (void) DTNode_destroy(firstDir);
-            free(copyPath);
-            return MEMORY_ERROR;
+            return result;
          }
       }
+
       curr = newDir;
       dirToken = nextToken;
+      tokenLen = nextLen;
    }
 
-   free(copyPath);
-
    /* Parent will only be NULL if node is being inserted at the root. */
    if(parent == NULL) {
       root = firstDir;
       fileRoot = firstFile;
       count = newCount;
+      if(useIndex) {
+         FT_indexAddTree(firstDir);
+      }
       return SUCCESS;
    }
 
@@ -271,14 +849,13 @@ static int FT_insertRestOfPath(char* path, DTNode parent, boolean type,
       /* Incrementing number of nodes in tree if successful insertion. */
       if(result == SUCCESS) {
          count += newCount;
-      }
-      else {
-         if (firstDir == NULL) {
-            (void) FileNode_destroy(firstFile);
-         } else {
-            (void) DTNode_destroy(firstDir);
+         if(useIndex) {
+            if (firstDir == NULL) {
+               FT_indexAdd(firstFile, TRUE);
+            } else {
+               FT_indexAddTree(firstDir);
+            }
          }
-
       }
 
       return result;
@@ -286,8 +863,10 @@ static int FT_insertRestOfPath(char* path, DTNode parent, boolean type,
    }
 }
 
-/* ft.h contains specification. */
-int FT_insertDir(char* path) {
+/* Inserts a new directory at path, with an arena of its own for its
+   subtree if arena is TRUE, with the results specified for
+   FT_insertDir. */
+static int FT_insertDirectory(char* path, boolean arena) {
 
    DTNode curr;
    int result = SUCCESS;
@@ -310,19 +889,30 @@ int FT_insertDir(char* path) {
    /* If traversePath finds a directory node for the input path
       to be inserted into. */
    if (result == SUCCESS) {
-      result = FT_insertRestOfPath(path, curr, FALSE, NULL, 0);
+      result = FT_insertRestOfPath(path, curr, FALSE, NULL, 0, arena,
+                                   FALSE);
    }
    /* If a file is found on the path. */
    else if (result == PARENT_CHILD_ERROR) {
       /* If path being inserted is already in the tree, but as
          the path for a file. */
-      if (!strcmp(path, FileNode_getPath((FileNode)curr))) {
+      if (FileNode_hasPath((FileNode)curr, path)) {
          result = ALREADY_IN_TREE;
       }
    }
    return result;
 }
 
+/* ft.h contains specification. */
+int FT_insertDir(char* path) {
+   return FT_insertDirectory(path, FALSE);
+}
+
+/* ft.h contains specification. */
+int FT_insertArenaDir(char* path) {
+   return FT_insertDirectory(path, TRUE);
+}
+
 /* ft.h contains specification. */
 boolean FT_containsDir(char* path) {
    DTNode curr;
@@ -340,20 +930,20 @@ boolean FT_containsDir(char* path) {
       return FALSE;
    }
 
-   curr = FT_traversePath(path, &result);
+   curr = FT_lookupPath(path, &result);
 
    /* If no node is found whose path  matches the prefix of the path. */
    if(curr == NULL) {
       return FALSE;
    }
 
-   /* In case node with path prefix is found, but path is not identical. */
-   else if(strcmp(path, DTNode_getPath(curr))) {
+   /* In case a file is found. */
+   else if (result == PARENT_CHILD_ERROR) {
       return FALSE;
    }
 
-   /* In case file with path is found. */
-   else if (result == PARENT_CHILD_ERROR) {
+   /* In case node with path prefix is found, but path is not identical. */
+   else if(!DTNode_hasPath(curr, path)) {
       return FALSE;
    }
 
@@ -363,8 +953,11 @@ boolean FT_containsDir(char* path) {
    }
 }
 
-/* ft.h contains specification. */
-int FT_insertFile(char* path, void *contents, size_t length) {
+/* Inserts a new file at path with the given contents, holding its own
+   copy of them if copy is TRUE, with the results specified for
+   FT_insertFile. */
+static int FT_insertFileWith(char* path, void *contents, size_t length,
+                             boolean copy) {
 
    DTNode curr;
    int result = SUCCESS;
@@ -382,7 +975,7 @@ int FT_insertFile(char* path, void *contents, size_t length) {
    if (fileRoot != NULL) {
       /* If path of root file matches input path, node is
          already in the tree. */
-      if ((strcmp(path, FileNode_getPath(fileRoot))) == 0) {
+      if (FileNode_hasPath(fileRoot, path)) {
          return ALREADY_IN_TREE;
       }
       /* If trying to insert any other file, conflicting path. */
@@ -396,9 +989,12 @@ int FT_insertFile(char* path, void *contents, size_t length) {
       /* If there are no slashes, i.e., if only file is being inserted
          at root. */
       if (checkPath == NULL) {
-         rootNode = FileNode_create(path, NULL, contents, length);
+         rootNode = FT_newFile(path, strlen(path), NULL,
+                               contents, length, copy);
          if (rootNode != NULL) {
             fileRoot = rootNode;
+            count = 1;
+            return SUCCESS;
          } else {
             return MEMORY_ERROR;
          }
@@ -410,18 +1006,34 @@ int FT_insertFile(char* path, void *contents, size_t length) {
    /* If DTNode with path = prefix of input path is found for the
       new node to be inserted into. */
    if (result == SUCCESS) {
-      result = FT_insertRestOfPath(path, curr, TRUE, contents, length);
+      result = FT_insertRestOfPath(path, curr, TRUE, contents, length,
+                                   FALSE, copy);
    }
    /* If file is found. */
    else if (result == PARENT_CHILD_ERROR) {
-      if (!strcmp(path, FileNode_getPath((FileNode)curr))) {
+      if (FileNode_hasPath((FileNode)curr, path)) {
          /* If path of file found is same as inserted path. */
          result = ALREADY_IN_TREE;
       }
+      /* If file found is an ancestor of the inserted path. */
+      else {
+         result = NOT_A_DIRECTORY;
+      }
    }
    return result;
 }
 
+/* ft.h contains specification. */
+int FT_insertFile(char* path, void *contents, size_t length) {
+   return FT_insertFileWith(path, contents, length, copyContents);
+}
+
+/* ft.h contains specification. */
+int FT_insertFileCopy(char* path, const void *contents, size_t length) {
+   /* The contents are copied, never stored. */
+   return FT_insertFileWith(path, (void*) contents, length, TRUE);
+}
+
 /* ft.h contains specification. */
 boolean FT_containsFile(char* path) {
    FileNode curr;
@@ -437,24 +1049,25 @@ boolean FT_containsFile(char* path) {
    /* In case root is file, check for it being the
       same file. */
    if (fileRoot != NULL) {
-      if (strcmp(path, FileNode_getPath(fileRoot)) == 0) {
+      if (FileNode_hasPath(fileRoot, path)) {
          return TRUE;
       } else {
          return FALSE;
       }
    }
 
-   curr = (FileNode) FT_traversePath(path, &result);
+   curr = (FileNode) FT_lookupPath(path, &result);
 
    /* If no node is found whose path  matches the prefix of the path. */
    if(curr == NULL) {
       return FALSE;
    }
-   else if(strcmp(path, FileNode_getPath(curr))) {
+   /* If a directory is found instead of a file. */
+   else if (result != PARENT_CHILD_ERROR) {
       return FALSE;
    }
    /* If correct file is found. */
-   else if (result == PARENT_CHILD_ERROR) {
+   else if (FileNode_hasPath(curr, path)) {
       return TRUE;
    } else {
       return FALSE;
@@ -483,7 +1096,7 @@ static int FT_rmPathAt(char* path, DTNode curr) {
    parent = DTNode_getParent(curr);
 
    /* If path of current is the same as input path. */
-   if(!strcmp(path, DTNode_getPath(curr))) {
+   if(DTNode_hasPath(curr, path)) {
       if(parent == NULL) {
          root = NULL;
       }
@@ -491,6 +1104,12 @@ static int FT_rmPathAt(char* path, DTNode curr) {
          DTNode_unlinkChildDirectory(parent, curr);
       }
 
+      if(useIndex) {
+         FT_indexRemoveTree(curr);
+         FT_indexShrink();
+      }
+      FT_cacheClear();
+      FT_handleCloseUnder(curr);
       FT_removePathFrom(curr);
 
       return SUCCESS;
@@ -503,7 +1122,7 @@ static int FT_rmPathAt(char* path, DTNode curr) {
 /* ft.h contains specification. */
 int FT_rmDir(char* path) {
    DTNode curr;
-   int result;
+   int result = SUCCESS;
 
    assert(path != NULL);
 
@@ -517,9 +1136,15 @@ int FT_rmDir(char* path) {
    if(curr == NULL) {
       result =  NO_SUCH_PATH;
    }
-   /* If a file is found with the input path. */
+   /* If a file is found on the input path. */
    else if (result == PARENT_CHILD_ERROR) {
-      result = NOT_A_DIRECTORY;
+      /* If the file found is not the one at the input path. */
+      if (!FileNode_hasPath((FileNode)curr, path)) {
+         result = NO_SUCH_PATH;
+      }
+      else {
+         result = NOT_A_DIRECTORY;
+      }
    }
    /* A directory is found with the input path. */
    else {
@@ -531,7 +1156,7 @@ int FT_rmDir(char* path) {
 /* ft.h contains specification. */
 int FT_rmFile(char* path) {
    FileNode curr;
-   int result;
+   int result = SUCCESS;
 
    assert(path != NULL);
 
@@ -544,7 +1169,7 @@ int FT_rmFile(char* path) {
    if (fileRoot != NULL) {
       /* If the path of the file node is the same as that of the
          file to be removed. */
-      if (strcmp(path, FileNode_getPath(fileRoot)) == 0) {
+      if (FileNode_hasPath(fileRoot, path)) {
          FileNode_destroy(fileRoot);
          count = 0;
          fileRoot = NULL;
@@ -562,21 +1187,30 @@ int FT_rmFile(char* path) {
    }
    /* If a file is found. */
    else if (result == PARENT_CHILD_ERROR) {
-      if (strcmp(path, FileNode_getPath(curr)) != 0) {
+      if (!FileNode_hasPath(curr, path)) {
          /* If the path of the file found does not match that of the one
             to be removed. */
          result =  NO_SUCH_PATH;
       }
-      /* If the correct file is found, destroy the node and decrement
-         the number of nodes in the file tree. */
+      /* If the correct file is found, unlink it from its parent,
+         destroy the node and decrement the number of nodes in the
+         file tree. */
       else {
+         (void) DTNode_unlinkChildFile(FileNode_getParent(curr), curr);
+         if(useIndex) {
+            FT_indexRemove(curr, TRUE);
+            FT_indexShrink();
+         }
          FileNode_destroy(curr);
          count--;
          result = SUCCESS;
       }
    }
-   /* Node with the same prefix as path to be inserted is found, but is
-      a directory. */
+   /* Node found is a directory other than the one at path. */
+   else if (!DTNode_hasPath((DTNode)curr, path)) {
+      result = NO_SUCH_PATH;
+   }
+   /* Node at path is found, but is a directory. */
    else {
       result = NOT_A_FILE;
    }
@@ -585,6 +1219,11 @@ int FT_rmFile(char* path) {
 
 /* ft.h contains specification. */
 int FT_init(void) {
+   return FT_initWithOptions(0);
+}
+
+/* ft.h contains specification. */
+int FT_initWithOptions(unsigned int options) {
    if(isInitialized) {
       return INITIALIZATION_ERROR;
    }
@@ -592,32 +1231,544 @@ int FT_init(void) {
    root = NULL;
    fileRoot = NULL;
    count = 0;
+   useIndex = (options & FT_PATH_INDEX) ? TRUE : FALSE;
+   DTNode_useFilters((options & FT_BLOOM_FILTERS) ? TRUE : FALSE);
+   DTNode_useMaps((options & FT_SORTED_CHILDREN) ? FALSE : TRUE);
+   useSlabs = (options & FT_SLAB_ALLOCATOR) ? TRUE : FALSE;
+   DTNode_useSlabs(useSlabs);
+   FileNode_useSlabs(useSlabs);
+   /* Without a pool, names are simply not shared. */
+   names = (options & FT_INTERN_NAMES) ? Intern_new() : NULL;
+   DTNode_useNames(names);
+   FileNode_useNames(names);
+   copyContents = (options & (FT_COPY_CONTENTS | FT_DEDUP_CONTENTS)) ?
+                  TRUE : FALSE;
+   /* Without a pool, copies are simply not shared. */
+   blobs = (options & FT_DEDUP_CONTENTS) ? Blob_new() : NULL;
+   FileNode_useBlobs(blobs);
+   pathIndex = NULL;
+   indexCapacity = 0;
+   indexSize = 0;
+   FT_cacheClear();
+   cacheHits = 0;
+   cacheMisses = 0;
+   handles = NULL;
+   handleCapacity = 0;
+   handleFirstFree = 0;
    return SUCCESS;
 }
 
 /* ft.h contains specification. */
-int FT_destroy(void) {
+int FT_openDir(char* path, FT_DirHandle* pHandle) {
+   struct FT_handleSlot* newHandles;
+   size_t newCapacity;
+   size_t slot;
+   DTNode curr;
+   int result = SUCCESS;
+
+   assert(path != NULL);
+   assert(pHandle != NULL);
+
    if(!isInitialized) {
       return INITIALIZATION_ERROR;
    }
-   if (fileRoot == NULL) {
-      FT_removePathFrom(root);
-   } else {
-      FileNode_destroy(fileRoot);
-   }
 
-   isInitialized = 0;
-   count = 0;
-   root = NULL;
-   fileRoot = NULL;
-   return SUCCESS;
-}
+   /* If root is a file, there are no directories to open. */
+   if(fileRoot != NULL) {
+      return FileNode_hasPath(fileRoot, path) ? NOT_A_DIRECTORY
+                                              : NO_SUCH_PATH;
+   }
 
-/* ft.h contains specification. */
-void *FT_getFileContents(char *path) {
-   FileNode curr;
+   curr = FT_lookupPath(path, &result);
+   if(curr == NULL) {
+      return NO_SUCH_PATH;
+   }
+   else if(result == PARENT_CHILD_ERROR) {
+      return FileNode_hasPath((FileNode) curr, path) ? NOT_A_DIRECTORY
+                                                     : NO_SUCH_PATH;
+   }
+   else if(!DTNode_hasPath(curr, path)) {
+      return NO_SUCH_PATH;
+   }
+
+   /* Finding a free slot, doubling the table if there is none. */
+   for(slot = handleFirstFree; slot < handleCapacity; slot++) {
+      if(handles[slot].dir == NULL)
+         break;
+   }
+   if(slot == handleCapacity) {
+      newCapacity = (handleCapacity == 0) ? 8 : 2 * handleCapacity;
+      newHandles = realloc(handles,
+                           newCapacity * sizeof(struct FT_handleSlot));
+      if(newHandles == NULL) {
+         return MEMORY_ERROR;
+      }
+      handles = newHandles;
+      for(; handleCapacity < newCapacity; handleCapacity++) {
+         handles[handleCapacity].dir = NULL;
+      }
+   }
+
+   handles[slot].dir = curr;
+   handles[slot].generation = ++handleGeneration;
+   handleFirstFree = slot + 1;
+
+   pHandle->slot = slot;
+   pHandle->generation = handleGeneration;
+   return SUCCESS;
+}
+
+/* ft.h contains specification. */
+int FT_closeDir(FT_DirHandle handle) {
+   if(!isInitialized) {
+      return INITIALIZATION_ERROR;
+   }
+   if(FT_handleDir(handle) == NULL) {
+      return NO_SUCH_PATH;
+   }
+   FT_handleFree(handle.slot);
+   return SUCCESS;
+}
+
+/* ft.h contains specification. */
+int FT_insertFileAt(FT_DirHandle handle, char* name, void *contents,
+                    size_t length) {
+   DTNode dir;
+   FileNode newFile;
+   boolean type;
+   size_t len;
+   int result;
+
+   assert(name != NULL);
+
+   if(!isInitialized) {
+      return INITIALIZATION_ERROR;
+   }
+   dir = FT_handleDir(handle);
+   if(dir == NULL) {
+      return NO_SUCH_PATH;
+   }
+
+   /* The name must be a single path component. */
+   len = strlen(name);
+   if(len == 0 || strchr(name, '/') != NULL) {
+      return PARENT_CHILD_ERROR;
+   }
+   if(DTNode_findChild(dir, name, len, &type, NULL)) {
+      return ALREADY_IN_TREE;
+   }
+
+   /* Reserving path index space first, as FT_insertRestOfPath does. */
+   if(useIndex && FT_indexReserve(1) != SUCCESS) {
+      return MEMORY_ERROR;
+   }
+
+   newFile = FT_newFile(name, len, dir, contents, length, copyContents);
+   if(newFile == NULL) {
+      return MEMORY_ERROR;
+   }
+   result = FT_linkParentToChildFile(dir, newFile);
+   if(result == SUCCESS) {
+      count++;
+      if(useIndex) {
+         FT_indexAdd(newFile, TRUE);
+      }
+   }
+   return result;
+}
+
+/* ft.h contains specification. */
+int FT_insertManyAt(FT_DirHandle handle, char** childNames,
+                    boolean* childTypes, void** childContents,
+                    size_t* childLengths, size_t n) {
+   DTNode dir;
+   void** children;
+   size_t len;
+   size_t made;
+   size_t i;
    int result;
 
+   assert(childNames != NULL || n == 0);
+   assert(childTypes != NULL || n == 0);
+   assert(childContents != NULL || n == 0);
+   assert(childLengths != NULL || n == 0);
+
+   if(!isInitialized) {
+      return INITIALIZATION_ERROR;
+   }
+   dir = FT_handleDir(handle);
+   if(dir == NULL) {
+      return NO_SUCH_PATH;
+   }
+
+   /* Each name must be a single path component. */
+   for(i = 0; i < n; i++) {
+      assert(childNames[i] != NULL);
+      if(childNames[i][0] == '\0' || strchr(childNames[i], '/') != NULL) {
+         return PARENT_CHILD_ERROR;
+      }
+   }
+   if(n == 0) {
+      return SUCCESS;
+   }
+
+   /* Reserving path index space first, as FT_insertRestOfPath does. */
+   if(useIndex && FT_indexReserve(n) != SUCCESS) {
+      return MEMORY_ERROR;
+   }
+   children = malloc(n * sizeof(void*));
+   if(children == NULL) {
+      return MEMORY_ERROR;
+   }
+
+   /* Creating every node before linking any, so that none is linked
+      unless all of them can be. */
+   result = SUCCESS;
+   for(made = 0; made < n; made++) {
+      len = strlen(childNames[made]);
+      if(childTypes[made]) {
+         children[made] = FT_newFile(childNames[made], len, dir,
+                                     childContents[made],
+                                     childLengths[made], copyContents);
+      }
+      else {
+         children[made] = DTNode_create(childNames[made], len, dir);
+      }
+      if(children[made] == NULL) {
+         result = MEMORY_ERROR;
+         break;
+      }
+   }
+   if(result == SUCCESS) {
+      result = DTNode_linkChildren(dir, children, childTypes, n);
+   }
+   if(result != SUCCESS) {
+      for(i = 0; i < made; i++) {
+         if(childTypes[i]) {
+            (void) FileNode_destroy(children[i]);
+         }
+         else {
+            (void) DTNode_destroy(children[i]);
+         }
+      }
+      free(children);
+      return result;
+   }
+
+   count += n;
+   if(useIndex) {
+      for(i = 0; i < n; i++) {
+         FT_indexAdd(children[i], childTypes[i]);
+      }
+   }
+   free(children);
+   return SUCCESS;
+}
+
+/* ft.h contains specification. */
+boolean FT_containsFileAt(FT_DirHandle handle, char* name) {
+   DTNode dir;
+   boolean type;
+
+   assert(name != NULL);
+
+   if(!isInitialized) {
+      return FALSE;
+   }
+   dir = FT_handleDir(handle);
+   if(dir == NULL) {
+      return FALSE;
+   }
+   return DTNode_findChild(dir, name, strlen(name), &type, NULL) &&
+          type;
+}
+
+/* ft.h contains specification. */
+void *FT_getFileContentsAt(FT_DirHandle handle, char* name) {
+   DTNode dir;
+   boolean type;
+   size_t childID;
+
+   assert(name != NULL);
+
+   if(!isInitialized) {
+      return NULL;
+   }
+   dir = FT_handleDir(handle);
+   if(dir == NULL) {
+      return NULL;
+   }
+   if(!DTNode_findChild(dir, name, strlen(name), &type, &childID) ||
+      !type) {
+      return NULL;
+   }
+   return FileNode_getContents(
+             (FileNode) DTNode_getChild(dir, childID, NULL));
+}
+
+/* ft.h contains specification. */
+int FT_rmFileAt(FT_DirHandle handle, char* name) {
+   DTNode dir;
+   FileNode file;
+   boolean type;
+   size_t childID;
+
+   assert(name != NULL);
+
+   if(!isInitialized) {
+      return INITIALIZATION_ERROR;
+   }
+   dir = FT_handleDir(handle);
+   if(dir == NULL) {
+      return NO_SUCH_PATH;
+   }
+   if(!DTNode_findChild(dir, name, strlen(name), &type, &childID)) {
+      return NO_SUCH_PATH;
+   }
+   if(!type) {
+      return NOT_A_FILE;
+   }
+
+   file = (FileNode) DTNode_getChild(dir, childID, NULL);
+   (void) DTNode_unlinkChildFile(dir, file);
+   if(useIndex) {
+      FT_indexRemove(file, TRUE);
+      FT_indexShrink();
+   }
+   FileNode_destroy(file);
+   count--;
+   return SUCCESS;
+}
+
+/* ft.h contains specification. */
+int FT_containsMany(char** paths, size_t n, boolean type,
+                    boolean* results) {
+   DTNode dir = NULL;
+   DTNode curr;
+   int result;
+   size_t i;
+
+   assert(paths != NULL || n == 0);
+   assert(results != NULL || n == 0);
+
+   if(!isInitialized) {
+      return INITIALIZATION_ERROR;
+   }
+
+   for(i = 0; i < n; i++) {
+      assert(paths[i] != NULL);
+
+      /* If root is a file, there is nothing to traverse. */
+      if(fileRoot != NULL) {
+         results[i] = type ? FT_containsFile(paths[i])
+                           : FT_containsDir(paths[i]);
+         continue;
+      }
+
+      result = SUCCESS;
+      curr = FT_lookupNext(paths[i], (i > 0) ? paths[i - 1] : NULL,
+                           &dir, &result);
+
+      /* If no node is found, or a node of the other type. */
+      if(curr == NULL || (result == PARENT_CHILD_ERROR) != type)
+         results[i] = FALSE;
+      else if(type)
+         results[i] = FileNode_hasPath((FileNode) curr, paths[i]);
+      else
+         results[i] = DTNode_hasPath(curr, paths[i]);
+   }
+   return SUCCESS;
+}
+
+/* ft.h contains specification. */
+int FT_statMany(char** paths, size_t n, int* statuses,
+                boolean* types, size_t* lengths) {
+   DTNode dir = NULL;
+   DTNode curr;
+   int result;
+   size_t i;
+
+   assert(paths != NULL || n == 0);
+   assert(statuses != NULL || n == 0);
+   assert(types != NULL || n == 0);
+   assert(lengths != NULL || n == 0);
+
+   if(!isInitialized) {
+      return INITIALIZATION_ERROR;
+   }
+
+   for(i = 0; i < n; i++) {
+      assert(paths[i] != NULL);
+
+      /* If root is a file, there is nothing to traverse. */
+      if(fileRoot != NULL) {
+         statuses[i] = FT_stat(paths[i], &types[i], &lengths[i]);
+         continue;
+      }
+
+      result = SUCCESS;
+      curr = FT_lookupNext(paths[i], (i > 0) ? paths[i - 1] : NULL,
+                           &dir, &result);
+
+      /* Neither file nor directory found. */
+      if(curr == NULL) {
+         statuses[i] = NO_SUCH_PATH;
+      }
+      /* File found. */
+      else if(result == PARENT_CHILD_ERROR) {
+         if(FileNode_hasPath((FileNode) curr, paths[i])) {
+            types[i] = TRUE;
+            lengths[i] = FileNode_getLength((FileNode) curr);
+            statuses[i] = SUCCESS;
+         }
+         else {
+            statuses[i] = NO_SUCH_PATH;
+         }
+      }
+      /* Directory found. */
+      else if(DTNode_hasPath(curr, paths[i])) {
+         types[i] = FALSE;
+         statuses[i] = SUCCESS;
+      }
+      else {
+         statuses[i] = NO_SUCH_PATH;
+      }
+   }
+   return SUCCESS;
+}
+
+/* ft.h contains specification. */
+int FT_getCacheStats(size_t* pHits, size_t* pMisses) {
+   assert(pHits != NULL);
+   assert(pMisses != NULL);
+
+   if(!isInitialized) {
+      return INITIALIZATION_ERROR;
+   }
+   *pHits = cacheHits;
+   *pMisses = cacheMisses;
+   return SUCCESS;
+}
+
+/* ft.h contains specification. */
+int FT_getFilterStats(size_t* pProbes, size_t* pRejects,
+                      size_t* pFalsePositives) {
+   assert(pProbes != NULL);
+   assert(pRejects != NULL);
+   assert(pFalsePositives != NULL);
+
+   if(!isInitialized) {
+      return INITIALIZATION_ERROR;
+   }
+   DTNode_getFilterStats(pProbes, pRejects, pFalsePositives);
+   return SUCCESS;
+}
+
+/* ft.h contains specification. */
+int FT_getContentsStats(size_t* pLogical, size_t* pPhysical) {
+   size_t tally[NUM_MEMORY_KINDS];
+
+   assert(pLogical != NULL);
+   assert(pPhysical != NULL);
+
+   if(!isInitialized) {
+      return INITIALIZATION_ERROR;
+   }
+   /* The lengths are tallied as files gain and lose their copies;
+      shared copies are counted once by their pool. */
+   DTNode_getMemory(tally);
+   *pLogical = tally[MEMORY_COPIED_LENGTHS];
+   *pPhysical = tally[MEMORY_UNSHARED_LENGTHS];
+   if(blobs != NULL)
+      *pPhysical += Blob_getBytes(blobs);
+   return SUCCESS;
+}
+
+/* ft.h contains specification. */
+int FT_getMemoryStats(struct FT_memoryStats* pStats) {
+   size_t tally[NUM_MEMORY_KINDS];
+   size_t length;
+   size_t physLength;
+   size_t treeLength;
+   size_t treeBytes;
+
+   assert(pStats != NULL);
+
+   if(!isInitialized) {
+      return INITIALIZATION_ERROR;
+   }
+   DTNode_getMemory(tally);
+   DynArray_getTotals(&length, &physLength);
+   BTree_getTotals(&treeLength, &treeBytes);
+
+   pStats->nodeBytes = tally[MEMORY_NODES];
+   pStats->nameBytes = tally[MEMORY_NAMES];
+   if(names != NULL)
+      pStats->nameBytes += Intern_getBytes(names);
+   pStats->arrayCapacityBytes = physLength * sizeof(void*) + treeBytes;
+   pStats->arrayLengthBytes = (length + treeLength) * sizeof(void*);
+   pStats->lookupBytes = tally[MEMORY_LOOKUP] +
+                         indexCapacity * sizeof(struct FT_indexEntry);
+   pStats->contentsBytes = tally[MEMORY_CONTENTS];
+   if(blobs != NULL)
+      pStats->contentsBytes += Blob_getBytes(blobs);
+   return SUCCESS;
+}
+
+/* ft.h contains specification. */
+int FT_destroy(void) {
+   if(!isInitialized) {
+      return INITIALIZATION_ERROR;
+   }
+   if (fileRoot != NULL) {
+      FileNode_destroy(fileRoot);
+   } else if (useSlabs && root != NULL) {
+      /* The FileNodes go with their slab below. */
+      DTNode_destroyAll();
+   } else {
+      FT_removePathFrom(root);
+   }
+
+   free(pathIndex);
+   FT_cacheClear();
+   free(handles);
+
+   /* Every node has been destroyed, or goes with its slab, so their
+      slabs and names can be freed. */
+   DTNode_useSlabs(FALSE);
+   FileNode_useSlabs(FALSE);
+   DTNode_useNames(NULL);
+   FileNode_useNames(NULL);
+   if(names != NULL)
+      Intern_free(names);
+   names = NULL;
+   FileNode_freeContentsPool();
+   FileNode_useBlobs(NULL);
+   if(blobs != NULL)
+      Blob_free(blobs);
+   blobs = NULL;
+   copyContents = FALSE;
+
+   isInitialized = 0;
+   count = 0;
+   useSlabs = FALSE;
+   root = NULL;
+   fileRoot = NULL;
+   useIndex = FALSE;
+   pathIndex = NULL;
+   indexCapacity = 0;
+   indexSize = 0;
+   handles = NULL;
+   handleCapacity = 0;
+   handleFirstFree = 0;
+   return SUCCESS;
+}
+
+/* ft.h contains specification. */
+void *FT_getFileContents(char *path) {
+   FileNode curr;
+   int result = SUCCESS;
+
    assert(path != NULL);
 
    /* If trying to retrieve contents of a file from an uninitialized
@@ -630,7 +1781,7 @@ void *FT_getFileContents(char *path) {
    if (fileRoot != NULL) {
       /* If path of root file is same as path of file whose contents are
          to be retrieved. */
-      if ((strcmp(path, FileNode_getPath(fileRoot))) == 0) {
+      if (FileNode_hasPath(fileRoot, path)) {
          return FileNode_getContents(fileRoot);
       }
       /* If not, since no other files can exist in the tree, return NULL. */
@@ -639,7 +1790,7 @@ void *FT_getFileContents(char *path) {
       }
    }
 
-   curr = (FileNode) FT_traversePath(path, &result);
+   curr = (FileNode) FT_lookupPath(path, &result);
 
    /* If no node is found whose path  matches the prefix of the path. */
    if(curr == NULL) {
@@ -650,7 +1801,7 @@ void *FT_getFileContents(char *path) {
    else if (result == PARENT_CHILD_ERROR) {
       /* The path of the file found is not the same as that of the
          one whose contents are to be retrived. */
-      if (strcmp(path, FileNode_getPath(curr)) != 0) {
+      if (!FileNode_hasPath(curr, path)) {
          return NULL;
       }
       /* Path of the file found are the same as that of the one whose
@@ -664,11 +1815,30 @@ void *FT_getFileContents(char *path) {
    }
 }
 
+/* Replaces the contents of file with newContents, of newLength bytes,
+   copying them if files hold copies or file already holds its own.
+   Returns the old contents, or, when copying, newContents, as
+   FT_replaceFileContents specifies, or NULL if insufficient memory is
+   available for a copy. */
+static void* FT_replaceContentsOf(FileNode file, void *newContents,
+                                  size_t newLength) {
+   assert(file != NULL);
+
+   if(!copyContents && !FileNode_ownsContents(file))
+      return FileNode_replaceContents(file, newContents, newLength);
+
+   /* The file's copy is never handed to the client, who may free what
+      is returned. */
+   if(!FileNode_copyContents(file, newContents, newLength))
+      return NULL;
+   return newContents;
+}
+
 /* ft.h contains specification. */
 void *FT_replaceFileContents(char *path, void *newContents,
                              size_t newLength) {
    FileNode curr;
-   int result;
+   int result = SUCCESS;
 
    assert(path != NULL);
 
@@ -682,9 +1852,8 @@ void *FT_replaceFileContents(char *path, void *newContents,
    if (fileRoot != NULL) {
       /* If path of root file is same as path of file whose contents are
         to be replaced. */
-      if ((strcmp(path, FileNode_getPath(fileRoot))) == 0) {
-         return FileNode_replaceContents(fileRoot, newContents,
-                                         newLength);
+      if (FileNode_hasPath(fileRoot, path)) {
+         return FT_replaceContentsOf(fileRoot, newContents, newLength);
       }
       /* If not, since no other files can exist in the tree, return NULL. */
       else {
@@ -692,7 +1861,7 @@ void *FT_replaceFileContents(char *path, void *newContents,
       }
    }
 
-   curr = (FileNode) FT_traversePath(path, &result);
+   curr = (FileNode) FT_lookupPath(path, &result);
 
    /* If no node is found whose path  matches the prefix of the path. */
    if(curr == NULL) {
@@ -702,13 +1871,13 @@ void *FT_replaceFileContents(char *path, void *newContents,
    else if (result == PARENT_CHILD_ERROR) {
       /* The path of the file found is not the same as that of the
          one whose contents are to be replaced. */
-      if (strcmp(path, FileNode_getPath(curr)) != 0) {
+      if (!FileNode_hasPath(curr, path)) {
          return NULL;
       }
       /* Path of the file found are the same as that of the one whose
          contents are to be replaced. */
       else {
-         return FileNode_replaceContents(curr, newContents, newLength);
+         return FT_replaceContentsOf(curr, newContents, newLength);
       }
    }
    else {
@@ -716,6 +1885,46 @@ void *FT_replaceFileContents(char *path, void *newContents,
    }
 }
 
+/* ft.h contains specification. */
+int FT_replaceFileContentsCopy(char *path, const void *newContents,
+                               size_t newLength) {
+   FileNode curr;
+   int result = SUCCESS;
+
+   assert(path != NULL);
+
+   if(!isInitialized) {
+      return INITIALIZATION_ERROR;
+   }
+
+   /* If root node is a file, it is the only file there is. */
+   if (fileRoot != NULL) {
+      if (!FileNode_hasPath(fileRoot, path)) {
+         return NO_SUCH_PATH;
+      }
+      curr = fileRoot;
+   }
+   else {
+      curr = (FileNode) FT_lookupPath(path, &result);
+      if(curr == NULL) {
+         return NO_SUCH_PATH;
+      }
+      /* If a directory is found, at path or above it. */
+      if (result != PARENT_CHILD_ERROR) {
+         return DTNode_hasPath((DTNode)curr, path) ? NOT_A_FILE
+                                                   : NO_SUCH_PATH;
+      }
+      if (!FileNode_hasPath(curr, path)) {
+         return NO_SUCH_PATH;
+      }
+   }
+
+   if(!FileNode_copyContents(curr, newContents, newLength)) {
+      return MEMORY_ERROR;
+   }
+   return SUCCESS;
+}
+
 /* ft.h contains specification. */
 int FT_stat(char *path, boolean* type, size_t* length) {
    DTNode currDir;
@@ -727,22 +1936,22 @@ int FT_stat(char *path, boolean* type, size_t* length) {
    /* If trying to check status of a path in an uninitialized
       file tree. */
    if(!isInitialized) {
-      return FALSE;
+      return INITIALIZATION_ERROR;
    }
 
    /* If root node is a file. */
    if (fileRoot != NULL) {
       /* If path of root file is same as input path. */
-      if ((strcmp(path, FileNode_getPath(fileRoot))) == 0) {
+      if (FileNode_hasPath(fileRoot, path)) {
          *type = TRUE;
          *length = FileNode_getLength(fileRoot);
          return SUCCESS;
       } else {
-         return NULL;
+         return NO_SUCH_PATH;
       }
    }
 
-   currDir = FT_traversePath(path, &result);
+   currDir = FT_lookupPath(path, &result);
 
    /* Neither file not directory found. */
    if(currDir == NULL) {
@@ -752,7 +1961,7 @@ int FT_stat(char *path, boolean* type, size_t* length) {
    else if (result == PARENT_CHILD_ERROR) {
       currFile = (FileNode)currDir;
       /* Different file found. */
-      if (strcmp(path, FileNode_getPath(currFile)) != 0) {
+      if (!FileNode_hasPath(currFile, path)) {
          result =  NO_SUCH_PATH;
       }
       /* Correct file found. */
@@ -763,7 +1972,7 @@ int FT_stat(char *path, boolean* type, size_t* length) {
       }
    }
    /* Different directory found. */
-   else if (strcmp(path, DTNode_getPath(currDir))) {
+   else if (!DTNode_hasPath(currDir, path)) {
       result = NO_SUCH_PATH;
    }
    /* Directory found. */
@@ -775,64 +1984,72 @@ int FT_stat(char *path, boolean* type, size_t* length) {
 }
 
 /*
-  Performs a pre-order traversal of the tree rooted at n,
-  inserting each payload to DynArray_T d beginning at index i.
-  Returns the next unused index in d after the insertion(s).
+  Returns the total length of the paths of the nodes in the tree
+  rooted at n, counting one more for each node to hold a newline.
 */
-static size_t FT_preOrderTraversal(DTNode n, DynArray_T d, size_t i) {
+static size_t FT_preOrderLength(DTNode n) {
+   size_t total;
    size_t c;
+   DTNode child;
+   boolean type;
 
-   assert(d != NULL);
-
-   if(n != NULL) {
-      (void) DynArray_set(d, i, DTNode_getPath(n));
-      i++;
+   assert(n != NULL);
 
-      /* Traversing all the file children of a given DTNode. */
-      for (c = 0; c < DTNode_getNumFileChildren(n); c++) {
-         (void) DynArray_set(d, i,
-                             FileNode_getPath((FileNode)DTNode_getChild(n, c, TRUE)));
-         i++;
-      }
-
-      /* Recursively traversing all the directory children of a given
-         DTNode. */
-      for(c = 0; c < DTNode_getNumDTChildren(n); c++) {
-         i = FT_preOrderTraversal(DTNode_getChild(n, c, FALSE), d, i);
-      }
+   total = DTNode_getPathLength(n) + 1;
+   for (c = 0; c < DTNode_getNumChildren(n); c++) {
+      child = DTNode_getChild(n, c, &type);
+      if(type)
+         total += FileNode_getPathLength((FileNode)child) + 1;
+      else
+         total += FT_preOrderLength(child);
    }
-   return i;
+   return total;
 }
 
 /*
-  Alternate version of strlen that uses pAcc as an in-out parameter
-  to accumulate a string length, rather than returning the length of
-  str, and also always adds one more in addition to str's length.
+  Performs a pre-order traversal of the tree rooted at n,
+  writing each node's path followed by a newline into acc.
+  Returns the position in acc after the last newline written.
 */
-static void FT_strlenAccumulate(char* str, size_t* pAcc) {
-   assert(pAcc != NULL);
-
-   if(str != NULL)
-      *pAcc += (strlen(str) + 1);
-}
+static char* FT_preOrderTraversal(DTNode n, char* acc) {
+   size_t c;
+   DTNode child;
+   boolean type;
 
-/*
-  Alternate version of strcat that inverts the typical argument
-  order, appending str onto acc, and also always adds a newline at
-  the end of the concatenated string.
-*/
-static void FT_strcatAccumulate(char* str, char* acc) {
+   assert(n != NULL);
    assert(acc != NULL);
 
-   if(str != NULL)
-      strcat(acc, str); strcat(acc, "\n");
+   DTNode_sortChildren(n);
+   (void) DTNode_writePath(n, acc);
+   acc += DTNode_getPathLength(n);
+   *acc++ = '\n';
+
+   /* Traversing all the file children of a given DTNode, which are
+      listed before any directory. */
+   for (c = 0; c < DTNode_getNumChildren(n); c++) {
+      child = DTNode_getChild(n, c, &type);
+      if(type) {
+         (void) FileNode_writePath((FileNode)child, acc);
+         acc += FileNode_getPathLength((FileNode)child);
+         *acc++ = '\n';
+      }
+   }
+
+   /* Recursively traversing all the directory children of a given
+      DTNode. */
+   for(c = 0; c < DTNode_getNumChildren(n); c++) {
+      child = DTNode_getChild(n, c, &type);
+      if(!type)
+         acc = FT_preOrderTraversal(child, acc);
+   }
+   return acc;
 }
 
 /* ft.h contains specification. */
 char *FT_toString() {
-   DynArray_T nodes;
    size_t totalStrlen = 1;
    char* result = NULL;
+   char* end;
 
    /* If trying to retrieve string representation of an
       uninitialized file tree. */
@@ -842,28 +2059,25 @@ char *FT_toString() {
 
    /* If root is file, returning string representation of its path. */
    if (fileRoot != NULL) {
-      return (char*)FileNode_getPath(fileRoot);
+      return FileNode_toString(fileRoot);
    }
 
    /* Else, conducting pre-order traversal to go through all nodes in a
-      given tree. */
-   nodes = DynArray_new(count);
-   (void) FT_preOrderTraversal(root, nodes, 0);
-
-   DynArray_map(nodes, (void (*)(void *, void*)) FT_strlenAccumulate,
-                (void*) &totalStrlen);
+      given tree, writing each path directly into the result. */
+   if(root != NULL) {
+      totalStrlen += FT_preOrderLength(root);
+   }
 
    result = malloc(totalStrlen);
    if(result == NULL) {
-      DynArray_free(nodes);
       return NULL;
    }
 
-   *result = '\0';
-
-   DynArray_map(nodes, (void (*)(void *, void*)) FT_strcatAccumulate,
-                (void *) result);
+   end = result;
+   if(root != NULL) {
+      end = FT_preOrderTraversal(root, end);
+   }
+   *end = '\0';
 
-   DynArray_free(nodes);
    return result;
 }
@@ -41,6 +41,20 @@ boolean FT_containsDir(char *path);
 */
 int FT_rmDir(char *path);
 
+/*
+  Inserts a new directory into the tree at path, as FT_insertDir does
+  and with the same results, whose whole subtree is allocated from an
+  arena of its own. FT_rmDir of the directory then frees the arena in
+  one go, taking the number of nodes removed from a count kept as they
+  are inserted, instead of visiting and freeing every node beneath it.
+  Suits large scratch hierarchies that are discarded whole. Removing
+  part of the subtree still visits that part, and FT_PATH_INDEX, if in
+  use, still removes the path of every node. Names in the subtree are
+  not shared under FT_INTERN_NAMES. Beneath another such directory,
+  the new directory is simply part of that one's subtree.
+*/
+int FT_insertArenaDir(char *path);
+
 /*
    Inserts a new file into the hierarchy at the given path, with the
    given contents of size length. The path's parent must exist as
@@ -55,6 +69,17 @@ int FT_rmDir(char *path);
 */
 int FT_insertFile(char *path, void *contents, size_t length);
 
+/*
+  Inserts a new file into the hierarchy at the given path, as
+  FT_insertFile does and with the same results, holding the tree's own
+  copy of the length bytes at contents rather than contents itself.
+  The copy is allocated from a pool of power-of-two size classes and
+  freed when the file is removed. FT_getFileContents returns the copy,
+  which stays valid until then or until the file's contents are
+  replaced.
+*/
+int FT_insertFileCopy(char *path, const void *contents, size_t length);
+
 /*
   Returns TRUE if the tree contains the full path parameter as a
   file and FALSE otherwise.
@@ -84,10 +109,33 @@ void *FT_getFileContents(char *path);
   the parameter newContents of size newLength.
   Returns the old contents if successful.
   Returns NULL if the path does not already exist or is a directory.
+
+  If the file holds the tree's own copy of its contents, or if
+  FT_COPY_CONTENTS is in use, newContents is copied instead, as by
+  FT_replaceFileContentsCopy, and newContents itself is returned,
+  still the client's, since the old copy is reused or freed; NULL is
+  then also returned if unable to allocate sufficient memory. Either
+  way, the pointer returned is never the tree's own copy.
 */
 void *FT_replaceFileContents(char *path, void *newContents,
                              size_t newLength);
 
+/*
+  Replaces current contents of the file at the full path parameter with
+  the tree's own copy of the newLength bytes at newContents. The file's
+  current copy, if it has one, is reused when newLength falls in its
+  size class, and freed otherwise; contents belonging to the client are
+  no longer referenced.
+  Returns SUCCESS if the contents are replaced,
+  returns INITIALIZATION_ERROR if not in an initialized state,
+  returns NOT_A_FILE if path exists but is a directory not a file,
+  returns NO_SUCH_PATH if the path does not exist in the hierarchy,
+  returns MEMORY_ERROR if unable to allocate sufficient memory, leaving
+  the contents unchanged.
+*/
+int FT_replaceFileContentsCopy(char *path, const void *newContents,
+                               size_t newLength);
+
 /*
   Returns SUCCESS if path exists in the hierarchy,
   returns NO_SUCH_PATH if it does not, and
@@ -102,6 +150,122 @@ void *FT_replaceFileContents(char *path, void *newContents,
  */
 int FT_stat(char *path, boolean* type, size_t* length);
 
+/*
+  A handle to a directory opened by FT_openDir, to be passed by value
+  to the functions below that operate on entries of that directory
+  without traversing the tree from the root. A handle stays valid until
+  it is passed to FT_closeDir, its directory is removed by FT_rmDir, or
+  FT_destroy is called. Using a handle that is no longer valid is
+  detected, never undefined.
+*/
+typedef struct FT_DirHandle {
+   /* the handle's slot in the table of open directories */
+   size_t slot;
+
+   /* a number unique to this handle among all handles opened */
+   size_t generation;
+} FT_DirHandle;
+
+/*
+  Opens the directory at path, storing a handle to it in *pHandle.
+  Returns SUCCESS if the directory is opened,
+  returns INITIALIZATION_ERROR if not in an initialized state,
+  returns NO_SUCH_PATH if path does not exist in the hierarchy,
+  returns NOT_A_DIRECTORY if path is a file,
+  returns MEMORY_ERROR if unable to allocate sufficient memory.
+*/
+int FT_openDir(char *path, FT_DirHandle *pHandle);
+
+/*
+  Closes handle, which is no longer valid afterward.
+  Returns SUCCESS if handle was valid and is closed,
+  returns INITIALIZATION_ERROR if not in an initialized state,
+  returns NO_SUCH_PATH if handle is not valid.
+*/
+int FT_closeDir(FT_DirHandle handle);
+
+/*
+  Inserts a new file named name, with the given contents of size
+  length, into the directory open as handle. name is a single path
+  component: it is not empty and contains no slash.
+  Returns SUCCESS if the new file is inserted,
+  returns INITIALIZATION_ERROR if not in an initialized state,
+  returns NO_SUCH_PATH if handle is not valid,
+  returns ALREADY_IN_TREE if name already exists (as dir or file),
+  returns PARENT_CHILD_ERROR if name is not a single path component,
+  returns MEMORY_ERROR if unable to allocate sufficient memory.
+*/
+int FT_insertFileAt(FT_DirHandle handle, char *name, void *contents,
+                    size_t length);
+
+/*
+  Inserts n new entries into the directory open as handle, all or
+  none of them: for each i, a file named childNames[i] with contents
+  childContents[i] of size childLengths[i] if childTypes[i] is TRUE,
+  and an empty directory named childNames[i] otherwise, whose
+  childContents[i] and childLengths[i] are ignored. The entries are
+  merged into the directory's children in one pass rather than
+  inserted one at a time, which suits restoring a directory from a
+  listing; names given in sorted order save a sort.
+  Returns SUCCESS if every entry is inserted,
+  returns INITIALIZATION_ERROR if not in an initialized state,
+  returns NO_SUCH_PATH if handle is not valid,
+  returns PARENT_CHILD_ERROR if a name is not a single path component,
+  returns ALREADY_IN_TREE if a name already exists (as dir or file) or
+  is given twice,
+  returns MEMORY_ERROR if unable to allocate sufficient memory.
+  Unless SUCCESS is returned, no entry is inserted.
+*/
+int FT_insertManyAt(FT_DirHandle handle, char **childNames,
+                    boolean *childTypes, void **childContents,
+                    size_t *childLengths, size_t n);
+
+/*
+  Returns TRUE if the directory open as handle contains a file named
+  name and FALSE otherwise, including if handle is not valid.
+*/
+boolean FT_containsFileAt(FT_DirHandle handle, char *name);
+
+/*
+  Returns the contents of the file named name in the directory open as
+  handle, or NULL if there is no such file or handle is not valid.
+  As with FT_getFileContents, the contents of a file may be NULL.
+*/
+void *FT_getFileContentsAt(FT_DirHandle handle, char *name);
+
+/*
+  Removes the file named name from the directory open as handle.
+  Returns SUCCESS if found and removed.
+  Returns INITIALIZATION_ERROR if not in an initialized state.
+  Returns NO_SUCH_PATH if handle is not valid or there is no such entry.
+  Returns NOT_A_FILE if name is a directory not a file.
+*/
+int FT_rmFileAt(FT_DirHandle handle, char *name);
+
+/*
+  Sets results[i] to TRUE if the tree contains paths[i] as a file, if
+  type is TRUE, or as a directory, if type is FALSE, and to FALSE
+  otherwise, for each of the n paths, as FT_containsFile or
+  FT_containsDir would.
+  Paths given in sorted order are resolved fastest: each resumes from
+  the directories already reached for the one before it.
+  Returns INITIALIZATION_ERROR, leaving results unchanged, if not in an
+  initialized state, and SUCCESS otherwise.
+*/
+int FT_containsMany(char **paths, size_t n, boolean type,
+                    boolean *results);
+
+/*
+  Sets statuses[i], types[i] and lengths[i] as FT_stat(paths[i],
+  &types[i], &lengths[i]) would return and set them, for each of the
+  n paths. Paths given in sorted order are resolved fastest, as for
+  FT_containsMany.
+  Returns INITIALIZATION_ERROR, leaving all arrays unchanged, if not in
+  an initialized state, and SUCCESS otherwise.
+*/
+int FT_statMany(char **paths, size_t n, int *statuses,
+                boolean *types, size_t *lengths);
+
 /*
   Sets the data structure to initialized status.
   The data structure is initially empty.
@@ -110,6 +274,136 @@ int FT_stat(char *path, boolean* type, size_t* length);
 */
 int FT_init(void);
 
+/* Options for FT_initWithOptions, which may be combined with |. */
+enum {
+   /* Maintain a hash index of every full path, so that FT_containsDir,
+      FT_containsFile, FT_getFileContents, FT_replaceFileContents and
+      FT_stat run in time proportional to the path length rather than
+      walking the tree, at the cost of extra memory and slightly
+      slower insertions and removals. */
+   FT_PATH_INDEX = 0x1,
+
+   /* Keep a Bloom filter over the child names of each directory with
+      many children, so that a lookup of a path that does not exist
+      usually stops at the first such directory missing a component
+      without searching its children. Has no effect on lookups
+      answered by FT_PATH_INDEX. */
+   FT_BLOOM_FILTERS = 0x2,
+
+   /* Allocate directory and file nodes, with their names, from slabs
+      of fixed-size nodes carved out of large chunks rather than with
+      one malloc each, and free the chunks in bulk in FT_destroy. */
+   FT_SLAB_ALLOCATOR = 0x4,
+
+   /* Store each distinct name of a directory or file once, shared by
+      every node with that name, rather than once per node, and let a
+      lookup of a name that no node has stop without searching. Saves
+      memory in trees whose names repeat, such as many directories
+      each holding the same few files. */
+   FT_INTERN_NAMES = 0x8,
+
+   /* Have every file hold the tree's own copy of its contents, as if
+      FT_insertFile, FT_insertFileAt and FT_replaceFileContents were
+      FT_insertFileCopy and FT_replaceFileContentsCopy, so that
+      clients need not keep contents alive or copy them themselves. */
+   FT_COPY_CONTENTS = 0x10,
+
+   /* As FT_COPY_CONTENTS, which it implies, but with equal contents
+      stored once, their copy shared by every file holding them and
+      freed when the last is removed or replaced. Shared contents must
+      not be modified through the pointers returned for them. Files
+      under directories inserted by FT_insertArenaDir hold copies of
+      their own, which go with the arena. */
+   FT_DEDUP_CONTENTS = 0x20,
+
+   /* Keep the children of every directory sorted by name, rather than
+      locating those of a directory with many children through a hash
+      map and appending new ones unsorted. Saves the memory of the
+      maps and the sort before traversing such a directory, at the
+      cost of a binary search per lookup. A directory with thousands of
+      children holds them in a B+-tree, so that inserting or removing
+      one never shifts the rest. */
+   FT_SORTED_CHILDREN = 0x40
+};
+
+/*
+  Sets the data structure to initialized status, as FT_init does,
+  with the behaviors selected by options enabled.
+  Returns INITIALIZATION_ERROR if already initialized,
+  and SUCCESS otherwise.
+*/
+int FT_initWithOptions(unsigned int options);
+
+/*
+  Stores in *pHits the number of traversals from the root since
+  initialization that resumed instead from a recently reached directory
+  on the path, and in *pMisses the number that did not. Inserting many
+  entries into one directory in a row should yield mostly hits.
+  Returns INITIALIZATION_ERROR if not in an initialized state,
+  and SUCCESS otherwise.
+*/
+int FT_getCacheStats(size_t* pHits, size_t* pMisses);
+
+/*
+  Stores in *pProbes the number of directory searches that consulted a
+  Bloom filter since initialization, in *pRejects the number of those
+  answered by the filter alone, and in *pFalsePositives the number the
+  filter passed that then found no such child. All are 0 unless
+  FT_BLOOM_FILTERS is in use.
+  Returns INITIALIZATION_ERROR if not in an initialized state,
+  and SUCCESS otherwise.
+*/
+int FT_getFilterStats(size_t* pProbes, size_t* pRejects,
+                      size_t* pFalsePositives);
+
+/*
+  Stores in *pLogical the total length of the contents of which files
+  hold the tree's own copies, counting shared contents once per file,
+  and in *pPhysical the number of bytes of those copies stored,
+  counting shared contents once. Their ratio is the saving of
+  FT_DEDUP_CONTENTS, without which they are equal. Contents belonging
+  to the client count in neither.
+  Returns INITIALIZATION_ERROR if not in an initialized state,
+  and SUCCESS otherwise.
+*/
+int FT_getContentsStats(size_t* pLogical, size_t* pPhysical);
+
+/*
+  A breakdown of the memory held by the tree, in bytes requested from
+  its allocators, not counting their own overhead. Each figure is kept
+  up to date as the tree changes, so it is cheap to read at any time.
+*/
+struct FT_memoryStats {
+   /* the structs of the directories and files */
+   size_t nodeBytes;
+
+   /* the names of the directories and files, the components of their
+      paths, each interned name counted once */
+   size_t nameBytes;
+
+   /* the arrays of the children of large directories, and the
+      B-trees of the largest, allocated and in use; the difference is
+      the room left by doubling the arrays and in the trees' nodes,
+      and that of the frozen copies of read-mostly arrays */
+   size_t arrayCapacityBytes;
+   size_t arrayLengthBytes;
+
+   /* the hash maps, Bloom filters and path index that speed lookups */
+   size_t lookupBytes;
+
+   /* the tree's own copies of file contents, each at its allocated
+      size, shared copies counted once by their length */
+   size_t contentsBytes;
+};
+
+/*
+  Stores in *pStats the breakdown of the memory currently held by the
+  tree.
+  Returns INITIALIZATION_ERROR if not in an initialized state,
+  and SUCCESS otherwise.
+*/
+int FT_getMemoryStats(struct FT_memoryStats* pStats);
+
 /*
   Removes all contents of the data structure and
   returns it to uninitialized status.
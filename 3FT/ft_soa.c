@@ -0,0 +1,1529 @@
+/*--------------------------------------------------------------------*/
+/* ft_soa.c                                                           */
+/*--------------------------------------------------------------------*/
+
+/*
+  An alternative implementation of ft.h in which the nodes of the File
+  Tree are not separately allocated DTNodes and FileNodes linked by
+  pointers, but 32-bit indices into parallel arrays, one array per
+  field. A node costs about half the memory of a DTNode or FileNode
+  with its malloc header, the arrays are grown rather than allocated
+  node by node, and whole-tree scans read each array in order.
+
+  Every child is found through a single hash table keyed by its parent
+  and name, so the options of FT_initWithOptions, which tune the
+  pointer-linked representation, are accepted and ignored, and the
+  cache and filter statistics are always 0. The exceptions are
+  FT_COPY_CONTENTS and FT_DEDUP_CONTENTS, which change what the tree
+  stores, and whose copies come from an Arena_T or a Blob_T pool as in
+  ft.c.
+*/
+
+#include <assert.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <limits.h>
+
+#include "ft.h"
+#include "arena.h"
+#include "blob.h"
+#include "hash.h"
+
+/* A node is identified by its index in the arrays below. An unsigned
+   int has 32 bits on the platforms this is built for. */
+typedef unsigned int FT_node;
+
+/* The index of no node. */
+static const FT_node NONE = UINT_MAX;
+
+/* The kinds of node. A free node's index is on the free list. */
+enum { FT_FREE, FT_DIR, FT_FILE };
+
+/* The fewest nodes, characters of names, and child table slots
+   allocated at once. */
+enum { MIN_NODES = 64, MIN_NAMES = 256, MIN_TABLE = 64 };
+
+/* A File Tree is an AO with 3 state variables: */
+
+/* a flag for if it is in an initialized state (TRUE) or not (FALSE) */
+static boolean isInitialized;
+/* the root of the hierarchy, a directory or a file, or NONE */
+static FT_node root;
+/* a counter of the number of nodes in the hierarchy */
+static size_t count;
+
+/* and the fields of its nodes, each an array indexed by node: */
+
+/* the kind of the node */
+static unsigned char* kind;
+/* the parent directory of the node, NONE for the root */
+static FT_node* parent;
+/* the most recently inserted child of a directory, or NONE */
+static FT_node* firstChild;
+/* the next and previous children of the node's parent, in no
+   particular order, or NONE; a free node's next is the next free node */
+static FT_node* nextSibling;
+static FT_node* prevSibling;
+/* the offset in names of the final component of the node's path */
+static unsigned int* nameOffset;
+/* the length of the node's full path */
+static unsigned int* pathLen;
+/* the hash of the node's parent and name, locating it in the table */
+static unsigned int* hashes;
+/* the contents of a file and their length */
+static void** contents;
+static size_t* lengths;
+/* TRUE if a file's contents are the tree's own copy */
+static unsigned char* owned;
+
+/* the number of nodes the arrays have room for, the number of nodes
+   ever used, the most recently freed node, or NONE, and the number of
+   free nodes */
+static FT_node nodeCapacity;
+static FT_node nodesUsed;
+static FT_node freeNodes;
+static FT_node freeCount;
+
+/* and the names of its nodes, each nul-terminated, in one buffer: */
+
+/* the buffer */
+static char* names;
+/* the size of the buffer, the number of characters used, and the
+   number of those that belonged to nodes since freed */
+static size_t namesCapacity;
+static size_t namesUsed;
+static size_t namesFreed;
+
+/* and a child table: an open-addressing hash table, using linear
+   probing, of every node but the root, keyed by parent and name */
+
+/* the slots of the table, each a node or NONE */
+static FT_node* table;
+/* the number of slots, a power of two */
+static size_t tableCapacity;
+/* the number of nodes in the table */
+static size_t tableSize;
+
+/* and a table of the directories opened by FT_openDir, indexed by the
+   slot of each handle, as in ft.c. */
+
+/* A slot in the handle table. A free slot has a dir of NONE. */
+struct FT_handleSlot {
+   /* the open directory */
+   FT_node dir;
+
+   /* the generation of the handle that opened dir */
+   size_t generation;
+};
+
+/* the slots of the handle table, or NULL if none are allocated yet */
+static struct FT_handleSlot* handles;
+/* the number of slots in the handle table */
+static size_t handleCapacity;
+/* no slot below this index is free */
+static size_t handleFirstFree;
+/* the generation given to the last handle opened, never reset */
+static size_t handleGeneration;
+
+/* and the copies of contents held by files: */
+
+/* TRUE if, initialized with FT_COPY_CONTENTS, every file holds one */
+static boolean copyContents;
+/* the pool the copies are allocated from, created when first needed,
+   each taking the smallest power of two of at least MIN_CONTENTS_SIZE
+   bytes that holds it */
+static Arena_T contentsPool;
+static const size_t MIN_CONTENTS_SIZE = 16;
+/* the total size of the copies allocated from the pool */
+static size_t contentsBytes;
+/* the total length of the copies held by files, shared copies counted
+   once per file */
+static size_t contentsLength;
+/* the pool through which, initialized with FT_DEDUP_CONTENTS, files
+   share equal copies instead, otherwise NULL */
+static Blob_T blobs;
+
+/*--------------------------------------------------------------------*/
+
+/* Returns the hash of the child named by the first len characters of
+   name of directory p. */
+static unsigned int FT_hashChild(FT_node p, const char* name,
+                                 size_t len) {
+   assert(name != NULL);
+
+   return (unsigned int) Hash_continue(Hash_bytes(&p, sizeof(p)), name,
+                                       len);
+}
+
+/* Returns TRUE if the final component of node n's path is the first
+   len characters of name, and FALSE otherwise. */
+static boolean FT_hasName(FT_node n, const char* name, size_t len) {
+   const char* nName;
+
+   assert(n < nodesUsed);
+   assert(name != NULL);
+
+   nName = names + nameOffset[n];
+   return strncmp(nName, name, len) == 0 && nName[len] == '\0';
+}
+
+/* Returns the child of directory p named by the first len characters
+   of name, or NONE if there is none. */
+static FT_node FT_tableFind(FT_node p, const char* name, size_t len) {
+   unsigned int hash;
+   size_t mask;
+   size_t i;
+   FT_node n;
+
+   assert(name != NULL);
+
+   if(tableCapacity == 0)
+      return NONE;
+
+   hash = FT_hashChild(p, name, len);
+   mask = tableCapacity - 1;
+   for(i = hash & mask; table[i] != NONE; i = (i + 1) & mask) {
+      n = table[i];
+      if(hashes[n] == hash && parent[n] == p && FT_hasName(n, name, len))
+         return n;
+   }
+   return NONE;
+}
+
+/* Stores node n in the first free slot of its probe sequence in
+   slots, a table of capacity slots. */
+static void FT_tablePlace(FT_node* slots, size_t capacity, FT_node n) {
+   size_t mask = capacity - 1;
+   size_t i;
+
+   assert(slots != NULL);
+
+   for(i = hashes[n] & mask; slots[i] != NONE; i = (i + 1) & mask)
+      ;
+   slots[i] = n;
+}
+
+/* If the table slot at slot holds a node, stores its hash in *hash
+   and returns 1; otherwise returns 0. */
+static int FT_tableGetHash(const void* slot, size_t* hash) {
+   FT_node n = *(const FT_node*) slot;
+
+   assert(hash != NULL);
+
+   if(n == NONE)
+      return 0;
+   *hash = hashes[n];
+   return 1;
+}
+
+/* Removes node n from the table, shifting back the later nodes of its
+   probe sequence so that no tombstones are needed. */
+static void FT_tableRemove(FT_node n) {
+   FT_node empty = NONE;
+   size_t mask;
+   size_t i;
+
+   mask = tableCapacity - 1;
+   for(i = hashes[n] & mask; table[i] != n; i = (i + 1) & mask)
+      assert(table[i] != NONE);
+   Hash_remove(table, sizeof(FT_node), tableCapacity, i, &empty,
+               FT_tableGetHash);
+   tableSize--;
+}
+
+/* Makes room in the table for k more nodes, keeping it at most half
+   full. Returns SUCCESS, or MEMORY_ERROR if insufficient memory is
+   available. */
+static int FT_tableReserve(size_t k) {
+   FT_node* newTable;
+   size_t newCapacity;
+   size_t i;
+
+   if((tableSize + k) * 2 <= tableCapacity)
+      return SUCCESS;
+
+   newCapacity = (tableCapacity == 0) ? MIN_TABLE : tableCapacity;
+   while(newCapacity < (tableSize + k) * 2)
+      newCapacity *= 2;
+   newTable = malloc(newCapacity * sizeof(FT_node));
+   if(newTable == NULL)
+      return MEMORY_ERROR;
+   for(i = 0; i < newCapacity; i++)
+      newTable[i] = NONE;
+
+   for(i = 0; i < tableCapacity; i++) {
+      if(table[i] != NONE)
+         FT_tablePlace(newTable, newCapacity, table[i]);
+   }
+   free(table);
+   table = newTable;
+   tableCapacity = newCapacity;
+   return SUCCESS;
+}
+
+/* Makes room in the node arrays for k more nodes. Returns SUCCESS, or
+   MEMORY_ERROR if insufficient memory is available or there would be
+   too many nodes to index. An array already grown when another fails
+   to is simply larger than it needs to be. */
+static int FT_nodesReserve(size_t k) {
+   size_t newCapacity;
+   void* p;
+
+   if(k <= freeCount)
+      return SUCCESS;
+   k -= freeCount;
+   if(k >= (size_t) NONE - nodesUsed)
+      return MEMORY_ERROR;
+   if(nodesUsed + k <= nodeCapacity)
+      return SUCCESS;
+
+   newCapacity = (nodeCapacity < MIN_NODES) ? MIN_NODES : nodeCapacity;
+   while(newCapacity < nodesUsed + k)
+      newCapacity *= 2;
+   if(newCapacity >= (size_t) NONE)
+      newCapacity = (size_t) NONE - 1;
+
+   if((p = realloc(kind, newCapacity * sizeof(*kind))) == NULL)
+      return MEMORY_ERROR;
+   kind = p;
+   if((p = realloc(parent, newCapacity * sizeof(*parent))) == NULL)
+      return MEMORY_ERROR;
+   parent = p;
+   if((p = realloc(firstChild, newCapacity * sizeof(*firstChild))) == NULL)
+      return MEMORY_ERROR;
+   firstChild = p;
+   if((p = realloc(nextSibling, newCapacity * sizeof(*nextSibling))) == NULL)
+      return MEMORY_ERROR;
+   nextSibling = p;
+   if((p = realloc(prevSibling, newCapacity * sizeof(*prevSibling))) == NULL)
+      return MEMORY_ERROR;
+   prevSibling = p;
+   if((p = realloc(nameOffset, newCapacity * sizeof(*nameOffset))) == NULL)
+      return MEMORY_ERROR;
+   nameOffset = p;
+   if((p = realloc(pathLen, newCapacity * sizeof(*pathLen))) == NULL)
+      return MEMORY_ERROR;
+   pathLen = p;
+   if((p = realloc(hashes, newCapacity * sizeof(*hashes))) == NULL)
+      return MEMORY_ERROR;
+   hashes = p;
+   if((p = realloc(contents, newCapacity * sizeof(*contents))) == NULL)
+      return MEMORY_ERROR;
+   contents = p;
+   if((p = realloc(lengths, newCapacity * sizeof(*lengths))) == NULL)
+      return MEMORY_ERROR;
+   lengths = p;
+   if((p = realloc(owned, newCapacity * sizeof(*owned))) == NULL)
+      return MEMORY_ERROR;
+   owned = p;
+
+   nodeCapacity = (FT_node) newCapacity;
+   return SUCCESS;
+}
+
+/* Makes room in names for size more characters. If the buffer is
+   full, the names of the nodes in use are copied to a new one, which
+   both grows the buffer and drops the names of freed nodes. Returns
+   SUCCESS, or MEMORY_ERROR if insufficient memory is available or the
+   names would be too long to index. */
+static int FT_namesReserve(size_t size) {
+   char* newNames;
+   size_t newCapacity;
+   size_t used = 0;
+   size_t len;
+   FT_node n;
+
+   if(namesUsed + size <= namesCapacity)
+      return SUCCESS;
+
+   newCapacity = 2 * (namesUsed - namesFreed + size);
+   if(newCapacity < MIN_NAMES)
+      newCapacity = MIN_NAMES;
+   if(newCapacity > UINT_MAX) {
+      newCapacity = UINT_MAX;
+      if(namesUsed - namesFreed + size > newCapacity)
+         return MEMORY_ERROR;
+   }
+   newNames = malloc(newCapacity);
+   if(newNames == NULL)
+      return MEMORY_ERROR;
+
+   for(n = 0; n < nodesUsed; n++) {
+      if(kind[n] == FT_FREE)
+         continue;
+      len = strlen(names + nameOffset[n]) + 1;
+      memcpy(newNames + used, names + nameOffset[n], len);
+      nameOffset[n] = (unsigned int) used;
+      used += len;
+   }
+   free(names);
+   names = newNames;
+   namesCapacity = newCapacity;
+   namesUsed = used;
+   namesFreed = 0;
+   return SUCCESS;
+}
+
+/* Makes room for k new nodes below p, or for the root if p is NONE,
+   whose names total size characters with their nuls, so that
+   creating them cannot fail. Returns SUCCESS, or MEMORY_ERROR if
+   insufficient memory is available or the new paths would be too long
+   to record. */
+static int FT_reserve(FT_node p, size_t k, size_t size) {
+   if(size > UINT_MAX - (p == NONE ? 0 : pathLen[p]))
+      return MEMORY_ERROR;
+   if(FT_nodesReserve(k) != SUCCESS)
+      return MEMORY_ERROR;
+   if(FT_namesReserve(size) != SUCCESS)
+      return MEMORY_ERROR;
+   return FT_tableReserve(k);
+}
+
+/* Returns a new node of kind k, with the given contents and length,
+   named by the first len characters of name, as a child of directory
+   p, or as the root if p is NONE. Room must have been reserved. */
+static FT_node FT_newNode(FT_node p, unsigned char k, const char* name,
+                          size_t len, void* nodeContents,
+                          size_t nodeLength) {
+   FT_node n;
+
+   assert(name != NULL);
+
+   if(freeNodes != NONE) {
+      n = freeNodes;
+      freeNodes = nextSibling[n];
+      freeCount--;
+   }
+   else {
+      assert(nodesUsed < nodeCapacity);
+      n = nodesUsed++;
+   }
+
+   assert(namesUsed + len + 1 <= namesCapacity);
+   nameOffset[n] = (unsigned int) namesUsed;
+   memcpy(names + namesUsed, name, len);
+   names[namesUsed + len] = '\0';
+   namesUsed += len + 1;
+
+   kind[n] = k;
+   parent[n] = p;
+   firstChild[n] = NONE;
+   contents[n] = nodeContents;
+   lengths[n] = nodeLength;
+   owned[n] = FALSE;
+   hashes[n] = FT_hashChild(p, name, len);
+
+   if(p == NONE) {
+      root = n;
+      pathLen[n] = (unsigned int) len;
+      nextSibling[n] = NONE;
+      prevSibling[n] = NONE;
+   }
+   else {
+      pathLen[n] = pathLen[p] + 1 + (unsigned int) len;
+      nextSibling[n] = firstChild[p];
+      prevSibling[n] = NONE;
+      if(firstChild[p] != NONE)
+         prevSibling[firstChild[p]] = n;
+      firstChild[p] = n;
+
+      assert((tableSize + 1) * 2 <= tableCapacity);
+      FT_tablePlace(table, tableCapacity, n);
+      tableSize++;
+   }
+
+   count++;
+   return n;
+}
+
+/* Unlinks node n from its parent's children, or from the root. */
+static void FT_unlink(FT_node n) {
+   if(parent[n] == NONE) {
+      root = NONE;
+      return;
+   }
+   if(prevSibling[n] == NONE)
+      firstChild[parent[n]] = nextSibling[n];
+   else
+      nextSibling[prevSibling[n]] = nextSibling[n];
+   if(nextSibling[n] != NONE)
+      prevSibling[nextSibling[n]] = prevSibling[n];
+}
+
+/* Returns the number of bytes allocated for a copy of contents of
+   length bytes. */
+static size_t FT_contentsSize(size_t length) {
+   size_t size = MIN_CONTENTS_SIZE;
+
+   while(size < length)
+      size *= 2;
+   return size;
+}
+
+/* Returns a new copy of the length bytes at c, allocated from the
+   pool, or shared through the pool of shared copies if there is one,
+   or NULL if insufficient memory is available. */
+static void* FT_copyContents(const void* c, size_t length) {
+   void* copy;
+
+   assert(c != NULL || length == 0);
+
+   if(blobs != NULL)
+      return (void*)Blob_add(blobs, c, length);
+   if(contentsPool == NULL && (contentsPool = Arena_new()) == NULL)
+      return NULL;
+   copy = Arena_alloc(contentsPool, FT_contentsSize(length));
+   if(copy == NULL)
+      return NULL;
+   contentsBytes += FT_contentsSize(length);
+   if(length != 0)
+      memcpy(copy, c, length);
+   return copy;
+}
+
+/* Frees file n's own copy of its contents, if it has one. */
+static void FT_releaseContents(FT_node n) {
+   if(!owned[n])
+      return;
+   contentsLength -= lengths[n];
+   if(blobs != NULL) {
+      Blob_release(blobs, contents[n]);
+   }
+   else {
+      contentsBytes -= FT_contentsSize(lengths[n]);
+      Arena_release(contentsPool, contents[n],
+                    FT_contentsSize(lengths[n]));
+   }
+   owned[n] = FALSE;
+}
+
+/* Replaces the contents of file n with the tree's own copy of the
+   length bytes at c, reusing n's current copy if it is of the same
+   size class and not shared. Returns SUCCESS, or MEMORY_ERROR, leaving
+   n unchanged, if insufficient memory is available. */
+static int FT_setCopy(FT_node n, const void* c, size_t length) {
+   void* copy;
+
+   assert(kind[n] == FT_FILE);
+
+   if(owned[n] && blobs == NULL &&
+      FT_contentsSize(lengths[n]) == FT_contentsSize(length)) {
+      if(length != 0)
+         memcpy(contents[n], c, length);
+      contentsLength -= lengths[n];
+   }
+   else {
+      copy = FT_copyContents(c, length);
+      if(copy == NULL)
+         return MEMORY_ERROR;
+      FT_releaseContents(n);
+      contents[n] = copy;
+      owned[n] = TRUE;
+   }
+   lengths[n] = length;
+   contentsLength += length;
+   return SUCCESS;
+}
+
+/* Frees node n, which must have no children, for reuse. */
+static void FT_freeNode(FT_node n) {
+   assert(kind[n] != FT_FREE);
+   assert(firstChild[n] == NONE);
+
+   FT_releaseContents(n);
+
+   if(parent[n] != NONE)
+      FT_tableRemove(n);
+   namesFreed += strlen(names + nameOffset[n]) + 1;
+
+   kind[n] = FT_FREE;
+   nextSibling[n] = freeNodes;
+   freeNodes = n;
+   freeCount++;
+   count--;
+}
+
+/* Frees node n, which must already be unlinked, and all of its
+   descendants, leaf by leaf and without recursion. */
+static void FT_freeTree(FT_node n) {
+   FT_node curr = n;
+   FT_node p;
+
+   for(;;) {
+      while(firstChild[curr] != NONE)
+         curr = firstChild[curr];
+      if(curr == n)
+         break;
+
+      p = parent[curr];
+      firstChild[p] = nextSibling[curr];
+      FT_freeNode(curr);
+      curr = (firstChild[p] != NONE) ? firstChild[p] : p;
+   }
+   FT_freeNode(n);
+}
+
+/* Returns the node farthest down the hierarchy whose path is a prefix
+   of path ending at a component boundary, or NONE if there is none.
+   Stores in *pRest the part of path after that node's path, which is
+   empty if the node is at path, and sets *piResult to
+   PARENT_CHILD_ERROR if the node is a file, as the traversals in ft.c
+   do. */
+static FT_node FT_walk(const char* path, const char** pRest,
+                       int* piResult) {
+   const char* rest;
+   FT_node curr;
+   FT_node child;
+   size_t len;
+
+   assert(path != NULL);
+   assert(pRest != NULL);
+   assert(piResult != NULL);
+
+   len = strcspn(path, "/");
+   if(root == NONE || !FT_hasName(root, path, len))
+      return NONE;
+
+   curr = root;
+   rest = path + len;
+   while(*rest == '/' && kind[curr] == FT_DIR) {
+      len = strcspn(rest + 1, "/");
+      child = FT_tableFind(curr, rest + 1, len);
+      if(child == NONE)
+         break;
+      curr = child;
+      rest += 1 + len;
+   }
+
+   if(kind[curr] == FT_FILE)
+      *piResult = PARENT_CHILD_ERROR;
+   *pRest = rest;
+   return curr;
+}
+
+/* Returns the node at path, or NONE if there is none. */
+static FT_node FT_find(const char* path) {
+   const char* rest;
+   int result = SUCCESS;
+   FT_node n;
+
+   assert(path != NULL);
+
+   n = FT_walk(path, &rest, &result);
+   if(n == NONE || *rest != '\0')
+      return NONE;
+   return n;
+}
+
+/* Advances *pComponent past any slashes and returns the length of the
+   path component that starts there, which is 0 if no components
+   remain. */
+static size_t FT_nextComponent(const char** pComponent) {
+   const char* component;
+
+   assert(pComponent != NULL);
+   assert(*pComponent != NULL);
+
+   component = *pComponent;
+   while(*component == '/')
+      component++;
+   *pComponent = component;
+
+   return strcspn(component, "/");
+}
+
+/* Inserts the nodes for the components of rest as a chain below
+   directory p, or as the root if p is NONE: all directories, except
+   that the last is a file with the given contents and length if type
+   is TRUE, holding its own copy of them if copy is TRUE.
+
+   Returns SUCCESS, ALREADY_IN_TREE or CONFLICTING_PATH if rest has no
+   components, depending on whether p is a node, or MEMORY_ERROR if
+   insufficient memory is available, in which case nothing is
+   inserted. */
+static int FT_insertChain(FT_node p, const char* rest, boolean type,
+                          void* fileContents, size_t fileLength,
+                          boolean copy) {
+   const char* component;
+   const char* next;
+   size_t len;
+   size_t nextLen;
+   size_t k = 0;
+   size_t size = 0;
+   boolean isFile;
+
+   assert(rest != NULL);
+
+   /* Reserving room for every new node up front, so that the tree is
+      changed only once nothing can fail. */
+   component = rest;
+   for(len = FT_nextComponent(&component); len != 0;
+       len = FT_nextComponent(&component)) {
+      k++;
+      size += len + 1;
+      component += len;
+   }
+   if(k == 0)
+      return (p == NONE) ? CONFLICTING_PATH : ALREADY_IN_TREE;
+   if(FT_reserve(p, k, size) != SUCCESS)
+      return MEMORY_ERROR;
+   if(type && copy) {
+      fileContents = FT_copyContents(fileContents, fileLength);
+      if(fileContents == NULL)
+         return MEMORY_ERROR;
+   }
+
+   component = rest;
+   len = FT_nextComponent(&component);
+   while(len != 0) {
+      next = component + len;
+      nextLen = FT_nextComponent(&next);
+
+      isFile = (type && nextLen == 0) ? TRUE : FALSE;
+      p = FT_newNode(p, isFile ? FT_FILE : FT_DIR, component, len,
+                     isFile ? fileContents : NULL,
+                     isFile ? fileLength : 0);
+
+      component = next;
+      len = nextLen;
+   }
+   if(type && copy) {
+      owned[p] = TRUE;
+      contentsLength += fileLength;
+   }
+   return SUCCESS;
+}
+
+/* Inserts a new directory, if type is FALSE, or a new file with the
+   given contents and length, if type is TRUE, at path, holding its own
+   copy of them if copy is TRUE, returning the results specified for
+   FT_insertDir and FT_insertFile. */
+static int FT_insertPath(const char* path, boolean type,
+                         void* fileContents, size_t fileLength,
+                         boolean copy) {
+   const char* rest;
+   FT_node curr;
+   int result = SUCCESS;
+
+   assert(path != NULL);
+
+   if(!isInitialized) {
+      return INITIALIZATION_ERROR;
+   }
+
+   /* If root is a file, only that file is in the tree. */
+   if(root != NONE && kind[root] == FT_FILE) {
+      if(type && FT_find(path) == root) {
+         return ALREADY_IN_TREE;
+      }
+      return CONFLICTING_PATH;
+   }
+
+   if(root == NONE) {
+      return FT_insertChain(NONE, path, type, fileContents, fileLength,
+                            copy);
+   }
+
+   curr = FT_walk(path, &rest, &result);
+   if(curr == NONE) {
+      return CONFLICTING_PATH;
+   }
+   /* If a file is found on the path, or at it. */
+   if(result == PARENT_CHILD_ERROR) {
+      if(*rest == '\0') {
+         return ALREADY_IN_TREE;
+      }
+      return type ? NOT_A_DIRECTORY : PARENT_CHILD_ERROR;
+   }
+   if(*rest == '\0') {
+      return ALREADY_IN_TREE;
+   }
+   return FT_insertChain(curr, rest, type, fileContents, fileLength,
+                         copy);
+}
+
+/* Writes node n's path, with its terminating '\0', into buf, which
+   must hold at least pathLen[n] + 1 characters. Returns buf. */
+static char* FT_writePath(FT_node n, char* buf) {
+   size_t end;
+   size_t len;
+
+   assert(buf != NULL);
+
+   /* Filling buf from the end, one ancestor's name at a time. */
+   end = pathLen[n];
+   buf[end] = '\0';
+   while(n != NONE) {
+      len = strlen(names + nameOffset[n]);
+      end -= len;
+      memcpy(buf + end, names + nameOffset[n], len);
+      if(parent[n] != NONE)
+         buf[--end] = '/';
+      n = parent[n];
+   }
+   return buf;
+}
+
+/* Returns the directory that handle refers to, or NONE if handle was
+   never opened, has been closed, or its directory has been removed. */
+static FT_node FT_handleDir(FT_DirHandle handle) {
+   if(handle.slot >= handleCapacity ||
+      handles[handle.slot].dir == NONE ||
+      handles[handle.slot].generation != handle.generation) {
+      return NONE;
+   }
+   return handles[handle.slot].dir;
+}
+
+/* Frees the handle slot at index slot. */
+static void FT_handleFree(size_t slot) {
+   assert(slot < handleCapacity);
+
+   handles[slot].dir = NONE;
+   if(slot < handleFirstFree) {
+      handleFirstFree = slot;
+   }
+}
+
+/* Closes every handle to dir or to a directory beneath it, as must be
+   done before the hierarchy rooted at dir is freed. */
+static void FT_handleCloseUnder(FT_node dir) {
+   FT_node curr;
+   size_t i;
+
+   for(i = 0; i < handleCapacity; i++) {
+      for(curr = handles[i].dir; curr != NONE; curr = parent[curr]) {
+         if(curr == dir) {
+            FT_handleFree(i);
+            break;
+         }
+      }
+   }
+}
+
+/* Returns the child of the directory open as handle named name, or
+   NONE if there is none or handle is not valid. */
+static FT_node FT_handleChild(FT_DirHandle handle, const char* name) {
+   FT_node dir;
+
+   assert(name != NULL);
+
+   dir = FT_handleDir(handle);
+   if(dir == NONE) {
+      return NONE;
+   }
+   return FT_tableFind(dir, name, strlen(name));
+}
+
+/*--------------------------------------------------------------------*/
+
+/* ft.h contains specification. */
+int FT_insertDir(char* path) {
+   return FT_insertPath(path, FALSE, NULL, 0, FALSE);
+}
+
+/* ft.h contains specification. The nodes of a subtree are already
+   slots of the shared arrays, freed without any call to free, so an
+   arena directory is an ordinary one. */
+int FT_insertArenaDir(char* path) {
+   return FT_insertPath(path, FALSE, NULL, 0, FALSE);
+}
+
+/* ft.h contains specification. */
+boolean FT_containsDir(char* path) {
+   FT_node n;
+
+   assert(path != NULL);
+
+   if(!isInitialized) {
+      return FALSE;
+   }
+   n = FT_find(path);
+   return n != NONE && kind[n] == FT_DIR;
+}
+
+/* ft.h contains specification. */
+int FT_rmDir(char* path) {
+   FT_node n;
+
+   assert(path != NULL);
+
+   if(!isInitialized) {
+      return INITIALIZATION_ERROR;
+   }
+
+   /* If root is a file, there are no directories to remove. */
+   if(root != NONE && kind[root] == FT_FILE) {
+      return NO_SUCH_PATH;
+   }
+
+   n = FT_find(path);
+   if(n == NONE) {
+      return NO_SUCH_PATH;
+   }
+   if(kind[n] == FT_FILE) {
+      return NOT_A_DIRECTORY;
+   }
+
+   FT_handleCloseUnder(n);
+   FT_unlink(n);
+   FT_freeTree(n);
+   return SUCCESS;
+}
+
+/* ft.h contains specification. */
+int FT_insertFile(char* path, void *contents, size_t length) {
+   return FT_insertPath(path, TRUE, contents, length, copyContents);
+}
+
+/* ft.h contains specification. */
+int FT_insertFileCopy(char* path, const void *contents, size_t length) {
+   /* The contents are copied, never stored. */
+   return FT_insertPath(path, TRUE, (void*) contents, length, TRUE);
+}
+
+/* ft.h contains specification. */
+boolean FT_containsFile(char* path) {
+   FT_node n;
+
+   assert(path != NULL);
+
+   if(!isInitialized) {
+      return FALSE;
+   }
+   n = FT_find(path);
+   return n != NONE && kind[n] == FT_FILE;
+}
+
+/* ft.h contains specification. */
+int FT_rmFile(char* path) {
+   FT_node n;
+
+   assert(path != NULL);
+
+   if(!isInitialized) {
+      return INITIALIZATION_ERROR;
+   }
+
+   n = FT_find(path);
+   if(n == NONE) {
+      return NO_SUCH_PATH;
+   }
+   if(kind[n] == FT_DIR) {
+      return NOT_A_FILE;
+   }
+
+   FT_unlink(n);
+   FT_freeNode(n);
+   return SUCCESS;
+}
+
+/* ft.h contains specification. */
+void *FT_getFileContents(char *path) {
+   FT_node n;
+
+   assert(path != NULL);
+
+   if(!isInitialized) {
+      return NULL;
+   }
+   n = FT_find(path);
+   if(n == NONE || kind[n] != FT_FILE) {
+      return NULL;
+   }
+   return contents[n];
+}
+
+/* ft.h contains specification. */
+void *FT_replaceFileContents(char *path, void *newContents,
+                             size_t newLength) {
+   void* oldContents;
+   FT_node n;
+
+   assert(path != NULL);
+
+   if(!isInitialized) {
+      return NULL;
+   }
+   n = FT_find(path);
+   if(n == NONE || kind[n] != FT_FILE) {
+      return NULL;
+   }
+   if(copyContents || owned[n]) {
+      /* The old copy is reused or freed, and the new one is never
+         handed to the client, who may free what is returned. */
+      if(FT_setCopy(n, newContents, newLength) != SUCCESS) {
+         return NULL;
+      }
+      return newContents;
+   }
+   oldContents = contents[n];
+   contents[n] = newContents;
+   lengths[n] = newLength;
+   return oldContents;
+}
+
+/* ft.h contains specification. */
+int FT_replaceFileContentsCopy(char *path, const void *newContents,
+                               size_t newLength) {
+   FT_node n;
+
+   assert(path != NULL);
+
+   if(!isInitialized) {
+      return INITIALIZATION_ERROR;
+   }
+   n = FT_find(path);
+   if(n == NONE) {
+      return NO_SUCH_PATH;
+   }
+   if(kind[n] != FT_FILE) {
+      return NOT_A_FILE;
+   }
+   return FT_setCopy(n, newContents, newLength);
+}
+
+/* ft.h contains specification. */
+int FT_stat(char *path, boolean* type, size_t* length) {
+   FT_node n;
+
+   assert(path != NULL);
+
+   if(!isInitialized) {
+      return INITIALIZATION_ERROR;
+   }
+   n = FT_find(path);
+   if(n == NONE) {
+      return NO_SUCH_PATH;
+   }
+   if(kind[n] == FT_FILE) {
+      *type = TRUE;
+      *length = lengths[n];
+   }
+   else {
+      *type = FALSE;
+   }
+   return SUCCESS;
+}
+
+/* ft.h contains specification. */
+int FT_openDir(char* path, FT_DirHandle* pHandle) {
+   struct FT_handleSlot* newHandles;
+   size_t newCapacity;
+   size_t slot;
+   FT_node n;
+
+   assert(path != NULL);
+   assert(pHandle != NULL);
+
+   if(!isInitialized) {
+      return INITIALIZATION_ERROR;
+   }
+   n = FT_find(path);
+   if(n == NONE) {
+      return NO_SUCH_PATH;
+   }
+   if(kind[n] == FT_FILE) {
+      return NOT_A_DIRECTORY;
+   }
+
+   /* Finding a free slot, doubling the table if there is none. */
+   for(slot = handleFirstFree; slot < handleCapacity; slot++) {
+      if(handles[slot].dir == NONE)
+         break;
+   }
+   if(slot == handleCapacity) {
+      newCapacity = (handleCapacity == 0) ? 8 : 2 * handleCapacity;
+      newHandles = realloc(handles,
+                           newCapacity * sizeof(struct FT_handleSlot));
+      if(newHandles == NULL) {
+         return MEMORY_ERROR;
+      }
+      handles = newHandles;
+      for(; handleCapacity < newCapacity; handleCapacity++) {
+         handles[handleCapacity].dir = NONE;
+      }
+   }
+
+   handles[slot].dir = n;
+   handles[slot].generation = ++handleGeneration;
+   handleFirstFree = slot + 1;
+
+   pHandle->slot = slot;
+   pHandle->generation = handleGeneration;
+   return SUCCESS;
+}
+
+/* ft.h contains specification. */
+int FT_closeDir(FT_DirHandle handle) {
+   if(!isInitialized) {
+      return INITIALIZATION_ERROR;
+   }
+   if(FT_handleDir(handle) == NONE) {
+      return NO_SUCH_PATH;
+   }
+   FT_handleFree(handle.slot);
+   return SUCCESS;
+}
+
+/* ft.h contains specification. */
+int FT_insertFileAt(FT_DirHandle handle, char* name, void *contents,
+                    size_t length) {
+   FT_node dir;
+   size_t len;
+
+   assert(name != NULL);
+
+   if(!isInitialized) {
+      return INITIALIZATION_ERROR;
+   }
+   dir = FT_handleDir(handle);
+   if(dir == NONE) {
+      return NO_SUCH_PATH;
+   }
+
+   /* The name must be a single path component. */
+   len = strlen(name);
+   if(len == 0 || strchr(name, '/') != NULL) {
+      return PARENT_CHILD_ERROR;
+   }
+   if(FT_tableFind(dir, name, len) != NONE) {
+      return ALREADY_IN_TREE;
+   }
+   return FT_insertChain(dir, name, TRUE, contents, length,
+                         copyContents);
+}
+
+/* Compares the strings to which the pointers at ps1 and ps2 point,
+   for qsort. */
+static int FT_compareStrings(const void* ps1, const void* ps2) {
+   return strcmp(*(char* const*) ps1, *(char* const*) ps2);
+}
+
+/* ft.h contains specification. */
+int FT_insertManyAt(FT_DirHandle handle, char** childNames,
+                    boolean* childTypes, void** childContents,
+                    size_t* childLengths, size_t n) {
+   FT_node dir;
+   FT_node first;
+   char** sorted;
+   size_t size = 0;
+   size_t len;
+   size_t i;
+   int result;
+
+   assert(childNames != NULL || n == 0);
+   assert(childTypes != NULL || n == 0);
+   assert(childContents != NULL || n == 0);
+   assert(childLengths != NULL || n == 0);
+
+   if(!isInitialized) {
+      return INITIALIZATION_ERROR;
+   }
+   dir = FT_handleDir(handle);
+   if(dir == NONE) {
+      return NO_SUCH_PATH;
+   }
+
+   /* Each name must be a single path component. */
+   for(i = 0; i < n; i++) {
+      assert(childNames[i] != NULL);
+      len = strlen(childNames[i]);
+      if(len == 0 || strchr(childNames[i], '/') != NULL) {
+         return PARENT_CHILD_ERROR;
+      }
+      size += len + 1;
+   }
+   if(n == 0) {
+      return SUCCESS;
+   }
+
+   /* No name may be in the directory already, or given twice. */
+   sorted = malloc(n * sizeof(char*));
+   if(sorted == NULL) {
+      return MEMORY_ERROR;
+   }
+   memcpy(sorted, childNames, n * sizeof(char*));
+   qsort(sorted, n, sizeof(char*), FT_compareStrings);
+   result = SUCCESS;
+   for(i = 0; i < n && result == SUCCESS; i++) {
+      if((i > 0 && strcmp(sorted[i - 1], sorted[i]) == 0) ||
+         FT_tableFind(dir, sorted[i], strlen(sorted[i])) != NONE) {
+         result = ALREADY_IN_TREE;
+      }
+   }
+   free(sorted);
+   if(result != SUCCESS) {
+      return result;
+   }
+
+   /* With room reserved for all of them, only copying contents can
+      fail, after which the entries already inserted, each the first
+      child of dir in turn, are removed again. */
+   if(FT_reserve(dir, n, size) != SUCCESS) {
+      return MEMORY_ERROR;
+   }
+   for(i = 0; i < n; i++) {
+      result = FT_insertChain(dir, childNames[i], childTypes[i],
+                              childContents[i], childLengths[i],
+                              copyContents);
+      if(result != SUCCESS) {
+         while(i-- > 0) {
+            first = firstChild[dir];
+            FT_unlink(first);
+            FT_freeNode(first);
+         }
+         return result;
+      }
+   }
+   return SUCCESS;
+}
+
+/* ft.h contains specification. */
+boolean FT_containsFileAt(FT_DirHandle handle, char* name) {
+   FT_node n;
+
+   assert(name != NULL);
+
+   if(!isInitialized) {
+      return FALSE;
+   }
+   n = FT_handleChild(handle, name);
+   return n != NONE && kind[n] == FT_FILE;
+}
+
+/* ft.h contains specification. */
+void *FT_getFileContentsAt(FT_DirHandle handle, char* name) {
+   FT_node n;
+
+   assert(name != NULL);
+
+   if(!isInitialized) {
+      return NULL;
+   }
+   n = FT_handleChild(handle, name);
+   if(n == NONE || kind[n] != FT_FILE) {
+      return NULL;
+   }
+   return contents[n];
+}
+
+/* ft.h contains specification. */
+int FT_rmFileAt(FT_DirHandle handle, char* name) {
+   FT_node n;
+
+   assert(name != NULL);
+
+   if(!isInitialized) {
+      return INITIALIZATION_ERROR;
+   }
+   n = FT_handleChild(handle, name);
+   if(n == NONE) {
+      return NO_SUCH_PATH;
+   }
+   if(kind[n] != FT_FILE) {
+      return NOT_A_FILE;
+   }
+
+   FT_unlink(n);
+   FT_freeNode(n);
+   return SUCCESS;
+}
+
+/* ft.h contains specification. */
+int FT_containsMany(char** paths, size_t n, boolean type,
+                    boolean* results) {
+   size_t i;
+
+   assert(paths != NULL || n == 0);
+   assert(results != NULL || n == 0);
+
+   if(!isInitialized) {
+      return INITIALIZATION_ERROR;
+   }
+
+   /* Every lookup is a probe of the child table per component, so
+      there is no traversal to share between neighboring paths. */
+   for(i = 0; i < n; i++) {
+      results[i] = type ? FT_containsFile(paths[i])
+                        : FT_containsDir(paths[i]);
+   }
+   return SUCCESS;
+}
+
+/* ft.h contains specification. */
+int FT_statMany(char** paths, size_t n, int* statuses,
+                boolean* types, size_t* lengths) {
+   size_t i;
+
+   assert(paths != NULL || n == 0);
+   assert(statuses != NULL || n == 0);
+   assert(types != NULL || n == 0);
+   assert(lengths != NULL || n == 0);
+
+   if(!isInitialized) {
+      return INITIALIZATION_ERROR;
+   }
+
+   for(i = 0; i < n; i++) {
+      statuses[i] = FT_stat(paths[i], &types[i], &lengths[i]);
+   }
+   return SUCCESS;
+}
+
+/* ft.h contains specification. */
+int FT_init(void) {
+   return FT_initWithOptions(0);
+}
+
+/* ft.h contains specification. */
+int FT_initWithOptions(unsigned int options) {
+   if(isInitialized) {
+      return INITIALIZATION_ERROR;
+   }
+   isInitialized = 1;
+   /* The other options tune the pointer-linked representation only. */
+   copyContents = (options & (FT_COPY_CONTENTS | FT_DEDUP_CONTENTS)) ?
+                  TRUE : FALSE;
+   /* Without a pool, copies are simply not shared. */
+   blobs = (options & FT_DEDUP_CONTENTS) ? Blob_new() : NULL;
+   root = NONE;
+   count = 0;
+   nodeCapacity = 0;
+   nodesUsed = 0;
+   freeNodes = NONE;
+   freeCount = 0;
+   namesCapacity = 0;
+   namesUsed = 0;
+   namesFreed = 0;
+   tableCapacity = 0;
+   tableSize = 0;
+   handleCapacity = 0;
+   handleFirstFree = 0;
+   return SUCCESS;
+}
+
+/* ft.h contains specification. */
+int FT_getCacheStats(size_t* pHits, size_t* pMisses) {
+   assert(pHits != NULL);
+   assert(pMisses != NULL);
+
+   if(!isInitialized) {
+      return INITIALIZATION_ERROR;
+   }
+   *pHits = 0;
+   *pMisses = 0;
+   return SUCCESS;
+}
+
+/* ft.h contains specification. */
+int FT_getFilterStats(size_t* pProbes, size_t* pRejects,
+                      size_t* pFalsePositives) {
+   assert(pProbes != NULL);
+   assert(pRejects != NULL);
+   assert(pFalsePositives != NULL);
+
+   if(!isInitialized) {
+      return INITIALIZATION_ERROR;
+   }
+   *pProbes = 0;
+   *pRejects = 0;
+   *pFalsePositives = 0;
+   return SUCCESS;
+}
+
+/* ft.h contains specification. */
+int FT_getContentsStats(size_t* pLogical, size_t* pPhysical) {
+   assert(pLogical != NULL);
+   assert(pPhysical != NULL);
+
+   if(!isInitialized) {
+      return INITIALIZATION_ERROR;
+   }
+   *pLogical = contentsLength;
+   *pPhysical = (blobs != NULL) ? Blob_getBytes(blobs) : contentsLength;
+   return SUCCESS;
+}
+
+/* ft.h contains specification. Every node's fields and name are held
+   in arrays grown by doubling, so the room reserved in them for more
+   nodes is counted in nodeBytes and nameBytes, and there are no
+   arrays of children. */
+int FT_getMemoryStats(struct FT_memoryStats* pStats) {
+   assert(pStats != NULL);
+
+   if(!isInitialized) {
+      return INITIALIZATION_ERROR;
+   }
+   pStats->nodeBytes = nodeCapacity *
+      (sizeof(*kind) + sizeof(*parent) + sizeof(*firstChild) +
+       sizeof(*nextSibling) + sizeof(*prevSibling) +
+       sizeof(*nameOffset) + sizeof(*pathLen) + sizeof(*hashes) +
+       sizeof(*contents) + sizeof(*lengths) + sizeof(*owned));
+   pStats->nameBytes = namesCapacity;
+   pStats->arrayCapacityBytes = 0;
+   pStats->arrayLengthBytes = 0;
+   pStats->lookupBytes = tableCapacity * sizeof(*table);
+   pStats->contentsBytes = contentsBytes;
+   if(blobs != NULL)
+      pStats->contentsBytes += Blob_getBytes(blobs);
+   return SUCCESS;
+}
+
+/* ft.h contains specification. */
+int FT_destroy(void) {
+   if(!isInitialized) {
+      return INITIALIZATION_ERROR;
+   }
+
+   /* All the nodes go with their arrays. */
+   free(kind);
+   free(parent);
+   free(firstChild);
+   free(nextSibling);
+   free(prevSibling);
+   free(nameOffset);
+   free(pathLen);
+   free(hashes);
+   free(contents);
+   free(lengths);
+   free(owned);
+   free(names);
+   free(table);
+   free(handles);
+
+   kind = NULL;
+   parent = NULL;
+   firstChild = NULL;
+   nextSibling = NULL;
+   prevSibling = NULL;
+   nameOffset = NULL;
+   pathLen = NULL;
+   hashes = NULL;
+   contents = NULL;
+   lengths = NULL;
+   owned = NULL;
+   names = NULL;
+   table = NULL;
+   handles = NULL;
+
+   /* The copies of contents go with their pool. */
+   if(contentsPool != NULL) {
+      Arena_free(contentsPool);
+      contentsPool = NULL;
+   }
+   contentsBytes = 0;
+   contentsLength = 0;
+   if(blobs != NULL) {
+      Blob_free(blobs);
+      blobs = NULL;
+   }
+   copyContents = FALSE;
+
+   isInitialized = 0;
+   root = NONE;
+   count = 0;
+   nodeCapacity = 0;
+   nodesUsed = 0;
+   namesCapacity = 0;
+   tableCapacity = 0;
+   handleCapacity = 0;
+   return SUCCESS;
+}
+
+/* Compares the nodes at pn1 and pn2, children of one directory, by
+   name, for qsort. */
+static int FT_compareNames(const void* pn1, const void* pn2) {
+   assert(pn1 != NULL);
+   assert(pn2 != NULL);
+
+   return strcmp(names + nameOffset[*(const FT_node*) pn1],
+                 names + nameOffset[*(const FT_node*) pn2]);
+}
+
+/*
+  Performs a pre-order traversal of the tree rooted at directory n,
+  writing each node's path followed by a newline into acc, files
+  before directories and each in sorted order, as ft.c does. The
+  children of each directory are gathered and sorted in scratch, whose
+  room must be enough for every descendant of n.
+  Returns the position in acc after the last newline written.
+*/
+static char* FT_preOrderTraversal(FT_node n, char* acc,
+                                  FT_node* scratch) {
+   FT_node child;
+   size_t numChildren = 0;
+   size_t c;
+
+   assert(acc != NULL);
+   assert(scratch != NULL);
+
+   (void) FT_writePath(n, acc);
+   acc += pathLen[n];
+   *acc++ = '\n';
+
+   for(child = firstChild[n]; child != NONE; child = nextSibling[child])
+      scratch[numChildren++] = child;
+   qsort(scratch, numChildren, sizeof(FT_node), FT_compareNames);
+
+   for(c = 0; c < numChildren; c++) {
+      if(kind[scratch[c]] == FT_FILE) {
+         (void) FT_writePath(scratch[c], acc);
+         acc += pathLen[scratch[c]];
+         *acc++ = '\n';
+      }
+   }
+   for(c = 0; c < numChildren; c++) {
+      if(kind[scratch[c]] == FT_DIR)
+         acc = FT_preOrderTraversal(scratch[c], acc,
+                                    scratch + numChildren);
+   }
+   return acc;
+}
+
+/* ft.h contains specification. */
+char *FT_toString() {
+   size_t totalStrlen = 1;
+   FT_node* scratch;
+   char* result;
+   char* end;
+   FT_node n;
+
+   if(!isInitialized) {
+      return NULL;
+   }
+
+   /* If root is file, returning a copy of its path alone. */
+   if(root != NONE && kind[root] == FT_FILE) {
+      result = malloc(pathLen[root] + 1);
+      if(result == NULL) {
+         return NULL;
+      }
+      return FT_writePath(root, result);
+   }
+
+   /* Measuring the result in one pass over the arrays, in order. */
+   for(n = 0; n < nodesUsed; n++) {
+      if(kind[n] != FT_FREE)
+         totalStrlen += pathLen[n] + 1;
+   }
+
+   result = malloc(totalStrlen);
+   if(result == NULL) {
+      return NULL;
+   }
+   end = result;
+   if(root != NONE) {
+      scratch = malloc(count * sizeof(FT_node));
+      if(scratch == NULL) {
+         free(result);
+         return NULL;
+      }
+      end = FT_preOrderTraversal(root, end, scratch);
+      free(scratch);
+   }
+   *end = '\0';
+
+   return result;
+}
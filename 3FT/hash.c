@@ -0,0 +1,81 @@
+/*--------------------------------------------------------------------*/
+/* hash.c                                                             */
+/*--------------------------------------------------------------------*/
+
+#include "hash.h"
+#include <assert.h>
+#include <string.h>
+
+/*--------------------------------------------------------------------*/
+
+/* The FNV-1a offset basis and prime. */
+
+static const size_t FNV_BASIS = (size_t)2166136261U;
+static const size_t FNV_PRIME = (size_t)16777619U;
+
+/*--------------------------------------------------------------------*/
+
+size_t Hash_bytes(const void *pvData, size_t uLength)
+{
+   assert(pvData != NULL);
+
+   return Hash_continue(FNV_BASIS, pvData, uLength);
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t Hash_continue(size_t uHash, const void *pvData, size_t uLength)
+{
+   const unsigned char *pucData = (const unsigned char*)pvData;
+   size_t u;
+
+   assert(pvData != NULL);
+
+   for (u = 0; u < uLength; u++)
+   {
+      uHash ^= pucData[u];
+      uHash *= FNV_PRIME;
+   }
+   return uHash;
+}
+
+/*--------------------------------------------------------------------*/
+
+void Hash_remove(void *pvSlots, size_t uSlotSize, size_t uCapacity,
+                 size_t uIndex, const void *pvEmpty,
+                 int (*pfGetHash)(const void *pvSlot, size_t *puHash))
+{
+   char *pcSlots = (char*)pvSlots;
+   size_t uMask;
+   size_t uHash;
+   size_t uHome;
+   size_t u;
+   size_t v;
+
+   assert(pvSlots != NULL);
+   assert(uCapacity > 0);
+   assert((uCapacity & (uCapacity - 1)) == 0);
+   assert(uIndex < uCapacity);
+   assert(pvEmpty != NULL);
+   assert(pfGetHash != NULL);
+
+   uMask = uCapacity - 1;
+   u = uIndex;
+   memcpy(pcSlots + u * uSlotSize, pvEmpty, uSlotSize);
+
+   for (v = (u + 1) & uMask;
+        (*pfGetHash)(pcSlots + v * uSlotSize, &uHash);
+        v = (v + 1) & uMask)
+   {
+      uHome = uHash & uMask;
+      /* The entry at v may stay if its home slot lies cyclically
+         within (u, v]. */
+      if ((u <= v) ? (u < uHome && uHome <= v)
+                   : (u < uHome || uHome <= v))
+         continue;
+      memcpy(pcSlots + u * uSlotSize, pcSlots + v * uSlotSize,
+             uSlotSize);
+      memcpy(pcSlots + v * uSlotSize, pvEmpty, uSlotSize);
+      u = v;
+   }
+}
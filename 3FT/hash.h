@@ -0,0 +1,40 @@
+/*--------------------------------------------------------------------*/
+/* hash.h                                                             */
+/*--------------------------------------------------------------------*/
+
+#ifndef HASH_INCLUDED
+#define HASH_INCLUDED
+
+#include <stddef.h>
+
+/* The hash function and the deletion step shared by the open
+   addressing hash tables, each of which probes linearly through a
+   power-of-two number of slots. */
+
+/*--------------------------------------------------------------------*/
+
+/* Return the FNV-1a hash of the uLength bytes at pvData. */
+
+size_t Hash_bytes(const void *pvData, size_t uLength);
+
+/*--------------------------------------------------------------------*/
+
+/* Return the FNV-1a hash of the uLength bytes at pvData appended to
+   bytes whose hash is uHash. */
+
+size_t Hash_continue(size_t uHash, const void *pvData, size_t uLength);
+
+/*--------------------------------------------------------------------*/
+
+/* Empty slot uIndex of the uCapacity slots of uSlotSize bytes each at
+   pvSlots by copying the uSlotSize bytes at pvEmpty into it, then
+   shift back the later entries of its probe sequence so that no
+   tombstones are needed.  (*pfGetHash)(pvSlot, puHash) must return 0
+   if the slot at pvSlot is empty, and otherwise store the hash of its
+   entry in *puHash and return 1. */
+
+void Hash_remove(void *pvSlots, size_t uSlotSize, size_t uCapacity,
+                 size_t uIndex, const void *pvEmpty,
+                 int (*pfGetHash)(const void *pvSlot, size_t *puHash));
+
+#endif
@@ -0,0 +1,290 @@
+/*--------------------------------------------------------------------*/
+/* intern.c                                                           */
+/*--------------------------------------------------------------------*/
+
+#include "intern.h"
+#include "hash.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*--------------------------------------------------------------------*/
+
+/* The number of slots in the table of a new Intern object. */
+
+static const size_t MIN_CAPACITY = 64;
+
+/*--------------------------------------------------------------------*/
+
+/* The header of a pooled string, which is followed in the same
+   allocation by the string's characters and terminating nul. */
+
+struct InternName
+{
+   /* The number of references not yet released. */
+   size_t uRefs;
+
+   /* The hash of the string. */
+   size_t uHash;
+};
+
+/* An Intern object is an open-addressing hash table, using linear
+   probing, of its strings. */
+
+struct Intern
+{
+   /* The slots of the table, each the header of a string or NULL. */
+   struct InternName **ppsSlots;
+
+   /* The number of slots, a power of two. */
+   size_t uCapacity;
+
+   /* The number of strings in the table. */
+   size_t uLength;
+
+   /* The total size of the strings in the table, counting their
+      terminating nuls. */
+   size_t uBytes;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* If the table slot at pvSlot holds a string, store its hash in
+   *puHash and return 1; otherwise return 0. */
+
+static int Intern_getHash(const void *pvSlot, size_t *puHash)
+{
+   const struct InternName *psName;
+
+   assert(pvSlot != NULL);
+   assert(puHash != NULL);
+
+   psName = *(struct InternName *const*)pvSlot;
+   if (psName == NULL)
+      return 0;
+   *puHash = psName->uHash;
+   return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the characters of the string whose header is psName. */
+
+static char *Intern_chars(struct InternName *psName)
+{
+   assert(psName != NULL);
+
+   return (char*)(psName + 1);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the index of the slot of oIntern holding the first uLength
+   characters of pcName, which hash to uHash, or of the empty slot
+   ending their probe sequence if oIntern has no such string. */
+
+static size_t Intern_slot(Intern_T oIntern, const char *pcName,
+                          size_t uLength, size_t uHash)
+{
+   struct InternName *psName;
+   size_t uMask;
+   size_t u;
+
+   assert(oIntern != NULL);
+   assert(pcName != NULL);
+
+   uMask = oIntern->uCapacity - 1;
+   for (u = uHash & uMask; oIntern->ppsSlots[u] != NULL;
+        u = (u + 1) & uMask)
+   {
+      psName = oIntern->ppsSlots[u];
+      if (psName->uHash == uHash &&
+          strncmp(Intern_chars(psName), pcName, uLength) == 0 &&
+          Intern_chars(psName)[uLength] == '\0')
+         break;
+   }
+   return u;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Double the number of slots of oIntern.  Return 1 (TRUE) if
+   successful, or 0 (FALSE) if insufficient memory is available. */
+
+static int Intern_grow(Intern_T oIntern)
+{
+   struct InternName **ppsNewSlots;
+   size_t uNewCapacity;
+   size_t uMask;
+   size_t u;
+   size_t v;
+
+   assert(oIntern != NULL);
+
+   uNewCapacity = oIntern->uCapacity * 2;
+   ppsNewSlots = (struct InternName**)calloc(uNewCapacity,
+      sizeof(struct InternName*));
+   if (ppsNewSlots == NULL)
+      return 0;
+
+   uMask = uNewCapacity - 1;
+   for (u = 0; u < oIntern->uCapacity; u++)
+   {
+      if (oIntern->ppsSlots[u] == NULL)
+         continue;
+      for (v = oIntern->ppsSlots[u]->uHash & uMask;
+           ppsNewSlots[v] != NULL; v = (v + 1) & uMask)
+         ;
+      ppsNewSlots[v] = oIntern->ppsSlots[u];
+   }
+
+   free(oIntern->ppsSlots);
+   oIntern->ppsSlots = ppsNewSlots;
+   oIntern->uCapacity = uNewCapacity;
+   return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+Intern_T Intern_new(void)
+{
+   Intern_T oIntern;
+
+   oIntern = (struct Intern*)malloc(sizeof(struct Intern));
+   if (oIntern == NULL)
+      return NULL;
+
+   oIntern->ppsSlots = (struct InternName**)calloc(MIN_CAPACITY,
+      sizeof(struct InternName*));
+   if (oIntern->ppsSlots == NULL)
+   {
+      free(oIntern);
+      return NULL;
+   }
+   oIntern->uCapacity = MIN_CAPACITY;
+   oIntern->uLength = 0;
+   oIntern->uBytes = 0;
+
+   return oIntern;
+}
+
+/*--------------------------------------------------------------------*/
+
+void Intern_free(Intern_T oIntern)
+{
+   size_t u;
+
+   assert(oIntern != NULL);
+
+   for (u = 0; u < oIntern->uCapacity; u++)
+      free(oIntern->ppsSlots[u]);
+   free(oIntern->ppsSlots);
+   free(oIntern);
+}
+
+/*--------------------------------------------------------------------*/
+
+const char *Intern_add(Intern_T oIntern, const char *pcName,
+                       size_t uLength)
+{
+   struct InternName *psName;
+   size_t uHash;
+   size_t u;
+
+   assert(oIntern != NULL);
+   assert(pcName != NULL);
+
+   uHash = Hash_bytes(pcName, uLength);
+   u = Intern_slot(oIntern, pcName, uLength, uHash);
+   if (oIntern->ppsSlots[u] != NULL)
+   {
+      psName = oIntern->ppsSlots[u];
+      psName->uRefs++;
+      return Intern_chars(psName);
+   }
+
+   /* Keeping the table at most half full. */
+   if ((oIntern->uLength + 1) * 2 > oIntern->uCapacity)
+   {
+      if (! Intern_grow(oIntern))
+         return NULL;
+      u = Intern_slot(oIntern, pcName, uLength, uHash);
+   }
+
+   psName = (struct InternName*)malloc(sizeof(struct InternName) +
+      uLength + 1);
+   if (psName == NULL)
+      return NULL;
+   psName->uRefs = 1;
+   psName->uHash = uHash;
+   memcpy(Intern_chars(psName), pcName, uLength);
+   Intern_chars(psName)[uLength] = '\0';
+
+   oIntern->ppsSlots[u] = psName;
+   oIntern->uLength++;
+   oIntern->uBytes += uLength + 1;
+   return Intern_chars(psName);
+}
+
+/*--------------------------------------------------------------------*/
+
+const char *Intern_find(Intern_T oIntern, const char *pcName,
+                        size_t uLength)
+{
+   size_t u;
+
+   assert(oIntern != NULL);
+   assert(pcName != NULL);
+
+   u = Intern_slot(oIntern, pcName, uLength,
+                   Hash_bytes(pcName, uLength));
+   if (oIntern->ppsSlots[u] == NULL)
+      return NULL;
+   return Intern_chars(oIntern->ppsSlots[u]);
+}
+
+/*--------------------------------------------------------------------*/
+
+void Intern_release(Intern_T oIntern, const char *pcName)
+{
+   struct InternName *psName;
+   struct InternName *psEmpty = NULL;
+   size_t uMask;
+   size_t u;
+
+   assert(oIntern != NULL);
+   assert(pcName != NULL);
+
+   psName = (struct InternName*)pcName - 1;
+   assert(psName->uRefs > 0);
+   if (--psName->uRefs > 0)
+      return;
+
+   uMask = oIntern->uCapacity - 1;
+   for (u = psName->uHash & uMask; oIntern->ppsSlots[u] != psName;
+        u = (u + 1) & uMask)
+      assert(oIntern->ppsSlots[u] != NULL);
+   Hash_remove(oIntern->ppsSlots, sizeof(struct InternName*),
+               oIntern->uCapacity, u, &psEmpty, Intern_getHash);
+   oIntern->uLength--;
+   oIntern->uBytes -= strlen(pcName) + 1;
+   free(psName);
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t Intern_getLength(Intern_T oIntern)
+{
+   assert(oIntern != NULL);
+
+   return oIntern->uLength;
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t Intern_getBytes(Intern_T oIntern)
+{
+   assert(oIntern != NULL);
+
+   return oIntern->uBytes;
+}
@@ -0,0 +1,70 @@
+/*--------------------------------------------------------------------*/
+/* intern.h                                                           */
+/*--------------------------------------------------------------------*/
+
+#ifndef INTERN_INCLUDED
+#define INTERN_INCLUDED
+
+#include <stddef.h>
+
+/* An Intern_T object is a pool of strings in which each distinct
+   string is stored once, however many times it is added, so that
+   equal strings from one pool are equal pointers. Each string keeps a
+   count of its additions and is freed when as many releases drop the
+   count to zero. */
+
+typedef struct Intern *Intern_T;
+
+/*--------------------------------------------------------------------*/
+
+/* Return a new empty Intern_T object, or NULL if insufficient memory
+   is available. */
+
+Intern_T Intern_new(void);
+
+/*--------------------------------------------------------------------*/
+
+/* Free oIntern and every string in it, whether or not the strings
+   have been released. */
+
+void Intern_free(Intern_T oIntern);
+
+/*--------------------------------------------------------------------*/
+
+/* Add the first uLength characters of pcName, which need not be
+   nul-terminated after them, to oIntern, and return the pool's
+   nul-terminated copy of them, counting one more reference to it.
+   Return NULL if insufficient memory is available. */
+
+const char *Intern_add(Intern_T oIntern, const char *pcName,
+                       size_t uLength);
+
+/*--------------------------------------------------------------------*/
+
+/* Return oIntern's copy of the first uLength characters of pcName, or
+   NULL if oIntern has no such string. Counts no reference. */
+
+const char *Intern_find(Intern_T oIntern, const char *pcName,
+                        size_t uLength);
+
+/*--------------------------------------------------------------------*/
+
+/* Drop one reference to pcName, a string returned by Intern_add on
+   oIntern, freeing it if no references remain. */
+
+void Intern_release(Intern_T oIntern, const char *pcName);
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of distinct strings in oIntern. */
+
+size_t Intern_getLength(Intern_T oIntern);
+
+/*--------------------------------------------------------------------*/
+
+/* Return the total size of the distinct strings in oIntern, counting
+   their terminating nuls. */
+
+size_t Intern_getBytes(Intern_T oIntern);
+
+#endif
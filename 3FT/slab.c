@@ -0,0 +1,165 @@
+/*--------------------------------------------------------------------*/
+/* slab.c                                                             */
+/*--------------------------------------------------------------------*/
+
+#include "slab.h"
+#include <assert.h>
+#include <stdlib.h>
+
+/*--------------------------------------------------------------------*/
+
+/* The number of objects in the first chunk of a Slab object, and the
+   most in any chunk.  Each chunk holds twice as many objects as the
+   one before it, up to the maximum. */
+
+static const size_t MIN_CHUNK_OBJECTS = 16;
+static const size_t MAX_CHUNK_OBJECTS = 4096;
+
+/*--------------------------------------------------------------------*/
+
+/* A type whose alignment suits any object. */
+
+union SlabAlign
+{
+   long double ld;
+   double d;
+   long l;
+   void *pv;
+   void (*pf)(void);
+};
+
+/* A chunk header, which links the chunks of a Slab object and is
+   followed by the chunk's objects. */
+
+union SlabChunk
+{
+   /* The chunk allocated before this one, or NULL. */
+   union SlabChunk *puNext;
+
+   /* Padding, so that the objects that follow are aligned. */
+   union SlabAlign uAlign;
+};
+
+/* A released object, whose first bytes link the free list. */
+
+struct SlabFree
+{
+   struct SlabFree *psNext;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* A Slab consists of its chunks, the part of the newest chunk not yet
+   handed out, and a list of released objects. */
+
+struct Slab
+{
+   /* The size of each object, rounded up to preserve alignment. */
+   size_t uObjectSize;
+
+   /* The number of objects in the next chunk to be allocated. */
+   size_t uChunkObjects;
+
+   /* The newest chunk, which links to the older ones, or NULL. */
+   union SlabChunk *puChunks;
+
+   /* The first never-used object in the newest chunk, and the end of
+      that chunk. */
+   char *pcNext;
+   char *pcEnd;
+
+   /* The most recently released object, or NULL. */
+   struct SlabFree *psFree;
+};
+
+/*--------------------------------------------------------------------*/
+
+Slab_T Slab_new(size_t uObjectSize)
+{
+   Slab_T oSlab;
+   size_t uAlign = sizeof(union SlabAlign);
+
+   oSlab = (struct Slab*)malloc(sizeof(struct Slab));
+   if (oSlab == NULL)
+      return NULL;
+
+   if (uObjectSize < sizeof(struct SlabFree))
+      uObjectSize = sizeof(struct SlabFree);
+   oSlab->uObjectSize = (uObjectSize + uAlign - 1) / uAlign * uAlign;
+   oSlab->uChunkObjects = MIN_CHUNK_OBJECTS;
+   oSlab->puChunks = NULL;
+   oSlab->pcNext = NULL;
+   oSlab->pcEnd = NULL;
+   oSlab->psFree = NULL;
+
+   return oSlab;
+}
+
+/*--------------------------------------------------------------------*/
+
+void Slab_free(Slab_T oSlab)
+{
+   union SlabChunk *puChunk;
+   union SlabChunk *puNext;
+
+   assert(oSlab != NULL);
+
+   for (puChunk = oSlab->puChunks; puChunk != NULL; puChunk = puNext)
+   {
+      puNext = puChunk->puNext;
+      free(puChunk);
+   }
+   free(oSlab);
+}
+
+/*--------------------------------------------------------------------*/
+
+void *Slab_alloc(Slab_T oSlab)
+{
+   union SlabChunk *puChunk;
+   void *pvObject;
+
+   assert(oSlab != NULL);
+
+   /* Reusing a released object first. */
+   if (oSlab->psFree != NULL)
+   {
+      pvObject = oSlab->psFree;
+      oSlab->psFree = oSlab->psFree->psNext;
+      return pvObject;
+   }
+
+   if (oSlab->pcNext == oSlab->pcEnd)
+   {
+      puChunk = (union SlabChunk*)malloc(sizeof(union SlabChunk) +
+         oSlab->uChunkObjects * oSlab->uObjectSize);
+      if (puChunk == NULL)
+         return NULL;
+
+      puChunk->puNext = oSlab->puChunks;
+      oSlab->puChunks = puChunk;
+      oSlab->pcNext = (char*)(puChunk + 1);
+      oSlab->pcEnd = oSlab->pcNext +
+         oSlab->uChunkObjects * oSlab->uObjectSize;
+      if (oSlab->uChunkObjects < MAX_CHUNK_OBJECTS)
+         oSlab->uChunkObjects *= 2;
+   }
+
+   pvObject = oSlab->pcNext;
+   oSlab->pcNext += oSlab->uObjectSize;
+   return pvObject;
+}
+
+/*--------------------------------------------------------------------*/
+
+void Slab_release(Slab_T oSlab, void *pvObject)
+{
+   struct SlabFree *psFree;
+
+   assert(oSlab != NULL);
+   assert(pvObject != NULL);
+
+   psFree = (struct SlabFree*)pvObject;
+   psFree->psNext = oSlab->psFree;
+   oSlab->psFree = psFree;
+}
@@ -0,0 +1,45 @@
+/*--------------------------------------------------------------------*/
+/* slab.h                                                             */
+/*--------------------------------------------------------------------*/
+
+#ifndef SLAB_INCLUDED
+#define SLAB_INCLUDED
+
+#include <stddef.h>
+
+/* A Slab_T object allocates objects of one fixed size from large
+   chunks of memory, keeping the objects released to it on a free list
+   for reuse. All of its chunks are freed together with the slab. */
+
+typedef struct Slab *Slab_T;
+
+/*--------------------------------------------------------------------*/
+
+/* Return a new Slab_T object that allocates objects of uObjectSize
+   bytes, or NULL if insufficient memory is available.  No chunk is
+   allocated until the first object is. */
+
+Slab_T Slab_new(size_t uObjectSize);
+
+/*--------------------------------------------------------------------*/
+
+/* Free oSlab and every chunk it has allocated, and thus every object
+   allocated from it, whether or not the objects have been released. */
+
+void Slab_free(Slab_T oSlab);
+
+/*--------------------------------------------------------------------*/
+
+/* Return a new object allocated from oSlab, suitably aligned for any
+   type, or NULL if insufficient memory is available. */
+
+void *Slab_alloc(Slab_T oSlab);
+
+/*--------------------------------------------------------------------*/
+
+/* Release pvObject, which must have been allocated from oSlab, for
+   reuse by a later Slab_alloc. */
+
+void Slab_release(Slab_T oSlab, void *pvObject);
+
+#endif
@@ -0,0 +1,167 @@
+/*--------------------------------------------------------------------*/
+/* test_bigdir.c                                                      */
+/*--------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "ft.h"
+#include "btree.h"
+
+/* The number of children given to the large directory: enough to move
+   them into a B+-tree under FT_SORTED_CHILDREN. */
+enum { NUM_CHILDREN = 10000 };
+
+/* The number of children left once it has been mostly emptied: few
+   enough to move them back out of the B+-tree. */
+enum { NUM_LEFT = 500 };
+
+/* The number of children at which the B+-tree must still be in use
+   while the directory is being emptied. */
+enum { NUM_STILL_TREE = 2000 };
+
+/* The number of snapshots of the tree taken by runTest. */
+enum { NUM_SNAPSHOTS = 3 };
+
+/* Stores in path the path of the i-th child of dir: every eighth a
+   directory, the rest files. */
+static void childPath(char* path, const char* dir, size_t i) {
+  assert(path != NULL);
+  assert(dir != NULL);
+
+  sprintf(path, "%s/%c%05lu", dir, i % 8 == 0 ? 'd' : 'f',
+          (unsigned long) i);
+}
+
+/* Returns the index of the k-th child added or removed by a pass
+   stepping through all NUM_CHILDREN of them by step, which must share
+   no factor with NUM_CHILDREN, so that each pass visits them out of
+   order. */
+static size_t childAt(size_t k, size_t step) {
+  return (k * step) % NUM_CHILDREN;
+}
+
+/* Returns the total length of all B+-trees in use. */
+static size_t treeLength(void) {
+  size_t length;
+  size_t bytes;
+
+  BTree_getTotals(&length, &bytes);
+  return length;
+}
+
+/* Adds the children of dir from the k-th to the one before the end-th
+   in the order of a pass stepping by step. */
+static void addChildren(const char* dir, size_t k, size_t end,
+                        size_t step) {
+  char path[32];
+  size_t i;
+
+  for(; k < end; k++) {
+    i = childAt(k, step);
+    childPath(path, dir, i);
+    if(i % 8 == 0)
+      assert(FT_insertDir(path) == SUCCESS);
+    else
+      assert(FT_insertFile(path, NULL, 0) == SUCCESS);
+  }
+}
+
+/* Removes the children of dir from the k-th to the one before the
+   end-th in the order of a pass stepping by step. */
+static void removeChildren(const char* dir, size_t k, size_t end,
+                           size_t step) {
+  char path[32];
+  size_t i;
+
+  for(; k < end; k++) {
+    i = childAt(k, step);
+    childPath(path, dir, i);
+    if(i % 8 == 0)
+      assert(FT_rmDir(path) == SUCCESS);
+    else
+      assert(FT_rmFile(path) == SUCCESS);
+  }
+}
+
+/* Checks that dir holds exactly the children from the k-th to the one
+   before the end-th in the order of a pass stepping by step. */
+static void checkChildren(const char* dir, size_t k, size_t end,
+                          size_t step) {
+  char path[32];
+  size_t i;
+  size_t j;
+
+  for(j = 0; j < NUM_CHILDREN; j++) {
+    i = childAt(j, step);
+    childPath(path, dir, i);
+    if(i % 8 == 0)
+      assert(FT_containsDir(path) == (j >= k && j < end));
+    else
+      assert(FT_containsFile(path) == (j >= k && j < end));
+  }
+}
+
+/* Grows and shrinks a directory across the thresholds at which its
+   children move into and out of a B+-tree under FT_SORTED_CHILDREN,
+   in an FT initialized with options, storing the results of
+   FT_toString along the way in snapshots. If isTree, checks that the
+   children are in a B+-tree exactly when they should be. */
+static void runTest(unsigned int options, boolean isTree,
+                    char* snapshots[NUM_SNAPSHOTS]) {
+  assert(FT_initWithOptions(options) == SUCCESS);
+
+  /* Filling the directory out of order, so that each child is
+     inserted among the others. */
+  addChildren("big", 0, NUM_CHILDREN, 7919);
+  assert(treeLength() == (isTree ? NUM_CHILDREN : 0));
+  checkChildren("big", 0, NUM_CHILDREN, 7919);
+  assert(FT_containsFile("big/f10000") == FALSE);
+  assert((snapshots[0] = FT_toString()) != NULL);
+
+  /* Emptying it, in another order, until it leaves the B+-tree. */
+  removeChildren("big", 0, NUM_CHILDREN - NUM_STILL_TREE, 3);
+  assert(treeLength() == (isTree ? NUM_STILL_TREE : 0));
+  removeChildren("big", NUM_CHILDREN - NUM_STILL_TREE,
+                 NUM_CHILDREN - NUM_LEFT, 3);
+  assert(treeLength() == 0);
+  checkChildren("big", NUM_CHILDREN - NUM_LEFT, NUM_CHILDREN, 3);
+  assert((snapshots[1] = FT_toString()) != NULL);
+
+  /* Refilling it, and filling a directory in an arena alongside, then
+     leaving both for FT_destroy. */
+  addChildren("big", 0, NUM_CHILDREN - NUM_LEFT, 3);
+  assert(FT_insertArenaDir("big/arena") == SUCCESS);
+  addChildren("big/arena", 0, NUM_CHILDREN, 7919);
+  assert(treeLength() == (isTree ? 2 * NUM_CHILDREN + 1 : 0));
+  removeChildren("big/arena", 0, NUM_CHILDREN / 2, 3);
+  assert((snapshots[2] = FT_toString()) != NULL);
+
+  assert(FT_destroy() == SUCCESS);
+  assert(treeLength() == 0);
+}
+
+/* Runs the test with each combination of the options that change how
+   the pointer-linked tree is stored, checking that it describes the
+   same tree with each as without FT_SORTED_CHILDREN. Returns 0. */
+int main(void) {
+  char* expected[NUM_SNAPSHOTS];
+  char* actual[NUM_SNAPSHOTS];
+  unsigned int options;
+  size_t i;
+
+  runTest(0, FALSE, expected);
+  for(options = 0; options < 0x10; options++) {
+    runTest(options | FT_SORTED_CHILDREN, TRUE, actual);
+    for(i = 0; i < NUM_SNAPSHOTS; i++) {
+      assert(strcmp(actual[i], expected[i]) == 0);
+      free(actual[i]);
+    }
+    fprintf(stderr, "options %#x: OK\n", options | FT_SORTED_CHILDREN);
+  }
+  for(i = 0; i < NUM_SNAPSHOTS; i++)
+    free(expected[i]);
+  return 0;
+}
@@ -0,0 +1,327 @@
+/*--------------------------------------------------------------------*/
+/* test_dynarray.c                                                    */
+/*--------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "dynarraydef.h"
+
+/* The lengths tested: around the longest range sorted by insertion,
+   and around the longest array searched without branching. */
+static const size_t lengths[] = {
+  0, 1, 2, 3, 15, 16, 17, 33, 100, 1000,
+  65535, 65536, 65537, 150000
+};
+
+/* The orders in which elements are given to be sorted. */
+enum order { RANDOM, FEW_VALUES, ASCENDING, DESCENDING, ORGAN_PIPE,
+             NUM_ORDERS };
+
+/* The state of the pseudo-random number generator. */
+static unsigned long state = 1;
+
+/* Returns the next pseudo-random number below bound. */
+static size_t randomBelow(size_t bound) {
+  assert(bound > 0);
+
+  state = (state * 1103515245UL + 12345UL) & 0x7fffffffUL;
+  return (size_t) (state >> 8) % bound;
+}
+
+/* Compares the longs at p1 and p2. */
+static int compareLongs(const long* p1, const long* p2) {
+  return (*p1 > *p2) - (*p1 < *p2);
+}
+
+/* Compares key with the long at p. */
+static int compareKey(long key, const long* p) {
+  return (key > *p) - (key < *p);
+}
+
+/* Compares the longs at pv1 and pv2, for DynArray_sort and
+   DynArray_bsearch. */
+static int compareElements(const void* pv1, const void* pv2) {
+  return compareLongs(pv1, pv2);
+}
+
+/* Compares the long at pvKey with the long at pvElement, for
+   DynArray_bsearchKey. */
+static int compareKeys(const void* pvKey, const void* pvElement) {
+  return compareLongs(pvKey, pvElement);
+}
+
+/* Compares the longs to which the pointers at pv1 and pv2 point, for
+   qsort. */
+static int comparePointers(const void* pv1, const void* pv2) {
+  return compareLongs(*(const long* const*) pv1,
+                      *(const long* const*) pv2);
+}
+
+/* LongArray_T is a DynArray of pointers to longs, sorted and searched
+   by the longs. */
+DYNARRAY_DECLARE(LongArray, const long*, long)
+DYNARRAY_DEFINE(LongArray, const long*, compareLongs, long, compareKey)
+
+/* Stores in values the length values of a test of the given order. */
+static void fill(long* values, size_t length, enum order order) {
+  size_t i;
+
+  for(i = 0; i < length; i++) {
+    switch(order) {
+    case RANDOM:
+      values[i] = (long) randomBelow(2 * length + 1);
+      break;
+    case FEW_VALUES:
+      values[i] = (long) randomBelow(3);
+      break;
+    case ASCENDING:
+      values[i] = (long) i;
+      break;
+    case DESCENDING:
+      values[i] = (long) (length - i);
+      break;
+    default:
+      values[i] = (long) (i < length / 2 ? i : length - i);
+      break;
+    }
+  }
+}
+
+/* Compares the pointers at pv1 and pv2, which point into one array,
+   by address, for qsort. */
+static int compareAddresses(const void* pv1, const void* pv2) {
+  const long* p1 = *(const long* const*) pv1;
+  const long* p2 = *(const long* const*) pv2;
+
+  return (p1 > p2) - (p1 < p2);
+}
+
+/* Checks that the length pointers at sorted are those at expected,
+   which are sorted by the values to which they point, in an order that
+   differs at most among equal values. Sorts both by address. */
+static void checkSorted(const long** sorted, const long** expected,
+                        size_t length) {
+  size_t i;
+
+  for(i = 0; i < length; i++)
+    assert(*sorted[i] == *expected[i]);
+
+  qsort(sorted, length, sizeof(long*), compareAddresses);
+  qsort(expected, length, sizeof(long*), compareAddresses);
+  assert(length == 0 ||
+         memcmp(sorted, expected, length * sizeof(long*)) == 0);
+}
+
+/* Returns an array of pointers to the length values, sorted by
+   qsort. */
+static const long** sortedPointers(const long* values, size_t length) {
+  const long** pointers;
+  size_t i;
+
+  pointers = malloc(length * sizeof(long*) + 1);
+  assert(pointers != NULL);
+  for(i = 0; i < length; i++)
+    pointers[i] = &values[i];
+  qsort(pointers, length, sizeof(long*), comparePointers);
+  return pointers;
+}
+
+/* Checks DynArray_sort and LongArray_sort on the length values. */
+static void testSort(const long* values, size_t length) {
+  const long** expected;
+  const long** sorted;
+  DynArray_T oArray;
+  LongArray_T oLongs;
+  size_t i;
+
+  sorted = malloc(length * sizeof(long*) + 1);
+  assert(sorted != NULL);
+  oArray = DynArray_new(0);
+  oLongs = LongArray_new(0);
+  assert(oArray != NULL && oLongs != NULL);
+  for(i = 0; i < length; i++) {
+    assert(DynArray_add(oArray, &values[i]));
+    assert(LongArray_add(oLongs, &values[i]));
+  }
+
+  DynArray_sort(oArray, compareElements);
+  DynArray_toArray(oArray, (void**) sorted);
+  expected = sortedPointers(values, length);
+  checkSorted(sorted, expected, length);
+  free(expected);
+
+  LongArray_sort(oLongs);
+  for(i = 0; i < length; i++)
+    sorted[i] = LongArray_get(oLongs, i);
+  expected = sortedPointers(values, length);
+  checkSorted(sorted, expected, length);
+  free(expected);
+
+  DynArray_free(oArray);
+  LongArray_free(oLongs);
+  free(sorted);
+}
+
+/* Checks DynArray_addManySorted and LongArray_addManySorted, merging
+   the count values of batch into the length values, against a merge
+   that puts each of the batch after the values equal to it. */
+static void testMerge(const long* values, size_t length,
+                      const long* batch, size_t count) {
+  const long** base;
+  const long** added;
+  const long** expected;
+  DynArray_T oArray;
+  LongArray_T oLongs;
+  size_t i;
+  size_t j;
+
+  base = sortedPointers(values, length);
+  added = sortedPointers(batch, count);
+  expected = malloc((length + count) * sizeof(long*) + 1);
+  assert(expected != NULL);
+  for(i = 0, j = 0; i + j < length + count; ) {
+    if(j == count || (i < length && *base[i] <= *added[j]))
+      expected[i + j] = base[i], i++;
+    else
+      expected[i + j] = added[j], j++;
+  }
+
+  oArray = DynArray_new(0);
+  oLongs = LongArray_new(0);
+  assert(oArray != NULL && oLongs != NULL);
+  assert(DynArray_addMany(oArray, (const void**) base, length));
+  assert(LongArray_addMany(oLongs, base, length));
+  assert(DynArray_addManySorted(oArray, (const void**) added, count,
+                                compareElements));
+  assert(LongArray_addManySorted(oLongs, added, count));
+
+  assert(DynArray_getLength(oArray) == length + count);
+  assert(LongArray_getLength(oLongs) == length + count);
+  for(i = 0; i < length + count; i++) {
+    assert(DynArray_get(oArray, i) == expected[i]);
+    assert(LongArray_get(oLongs, i) == expected[i]);
+  }
+
+  DynArray_free(oArray);
+  LongArray_free(oLongs);
+  free(base);
+  free(added);
+  free(expected);
+}
+
+/* Checks DynArray_bsearch, DynArray_bsearchKey, LongArray_bsearch and
+   LongArray_bsearchKey on the length values, sought by every key in
+   their range and just beyond it, or, for long arrays, by a sample.
+   If freeze is TRUE, the arrays are first frozen, and each search must
+   find the first of several equal values; then adding to them must
+   thaw them. */
+static void testSearch(const long* values, size_t length, int freeze) {
+  const long** sorted;
+  const size_t* ranks;
+  DynArray_T oArray;
+  LongArray_T oLongs;
+  size_t lower = 0;
+  size_t index;
+  long last;
+  long key;
+  int found;
+
+  sorted = sortedPointers(values, length);
+  oArray = DynArray_new(0);
+  oLongs = LongArray_new(0);
+  assert(oArray != NULL && oLongs != NULL);
+  assert(DynArray_addMany(oArray, (const void**) sorted, length));
+  assert(LongArray_addMany(oLongs, sorted, length));
+  if(freeze) {
+    assert(DynArray_freeze(oArray));
+    assert(LongArray_freeze(oLongs));
+    assert(DynArray_getFrozen(oArray, &ranks) != NULL);
+    assert(DynArray_getFrozen((DynArray_T) oLongs, &ranks) != NULL);
+  }
+
+  last = length == 0 ? 0 : *sorted[length - 1] + 1;
+  for(key = -1; key <= last; key += (length > 1000 ? 7 : 1)) {
+    /* The index of the first value not less than key. */
+    while(lower < length && *sorted[lower] < key)
+      lower++;
+    found = (lower < length && *sorted[lower] == key);
+
+    index = length + 1;
+    assert(DynArray_bsearch(oArray, &key, &index, compareElements)
+           == found);
+    assert(found ? *sorted[index] == key : index == lower);
+    index = length + 1;
+    assert(DynArray_bsearchKey(oArray, &key, &index, compareKeys)
+           == found);
+    assert(found ? *sorted[index] == key : index == lower);
+    index = length + 1;
+    assert(LongArray_bsearch(oLongs, &key, &index) == found);
+    assert(found ? *sorted[index] == key : index == lower);
+    index = length + 1;
+    assert(LongArray_bsearchKey(oLongs, key, &index) == found);
+    assert(found ? *sorted[index] == key : index == lower);
+    if(freeze)
+      assert(index == lower);
+  }
+
+  if(freeze) {
+    /* Adding a value beyond the rest, which must then be found. */
+    assert(DynArray_add(oArray, &last));
+    assert(LongArray_add(oLongs, &last));
+    assert(DynArray_getFrozen(oArray, &ranks) == NULL);
+    assert(DynArray_getFrozen((DynArray_T) oLongs, &ranks) == NULL);
+    assert(DynArray_bsearchKey(oArray, &last, &index, compareKeys));
+    assert(index >= length);
+    assert(LongArray_bsearchKey(oLongs, last, &index));
+    assert(index >= length);
+  }
+
+  DynArray_free(oArray);
+  LongArray_free(oLongs);
+  free(sorted);
+}
+
+/* Checks the sorting, merging and searching, in place and frozen, of
+   DynArrays of each of lengths against simple models of them, for
+   each order of the elements. Returns 0. */
+int main(void) {
+  long* values;
+  long* batch;
+  size_t physLength;
+  size_t total;
+  size_t length;
+  size_t count;
+  size_t i;
+  int order;
+
+  for(i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+    length = lengths[i];
+    count = length / 3 + 1;
+    values = malloc(length * sizeof(long) + 1);
+    batch = malloc(count * sizeof(long));
+    assert(values != NULL && batch != NULL);
+    for(order = 0; order < NUM_ORDERS; order++) {
+      fill(values, length, (enum order) order);
+      fill(batch, count, (enum order) order);
+      testSort(values, length);
+      testMerge(values, length, batch, count);
+      testMerge(values, length, batch, 1);
+      testMerge(values, length, batch, 0);
+    }
+    fill(values, length, RANDOM);
+    testSearch(values, length, 0);
+    testSearch(values, length, 1);
+    fill(values, length, FEW_VALUES);
+    testSearch(values, length, 1);
+    free(values);
+    free(batch);
+    fprintf(stderr, "length %lu: OK\n", (unsigned long) length);
+  }
+
+  DynArray_getTotals(&total, &physLength);
+  assert(total == 0 && physLength == 0);
+  return 0;
+}
@@ -0,0 +1,235 @@
+/*--------------------------------------------------------------------*/
+/* test_restore.c                                                     */
+/*--------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "ft.h"
+#include "btree.h"
+
+/* The most entries given to any directory. */
+enum { MAX_ENTRIES = 6000 };
+
+/* A directory restored by the test: the number of children it has
+   beforehand and the number then given to it at once, chosen so that
+   its children end up held inline, in a sorted DynArray, behind a hash
+   map unless FT_SORTED_CHILDREN is in use, and in a B+-tree if it is,
+   some before the batch and some only after it. The batch, of at
+   least two entries, is given in sorted order unless reversed. */
+struct Case {
+  const char* dir;
+  size_t before;
+  size_t batch;
+  boolean reversed;
+};
+
+static const struct Case cases[] = {
+  { "r/inline", 1, 3, FALSE },
+  { "r/array", 20, 100, FALSE },
+  { "r/unsorted", 20, 100, TRUE },
+  { "r/map", 200, 1000, FALSE },
+  { "r/mapped", 300, 1000, FALSE },
+  { "r/tree", 100, 5000, FALSE },
+  { "r/treed", 5000, 1000, TRUE }
+};
+
+enum { NUM_CASES = sizeof(cases) / sizeof(cases[0]) };
+
+/* The names of the entries of a directory and their types: the first
+   of each pair already in it, the second given to it in the batch, and
+   every eighth pair directories. */
+static char names[2 * MAX_ENTRIES][8];
+static boolean types[2 * MAX_ENTRIES];
+
+/* The batch, in the order given. */
+static char* batchNames[MAX_ENTRIES];
+static boolean batchTypes[MAX_ENTRIES];
+static void* batchContents[MAX_ENTRIES];
+static size_t batchLengths[MAX_ENTRIES];
+
+/* Stores in names and types the names and types of the first 2 *
+   count entries of a directory. */
+static void makeNames(size_t count) {
+  size_t i;
+
+  for(i = 0; i < 2 * count; i++) {
+    types[i] = (i / 2) % 8 != 0;
+    sprintf(names[i], "%c%05lu", types[i] ? 'f' : 'd',
+            (unsigned long) i);
+  }
+}
+
+/* Inserts the entry of dir named name, of type isFile, with its name
+   as its contents, one at a time. */
+static void insertOne(const char* dir, char* name, boolean isFile) {
+  char path[64];
+
+  sprintf(path, "%s/%s", dir, name);
+  if(isFile)
+    assert(FT_insertFile(path, name, strlen(name) + 1) == SUCCESS);
+  else
+    assert(FT_insertDir(path) == SUCCESS);
+}
+
+/* Stores in the batch arrays the batch of c, whose names must have
+   been made. */
+static void makeBatch(const struct Case* c) {
+  size_t i;
+  size_t j;
+
+  for(i = 0; i < c->batch; i++) {
+    j = c->reversed ? c->batch - 1 - i : i;
+    batchNames[i] = names[2 * j + 1];
+    batchTypes[i] = types[2 * j + 1];
+    batchContents[i] = names[2 * j + 1];
+    batchLengths[i] = strlen(names[2 * j + 1]) + 1;
+  }
+}
+
+/* Checks that the directory of c holds exactly the entries before its
+   batch, together with the batch if restored is TRUE, with the
+   contents that insertOne gives them. */
+static void checkEntries(const struct Case* c, boolean restored) {
+  char path[64];
+  boolean isFile;
+  size_t length;
+  size_t i;
+  boolean present;
+  void* contents;
+
+  for(i = 0; i < 2 * (c->batch > c->before ? c->batch : c->before);
+      i++) {
+    sprintf(path, "%s/%s", c->dir, names[i]);
+    present = (i % 2 == 0) ? i / 2 < c->before
+                           : restored && i / 2 < c->batch;
+    assert(FT_containsFile(path) == (present && types[i]));
+    assert(FT_containsDir(path) == (present && !types[i]));
+    if(present && types[i]) {
+      assert(FT_stat(path, &isFile, &length) == SUCCESS);
+      assert(isFile && length == strlen(names[i]) + 1);
+      contents = FT_getFileContents(path);
+      assert(contents != NULL && strcmp(contents, names[i]) == 0);
+    }
+  }
+}
+
+/* Returns the total length of all B+-trees in use. */
+static size_t treeLength(void) {
+  size_t length;
+  size_t bytes;
+
+  BTree_getTotals(&length, &bytes);
+  return length;
+}
+
+/* Builds every directory of cases in an FT initialized with options,
+   restoring each batch with FT_insertManyAt if restore is TRUE and
+   inserting its entries one at a time otherwise, checking each
+   directory along the way. Returns the result of FT_toString. */
+static char* runTest(unsigned int options, boolean restore) {
+  FT_DirHandle handle;
+  char* before;
+  char* after;
+  char* bad;
+  size_t numTree = 0;
+  size_t k;
+  size_t i;
+
+  assert(FT_initWithOptions(options) == SUCCESS);
+  assert(FT_insertDir("r") == SUCCESS);
+  for(k = 0; k < NUM_CASES; k++) {
+    makeNames(cases[k].before > cases[k].batch ? cases[k].before
+                                               : cases[k].batch);
+    makeBatch(&cases[k]);
+    assert(FT_insertDir((char*) cases[k].dir) == SUCCESS);
+    for(i = 0; i < cases[k].before; i++)
+      insertOne(cases[k].dir, names[2 * i], types[2 * i]);
+
+    if(!restore) {
+      for(i = 0; i < cases[k].batch; i++)
+        insertOne(cases[k].dir, batchNames[i], batchTypes[i]);
+      continue;
+    }
+
+    assert(FT_openDir((char*) cases[k].dir, &handle) == SUCCESS);
+    assert((before = FT_toString()) != NULL);
+
+    /* A batch that cannot be restored whole leaves the tree as it
+       was: one repeating an entry already there, one giving a name
+       twice, and one with a name of two components. */
+    bad = batchNames[cases[k].batch / 2];
+    batchNames[cases[k].batch / 2] = names[0];
+    assert(FT_insertManyAt(handle, batchNames, batchTypes,
+                           batchContents, batchLengths,
+                           cases[k].batch) == ALREADY_IN_TREE);
+    batchNames[cases[k].batch / 2] = batchNames[0];
+    assert(FT_insertManyAt(handle, batchNames, batchTypes,
+                           batchContents, batchLengths,
+                           cases[k].batch) == ALREADY_IN_TREE);
+    batchNames[cases[k].batch / 2] = "x/y";
+    assert(FT_insertManyAt(handle, batchNames, batchTypes,
+                           batchContents, batchLengths,
+                           cases[k].batch) == PARENT_CHILD_ERROR);
+    batchNames[cases[k].batch / 2] = bad;
+    assert((after = FT_toString()) != NULL);
+    assert(strcmp(before, after) == 0);
+    free(before);
+    free(after);
+    checkEntries(&cases[k], FALSE);
+
+    assert(FT_insertManyAt(handle, batchNames, batchTypes,
+                           batchContents, batchLengths,
+                           cases[k].batch) == SUCCESS);
+    assert(FT_insertManyAt(handle, batchNames, batchTypes,
+                           batchContents, batchLengths, 0) == SUCCESS);
+    assert(FT_closeDir(handle) == SUCCESS);
+    checkEntries(&cases[k], TRUE);
+
+    /* Only directories of more than 4096 children are in B+-trees. */
+    if(cases[k].before + cases[k].batch > 4096)
+      numTree += cases[k].before + cases[k].batch;
+    if((options & FT_SORTED_CHILDREN) != 0)
+      assert(treeLength() == numTree);
+    else
+      assert(treeLength() == 0);
+  }
+
+  /* Restoring into a handle that is no longer valid. */
+  assert(FT_openDir("r/inline", &handle) == SUCCESS);
+  assert(FT_closeDir(handle) == SUCCESS);
+  assert(FT_insertManyAt(handle, batchNames, batchTypes, batchContents,
+                         batchLengths, 1) == NO_SUCH_PATH);
+
+  assert((after = FT_toString()) != NULL);
+  assert(FT_destroy() == SUCCESS);
+  assert(treeLength() == 0);
+  return after;
+}
+
+/* Restores directories at each tier of storage with FT_insertManyAt
+   in an FT initialized with each combination of options, checking that
+   it describes the same tree as inserting their entries one at a time
+   does. Returns 0. */
+int main(void) {
+  FT_DirHandle handle;
+  char* expected;
+  char* actual;
+  unsigned int options;
+
+  handle.slot = 0;
+  handle.generation = 0;
+  assert(FT_insertManyAt(handle, NULL, NULL, NULL, NULL, 0) ==
+         INITIALIZATION_ERROR);
+  for(options = 0; options < 0x80; options++) {
+    expected = runTest(options, FALSE);
+    actual = runTest(options, TRUE);
+    assert(strcmp(actual, expected) == 0);
+    free(expected);
+    free(actual);
+    fprintf(stderr, "options %#x: OK\n", options);
+  }
+  return 0;
+}
@@ -0,0 +1,417 @@
+/*--------------------------------------------------------------------*/
+/* test_stress.c                                                      */
+/*--------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "ft.h"
+
+/* The number of distinct contents that files are given, the i-th of
+   which is i bytes long. */
+enum { NUM_CONTENTS = 16 };
+
+/* The number of directory handles held open at once. */
+enum { NUM_HANDLES = 4 };
+
+/* The number of paths passed to FT_containsMany and FT_statMany. */
+enum { NUM_MANY = 8 };
+
+/* The number of recently inserted paths remembered. */
+enum { NUM_RECENT = 64 };
+
+/* The longest path generated, including its terminating '\0'. */
+enum { MAX_PATH = 128 };
+
+/* The contents that files are given, which belong to the client. */
+static char contents[NUM_CONTENTS][NUM_CONTENTS];
+
+/* The path components from which most paths are made: few enough that
+   the same paths recur, and some prefixes of others. */
+static const char* names[] = {
+  "a", "b", "c", "aa", "ab", "a.b", "b-", "zz", "A", "0"
+};
+
+/* The state of the pseudo-random number generator. */
+static unsigned long state;
+
+/* Paths recently inserted, from which others are often generated,
+   so that operations find them, and the number of them. */
+static char recent[NUM_RECENT][MAX_PATH];
+static size_t numRecent;
+
+/* The handles currently open, their paths, and whether each slot holds
+   one. */
+static FT_DirHandle handles[NUM_HANDLES];
+static char handlePaths[NUM_HANDLES][MAX_PATH];
+static boolean isOpen[NUM_HANDLES];
+
+/* Returns the next pseudo-random number below bound. */
+static unsigned int randomBelow(unsigned int bound) {
+  assert(bound > 0);
+
+  state = (state * 1103515245UL + 12345UL) & 0x7fffffffUL;
+  return (unsigned int) (state >> 8) % bound;
+}
+
+/* Stores in name a random path component: usually one of names, and
+   otherwise one of enough others to make some directories large. */
+static void randomName(char* name) {
+  assert(name != NULL);
+
+  if(randomBelow(4) != 0)
+    strcpy(name, names[randomBelow(sizeof(names) / sizeof(names[0]))]);
+  else
+    sprintf(name, "n%u", randomBelow(600));
+}
+
+/* Stores in path a random path: half of the time one recently
+   inserted, or a child of one, and otherwise one of one to five
+   components, under the root "r" but now and then under another
+   root. */
+static void randomPath(char* path) {
+  unsigned int depth;
+
+  assert(path != NULL);
+
+  if(numRecent > 0 && randomBelow(2) == 0) {
+    strcpy(path, recent[randomBelow((unsigned int) numRecent)]);
+    /* Growing no deeper than there is room for. */
+    if(randomBelow(3) == 0 && strlen(path) < MAX_PATH / 2) {
+      strcat(path, "/");
+      randomName(path + strlen(path));
+    }
+    return;
+  }
+
+  strcpy(path, randomBelow(20) == 0 ? "r2" : "r");
+  for(depth = randomBelow(5); depth > 0; depth--) {
+    strcat(path, "/");
+    randomName(path + strlen(path));
+  }
+}
+
+/* Remembers path, if status shows that it was inserted, among the
+   recent paths, replacing a random one once they are full. */
+static void remember(const char* path, int status) {
+  assert(path != NULL);
+
+  if(status != SUCCESS)
+    return;
+  if(numRecent < NUM_RECENT)
+    strcpy(recent[numRecent++], path);
+  else
+    strcpy(recent[randomBelow(NUM_RECENT)], path);
+}
+
+/* Prints the result of a lookup of contents, which is NULL or holds
+   length bytes: whether it is NULL and the bytes themselves. */
+static void printContents(const char* p, size_t length) {
+  if(p == NULL) {
+    printf(" null");
+    return;
+  }
+  printf(" \"");
+  fwrite(p, 1, length, stdout);
+  printf("\"");
+}
+
+/* Prints which of the client's contents p is, if it is one of them,
+   or that it is not. */
+static void printWhich(const void* p) {
+  int i;
+
+  if(p == NULL) {
+    printf(" null");
+    return;
+  }
+  for(i = 0; i < NUM_CONTENTS; i++) {
+    if(p == contents[i]) {
+      printf(" #%d", i);
+      return;
+    }
+  }
+  printf(" not-the-client's");
+}
+
+/* Prints the contents of the file at path, as FT_getFileContents
+   returns them. */
+static void getContents(char* path) {
+  boolean type;
+  size_t length = 0;
+
+  printf("get %s", path);
+  if(FT_stat(path, &type, &length) != SUCCESS || type == FALSE)
+    length = 0;
+  printContents(FT_getFileContents(path), length);
+  printf("\n");
+}
+
+/* Performs and prints the result of a random operation on the
+   handles. */
+static void handleOperation(void) {
+  char name[MAX_PATH];
+  char path[2 * MAX_PATH];
+  char buffers[NUM_MANY][MAX_PATH];
+  char* batchNames[NUM_MANY];
+  boolean batchTypes[NUM_MANY];
+  void* batchContents[NUM_MANY];
+  size_t batchLengths[NUM_MANY];
+  boolean type;
+  size_t length = 0;
+  size_t n;
+  size_t j;
+  unsigned int i;
+  unsigned int r;
+
+  i = randomBelow(NUM_HANDLES);
+  randomName(name);
+  switch(randomBelow(7)) {
+  case 0:
+    if(isOpen[i])
+      printf("close %u %d\n", i, FT_closeDir(handles[i]));
+    randomPath(handlePaths[i]);
+    r = (unsigned int) FT_openDir(handlePaths[i], &handles[i]);
+    isOpen[i] = (r == SUCCESS);
+    printf("open %u %s %u\n", i, handlePaths[i], r);
+    break;
+  case 1:
+    if(isOpen[i])
+      printf("close %u %d\n", i, FT_closeDir(handles[i]));
+    isOpen[i] = FALSE;
+    break;
+  case 2:
+    r = randomBelow(NUM_CONTENTS);
+    if(isOpen[i])
+      printf("insertAt %u %s %u %d\n", i, name, r,
+             FT_insertFileAt(handles[i], name, contents[r], r));
+    break;
+  case 3:
+    if(isOpen[i])
+      printf("containsAt %u %s %d\n", i, name,
+             FT_containsFileAt(handles[i], name));
+    break;
+  case 4:
+    if(isOpen[i]) {
+      sprintf(path, "%s/%s", handlePaths[i], name);
+      if(FT_stat(path, &type, &length) != SUCCESS || type == FALSE)
+        length = 0;
+      printf("getAt %u %s", i, name);
+      printContents(FT_getFileContentsAt(handles[i], name), length);
+      printf("\n");
+    }
+    break;
+  case 5:
+    if(isOpen[i]) {
+      /* Up to NUM_MANY entries, now and then repeating a name. */
+      n = randomBelow(NUM_MANY + 1);
+      for(j = 0; j < n; j++) {
+        randomName(buffers[j]);
+        r = randomBelow(NUM_CONTENTS);
+        batchNames[j] = buffers[j];
+        batchTypes[j] = (boolean) (randomBelow(4) != 0);
+        batchContents[j] = contents[r];
+        batchLengths[j] = r;
+      }
+      printf("insertManyAt %u %d", i,
+             FT_insertManyAt(handles[i], batchNames, batchTypes,
+                             batchContents, batchLengths, n));
+      for(j = 0; j < n; j++)
+        printf(" %s:%d", batchNames[j], batchTypes[j]);
+      printf("\n");
+    }
+    break;
+  default:
+    if(isOpen[i])
+      printf("rmAt %u %s %d\n", i, name,
+             FT_rmFileAt(handles[i], name));
+    break;
+  }
+}
+
+/* Compares the strings at the pointers at p1 and p2, for qsort. */
+static int comparePaths(const void* p1, const void* p2) {
+  return strcmp(*(char* const*) p1, *(char* const*) p2);
+}
+
+/* Performs and prints the results of a random FT_containsMany or
+   FT_statMany, of paths that are sorted half of the time. */
+static void manyOperation(void) {
+  char buffers[NUM_MANY][MAX_PATH];
+  char* paths[NUM_MANY];
+  boolean results[NUM_MANY];
+  int statuses[NUM_MANY];
+  boolean types[NUM_MANY];
+  size_t lengths[NUM_MANY];
+  boolean type;
+  size_t i;
+
+  for(i = 0; i < NUM_MANY; i++) {
+    randomPath(buffers[i]);
+    paths[i] = buffers[i];
+    types[i] = 7;
+    lengths[i] = 77;
+  }
+  if(randomBelow(2) == 0)
+    qsort(paths, NUM_MANY, sizeof(char*), comparePaths);
+
+  if(randomBelow(2) == 0) {
+    type = (boolean) randomBelow(2);
+    printf("containsMany %d %d", type,
+           FT_containsMany(paths, NUM_MANY, type, results));
+    for(i = 0; i < NUM_MANY; i++)
+      printf(" %s:%d", paths[i], results[i]);
+  }
+  else {
+    printf("statMany %d", FT_statMany(paths, NUM_MANY, statuses, types,
+                                      lengths));
+    for(i = 0; i < NUM_MANY; i++)
+      printf(" %s:%d:%d:%lu", paths[i], statuses[i], types[i],
+             (unsigned long) lengths[i]);
+  }
+  printf("\n");
+}
+
+/* Prints the statistics that every implementation keeps alike, and
+   checks that the rest are available. */
+static void statsOperation(unsigned int options) {
+  struct FT_memoryStats memory;
+  size_t logical;
+  size_t physical;
+  size_t a;
+  size_t b;
+  size_t c;
+
+  printf("stats %d", FT_getContentsStats(&logical, &physical));
+  printf(" %lu", (unsigned long) logical);
+  /* How shared copies are counted is up to the implementation. */
+  if((options & FT_DEDUP_CONTENTS) == 0)
+    printf(" %lu", (unsigned long) physical);
+  printf(" %d", FT_getCacheStats(&a, &b));
+  printf(" %d", FT_getFilterStats(&a, &b, &c));
+  printf(" %d\n", FT_getMemoryStats(&memory));
+}
+
+/* Performs and prints the result of a random operation on an FT
+   initialized with options. */
+static void randomOperation(unsigned int options) {
+  char path[MAX_PATH];
+  char* string;
+  boolean type;
+  size_t length;
+  unsigned int r;
+  int status;
+  int i;
+
+  randomPath(path);
+  r = randomBelow(NUM_CONTENTS);
+  switch(randomBelow(18)) {
+  case 0:
+  case 1:
+    status = FT_insertDir(path);
+    printf("insertDir %s %d\n", path, status);
+    remember(path, status);
+    break;
+  case 2:
+    status = FT_insertArenaDir(path);
+    printf("insertArenaDir %s %d\n", path, status);
+    remember(path, status);
+    break;
+  case 3:
+  case 4:
+    status = FT_insertFile(path, contents[r], r);
+    printf("insertFile %s %u %d\n", path, r, status);
+    remember(path, status);
+    break;
+  case 5:
+    status = FT_insertFileCopy(path, contents[r], r);
+    printf("insertFileCopy %s %u %d\n", path, r, status);
+    remember(path, status);
+    break;
+  case 6:
+    printf("containsDir %s %d\n", path, FT_containsDir(path));
+    break;
+  case 7:
+    printf("containsFile %s %d\n", path, FT_containsFile(path));
+    break;
+  case 8:
+    /* Removing whole subtrees only now and then, so that they grow. */
+    if(randomBelow(4) == 0)
+      printf("rmDir %s %d\n", path, FT_rmDir(path));
+    break;
+  case 9:
+    printf("rmFile %s %d\n", path, FT_rmFile(path));
+    break;
+  case 10:
+    getContents(path);
+    break;
+  case 11:
+    printf("replace %s %u", path, r);
+    printWhich(FT_replaceFileContents(path, contents[r], r));
+    printf("\n");
+    break;
+  case 12:
+    printf("replaceCopy %s %u %d\n", path, r,
+           FT_replaceFileContentsCopy(path, contents[r], r));
+    break;
+  case 13:
+    type = 7;
+    length = 77;
+    i = FT_stat(path, &type, &length);
+    printf("stat %s %d %d %lu\n", path, i, type, (unsigned long) length);
+    break;
+  case 14:
+    handleOperation();
+    break;
+  case 15:
+    manyOperation();
+    break;
+  case 16:
+    if(randomBelow(10) == 0) {
+      statsOperation(options);
+      string = FT_toString();
+      printf("toString %s\n", string == NULL ? "(null)" : string);
+      free(string);
+    }
+    break;
+  default:
+    if(randomBelow(50) == 0) {
+      printf("destroy %d\n", FT_destroy());
+      printf("init %d\n", FT_initWithOptions(options));
+      for(i = 0; i < NUM_HANDLES; i++)
+        isOpen[i] = FALSE;
+    }
+    break;
+  }
+}
+
+/* Performs argv[3] random operations, seeded by argv[2], on an FT
+   initialized with the options argv[1], printing the result of each
+   to stdout, so that the output of two implementations may be
+   compared. Returns 0, or 1 if the arguments are missing. */
+int main(int argc, char* argv[]) {
+  unsigned int options;
+  unsigned long count;
+  size_t i;
+  size_t j;
+
+  if(argc != 4) {
+    fprintf(stderr, "usage: %s options seed count\n", argv[0]);
+    return 1;
+  }
+  options = (unsigned int) strtoul(argv[1], NULL, 0);
+  state = strtoul(argv[2], NULL, 0);
+  count = strtoul(argv[3], NULL, 0);
+
+  for(i = 0; i < NUM_CONTENTS; i++)
+    for(j = 0; j < NUM_CONTENTS; j++)
+      contents[i][j] = (char) ('a' + (i + j) % 26);
+
+  printf("init %d\n", FT_initWithOptions(options));
+  for(; count > 0; count--)
+    randomOperation(options);
+  printf("destroy %d\n", FT_destroy());
+  return 0;
+}